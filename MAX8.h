@@ -5,10 +5,12 @@
 #include "UBloxGen8.h"
 #include "UBloxGPSSPI.h"
 #include "UBloxGPSI2C.h"
+#include "UBloxGPSSerial.h"
+#include "UBloxReceiver.h"
 
 namespace UBlox
 {
-class MAX8I2C : public UBloxGPSI2C, public UBloxGen8
+class MAX8I2C final : public UBloxReceiver<UBloxGPSI2C, UBloxGen8>
 {
 public:
     /**
@@ -20,10 +22,12 @@ public:
      *                     on \c i2c before using the GPS.
      * @param user_RSTpin  Output pin connected to NRST
      * @param i2cAddress   I2C address. The MAX8 defaults to 0x42
+     * @param i2cFrequency Frequency which \c i2c is set to, used to budget bus bandwidth
      */
-    MAX8I2C(I2C & i2c, PinName user_RSTpin, uint8_t i2cAddress = UBloxGPS_I2C_DEF_ADDRESS):
+    MAX8I2C(I2C & i2c, PinName user_RSTpin, uint8_t i2cAddress = UBloxGPS_I2C_DEF_ADDRESS,
+        int i2cFrequency = 100000):
     UBloxGPS(user_RSTpin),
-    UBloxGPSI2C(i2c, user_RSTpin, i2cAddress)
+    UBloxReceiver(user_RSTpin, i2c, user_RSTpin, i2cAddress, i2cFrequency)
     {}
 
     const char* getName() override { return "MAX-8 via I2C"; };
@@ -32,10 +36,45 @@ private:
     /** Set I2C-specific bits in UBX-CFG-PRT payload */
     void setCFG_PRTPayload(uint8_t* data) override final
     {
-        data[0] = 0; // Port Id
         data[4] = (i2cAddress_ << 1);
     }
 };
+
+class MAX8Serial final : public UBloxReceiver<UBloxGPSSerial, UBloxGen8>
+{
+public:
+    /**
+     * Construct a MAX8 connected to a UART, providing pins and parameters.
+     *
+     * This doesn't actually initialize the chip, you will need to call begin() for that.
+     *
+     * @param user_TXpin   UART TX pin, connected to the MAX8's RXD pin
+     * @param user_RXpin   UART RX pin, connected to the MAX8's TXD pin
+     * @param user_RSTpin  Output pin connected to NRST
+     * @param baudRate     Baud rate the MAX8 is set to.  The MAX8 defaults to 9600.
+     */
+    MAX8Serial(PinName user_TXpin, PinName user_RXpin, PinName user_RSTpin, int baudRate = 9600):
+    UBloxGPS(user_RSTpin),
+    UBloxReceiver(user_RSTpin, user_TXpin, user_RXpin, user_RSTpin, baudRate)
+    {}
+
+    const char* getName() override { return "MAX-8 via Serial"; };
+
+private:
+    /** Set UART-specific bits in UBX-CFG-PRT payload */
+    void setCFG_PRTPayload(uint8_t* data) override final
+    {
+        // 8 data bits, no parity, 1 stop bit
+        data[4] = 0xC0;
+        data[5] = 0x08;
+
+        const uint32_t baudRate = getBaudRate();
+        data[8] = baudRate & 0xFF;
+        data[9] = (baudRate >> 8) & 0xFF;
+        data[10] = (baudRate >> 16) & 0xFF;
+        data[11] = (baudRate >> 24) & 0xFF;
+    }
+};
 };
 
 #endif //UBLOX_GNSS_MAX8_H
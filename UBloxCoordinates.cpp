@@ -0,0 +1,193 @@
+#include "UBloxCoordinates.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace UBlox
+{
+
+namespace
+{
+constexpr double DEG_TO_RAD = M_PI / 180.0;
+constexpr double RAD_TO_DEG = 180.0 / M_PI;
+
+/// Positions converted per block by the batch geodetic to ENU conversion
+constexpr size_t BATCH_BLOCK_SIZE = 32;
+
+inline void geodeticToECEFImpl(double latitude, double longitude, double height, double& x,
+    double& y, double& z)
+{
+    const double sinLat = sin(latitude * DEG_TO_RAD);
+    const double cosLat = cos(latitude * DEG_TO_RAD);
+    const double sinLon = sin(longitude * DEG_TO_RAD);
+    const double cosLon = cos(longitude * DEG_TO_RAD);
+
+    // Prime vertical radius of curvature
+    const double n = WGS84::A / sqrt(1.0 - WGS84::E2 * sinLat * sinLat);
+
+    x = (n + height) * cosLat * cosLon;
+    y = (n + height) * cosLat * sinLon;
+    z = (n * (1.0 - WGS84::E2) + height) * sinLat;
+}
+
+inline void ecefToGeodeticImpl(double x, double y, double z, double& latitude, double& longitude,
+    double& height)
+{
+    // Heikkinen (1982), as given in Zhu, "Conversion of Earth-centered Earth-fixed coordinates to
+    // geodetic coordinates" (1994)
+    constexpr double a2 = WGS84::A * WGS84::A;
+    constexpr double b2 = WGS84::B * WGS84::B;
+    constexpr double e4 = WGS84::E2 * WGS84::E2;
+
+    const double p2 = x * x + y * y;
+    const double p = sqrt(p2);
+    const double z2 = z * z;
+
+    const double f = 54.0 * b2 * z2;
+    const double g = p2 + (1.0 - WGS84::E2) * z2 - WGS84::E2 * (a2 - b2);
+    const double c = e4 * f * p2 / (g * g * g);
+    const double s = cbrt(1.0 + c + sqrt(c * c + 2.0 * c));
+    const double k = s + 1.0 + 1.0 / s;
+    const double bigP = f / (3.0 * k * k * g * g);
+    const double q = sqrt(1.0 + 2.0 * e4 * bigP);
+    const double r0 = -(bigP * WGS84::E2 * p) / (1.0 + q)
+        + sqrt(0.5 * a2 * (1.0 + 1.0 / q) - bigP * (1.0 - WGS84::E2) * z2 / (q * (1.0 + q))
+            - 0.5 * bigP * p2);
+    const double pe = p - WGS84::E2 * r0;
+    const double u = sqrt(pe * pe + z2);
+    const double v = sqrt(pe * pe + (1.0 - WGS84::E2) * z2);
+    const double z0 = b2 * z / (WGS84::A * v);
+
+    height = u * (1.0 - b2 / (WGS84::A * v));
+    latitude = atan2(z + WGS84::EP2 * z0, p) * RAD_TO_DEG;
+    longitude = atan2(y, x) * RAD_TO_DEG;
+}
+}
+
+ECEFPosition geodeticToECEF(double latitude, double longitude, double height)
+{
+    ECEFPosition ecef;
+    geodeticToECEFImpl(latitude, longitude, height, ecef.x, ecef.y, ecef.z);
+    return ecef;
+}
+
+void ecefToGeodetic(const ECEFPosition& ecef, double& latitude, double& longitude, double& height)
+{
+    ecefToGeodeticImpl(ecef.x, ecef.y, ecef.z, latitude, longitude, height);
+}
+
+void geodeticToECEF(const double* __restrict latitude, const double* __restrict longitude,
+    const double* __restrict height, double* __restrict x, double* __restrict y,
+    double* __restrict z, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        geodeticToECEFImpl(latitude[i], longitude[i], height[i], x[i], y[i], z[i]);
+    }
+}
+
+void ecefToGeodetic(const double* __restrict x, const double* __restrict y,
+    const double* __restrict z, double* __restrict latitude, double* __restrict longitude,
+    double* __restrict height, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        ecefToGeodeticImpl(x[i], y[i], z[i], latitude[i], longitude[i], height[i]);
+    }
+}
+
+LocalFrame::LocalFrame(double latitude, double longitude, double height)
+    : origin_(geodeticToECEF(latitude, longitude, height))
+{
+    const double sinLat = sin(latitude * DEG_TO_RAD);
+    const double cosLat = cos(latitude * DEG_TO_RAD);
+    const double sinLon = sin(longitude * DEG_TO_RAD);
+    const double cosLon = cos(longitude * DEG_TO_RAD);
+
+    eastAxis_[0] = -sinLon;
+    eastAxis_[1] = cosLon;
+    eastAxis_[2] = 0.0;
+
+    northAxis_[0] = -sinLat * cosLon;
+    northAxis_[1] = -sinLat * sinLon;
+    northAxis_[2] = cosLat;
+
+    upAxis_[0] = cosLat * cosLon;
+    upAxis_[1] = cosLat * sinLon;
+    upAxis_[2] = sinLat;
+}
+
+ENUPosition LocalFrame::ecefToENU(const ECEFPosition& ecef) const
+{
+    const double dx = ecef.x - origin_.x;
+    const double dy = ecef.y - origin_.y;
+    const double dz = ecef.z - origin_.z;
+
+    return { eastAxis_[0] * dx + eastAxis_[1] * dy + eastAxis_[2] * dz,
+        northAxis_[0] * dx + northAxis_[1] * dy + northAxis_[2] * dz,
+        upAxis_[0] * dx + upAxis_[1] * dy + upAxis_[2] * dz };
+}
+
+ECEFPosition LocalFrame::enuToECEF(const ENUPosition& enu) const
+{
+    // The rotation is orthonormal, so its inverse is its transpose
+    return { origin_.x + eastAxis_[0] * enu.east + northAxis_[0] * enu.north + upAxis_[0] * enu.up,
+        origin_.y + eastAxis_[1] * enu.east + northAxis_[1] * enu.north + upAxis_[1] * enu.up,
+        origin_.z + eastAxis_[2] * enu.east + northAxis_[2] * enu.north + upAxis_[2] * enu.up };
+}
+
+void LocalFrame::ecefToENU(const double* __restrict x, const double* __restrict y,
+    const double* __restrict z, double* __restrict east, double* __restrict north,
+    double* __restrict up, size_t count) const
+{
+    // Copy the members to locals so the compiler knows the outputs can't alias them
+    const double ox = origin_.x, oy = origin_.y, oz = origin_.z;
+    const double e0 = eastAxis_[0], e1 = eastAxis_[1];
+    const double n0 = northAxis_[0], n1 = northAxis_[1], n2 = northAxis_[2];
+    const double u0 = upAxis_[0], u1 = upAxis_[1], u2 = upAxis_[2];
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const double dx = x[i] - ox;
+        const double dy = y[i] - oy;
+        const double dz = z[i] - oz;
+        east[i] = e0 * dx + e1 * dy;
+        north[i] = n0 * dx + n1 * dy + n2 * dz;
+        up[i] = u0 * dx + u1 * dy + u2 * dz;
+    }
+}
+
+void LocalFrame::enuToECEF(const double* __restrict east, const double* __restrict north,
+    const double* __restrict up, double* __restrict x, double* __restrict y,
+    double* __restrict z, size_t count) const
+{
+    const double ox = origin_.x, oy = origin_.y, oz = origin_.z;
+    const double e0 = eastAxis_[0], e1 = eastAxis_[1];
+    const double n0 = northAxis_[0], n1 = northAxis_[1], n2 = northAxis_[2];
+    const double u0 = upAxis_[0], u1 = upAxis_[1], u2 = upAxis_[2];
+
+    for (size_t i = 0; i < count; i++)
+    {
+        x[i] = ox + e0 * east[i] + n0 * north[i] + u0 * up[i];
+        y[i] = oy + e1 * east[i] + n1 * north[i] + u1 * up[i];
+        z[i] = oz + n2 * north[i] + u2 * up[i];
+    }
+}
+
+void LocalFrame::geodeticToENU(const double* latitude, const double* longitude,
+    const double* height, double* east, double* north, double* up, size_t count) const
+{
+    double x[BATCH_BLOCK_SIZE];
+    double y[BATCH_BLOCK_SIZE];
+    double z[BATCH_BLOCK_SIZE];
+
+    for (size_t start = 0; start < count; start += BATCH_BLOCK_SIZE)
+    {
+        const size_t blockLen = std::min(count - start, BATCH_BLOCK_SIZE);
+        UBlox::geodeticToECEF(
+            latitude + start, longitude + start, height + start, x, y, z, blockLen);
+        ecefToENU(x, y, z, east + start, north + start, up + start, blockLen);
+    }
+}
+
+}
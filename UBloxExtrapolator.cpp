@@ -0,0 +1,113 @@
+#include "UBloxExtrapolator.h"
+#include "UBloxCoordinates.h"
+
+#include <cmath>
+
+namespace UBlox
+{
+
+namespace
+{
+constexpr double US_PER_SECOND = 1e6;
+constexpr double RAD_TO_DEG = 180.0 / M_PI;
+}
+
+PositionExtrapolator::PositionExtrapolator(float maxAcceleration, std::chrono::microseconds maxExtrapolation)
+    : halfMaxAcceleration_(static_cast<float>(0.5 * maxAcceleration / (US_PER_SECOND * US_PER_SECOND)))
+    , maxExtrapolationUs_(maxExtrapolation.count())
+{
+}
+
+void PositionExtrapolator::onNavigationSolution(
+    const GeodeticPosition& position, const VelocityNED& velocity, const FixQuality& fix)
+{
+    fixCount_++;
+
+    State newState;
+    newState.valid = fix.fixQuality == GPSFix::FIX_3D || fix.fixQuality == GPSFix::FIX_GPS_DEAD_RECKONING;
+    newState.fixTimeUs = (position.rxTime.firstByte - latencyCompensation_).count();
+    newState.latitude = position.latitude;
+    newState.longitude = position.longitude;
+    newState.height = position.height / 1000.0;
+
+    // Meridian (M) and prime vertical (N) radii of curvature at the fix, which convert north and
+    // east velocities into rates of change of latitude and longitude.
+    const double latRad = position.latitude / RAD_TO_DEG;
+    const double sinLat = sin(latRad);
+    const double w2 = 1.0 - WGS84::E2 * sinLat * sinLat;
+    const double w = sqrt(w2);
+    const double primeVertical = WGS84::A / w;
+    const double meridian = WGS84::A * (1.0 - WGS84::E2) / (w2 * w);
+
+    // NAV-PVT velocities are in mm/s.  mm/s -> m/us
+    constexpr double velocityScale = 1.0 / (1000.0 * US_PER_SECOND);
+    newState.latitudeRate = velocity.northVel * velocityScale / (meridian + newState.height) * RAD_TO_DEG;
+
+    // Longitude rate is undefined at the poles, where extrapolation just holds the longitude
+    const double parallelRadius = (primeVertical + newState.height) * cos(latRad);
+    newState.longitudeRate
+        = parallelRadius > 1.0 ? velocity.eastVel * velocityScale / parallelRadius * RAD_TO_DEG : 0.0;
+    newState.heightRate = -velocity.downVel * velocityScale;
+
+    newState.horizontalAccuracy = fix.posAccuracyHor / 1000.0f;
+    newState.verticalAccuracy = fix.posAccuracyVer / 1000.0f;
+    newState.speedAccuracy = static_cast<float>(velocity.speedAccuracy * velocityScale);
+
+    // Publish via seqlock
+    sequence_.fetch_add(1, std::memory_order_acq_rel);
+    std::atomic_thread_fence(std::memory_order_release);
+    state_ = newState;
+    std::atomic_thread_fence(std::memory_order_release);
+    sequence_.fetch_add(1, std::memory_order_release);
+}
+
+bool PositionExtrapolator::readState(State& state) const
+{
+    // Bounded number of tries, so that a reader in an ISR which interrupted the writer gives up
+    // instead of spinning forever.
+    for (int attempt = 0; attempt < 4; attempt++)
+    {
+        uint32_t seqBefore = sequence_.load(std::memory_order_acquire);
+        if (seqBefore & 1)
+        {
+            continue;
+        }
+        state = state_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == seqBefore)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PositionExtrapolator::predictPosition(std::chrono::microseconds time, ExtrapolatedPosition& prediction) const
+{
+    State state;
+    if (!readState(state) || !state.valid)
+    {
+        return false;
+    }
+
+    const int64_t dtUs = time.count() - state.fixTimeUs;
+    if (dtUs > maxExtrapolationUs_ || dtUs < -maxExtrapolationUs_)
+    {
+        return false;
+    }
+
+    const double dt = static_cast<double>(dtUs);
+    prediction.latitude = state.latitude + state.latitudeRate * dt;
+    prediction.longitude = state.longitude + state.longitudeRate * dt;
+    prediction.height = state.height + state.heightRate * dt;
+
+    // Error grows with the velocity error, and with any acceleration since the fix
+    const float absDt = fabsf(static_cast<float>(dt));
+    const float growth = state.speedAccuracy * absDt + halfMaxAcceleration_ * absDt * absDt;
+    prediction.horizontalError = state.horizontalAccuracy + growth;
+    prediction.verticalError = state.verticalAccuracy + growth;
+    prediction.extrapolationTime = std::chrono::microseconds(dtUs);
+    return true;
+}
+
+}
@@ -0,0 +1,169 @@
+#ifndef UBLOX_EXTRAPOLATOR_H
+#define UBLOX_EXTRAPOLATOR_H
+
+#include "UBloxMessages.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace UBlox
+{
+
+/**
+ * @brief Position predicted by PositionExtrapolator
+ */
+struct ExtrapolatedPosition
+{
+    /**
+     * @brief longitude (degrees)
+     */
+    double longitude;
+
+    /**
+     * @brief latitude (degrees)
+     */
+    double latitude;
+
+    /**
+     * @brief Height above ellipsoid (m)
+     */
+    double height;
+
+    /**
+     * @brief Estimated horizontal position error (m), including the fix's own accuracy
+     */
+    float horizontalError;
+
+    /**
+     * @brief Estimated vertical position error (m), including the fix's own accuracy
+     */
+    float verticalError;
+
+    /**
+     * @brief Time between the fix and the requested time.  Negative if the requested time was
+     * before the fix.
+     */
+    std::chrono::microseconds extrapolationTime;
+};
+
+/**
+ * @brief Serves positions at any rate between GNSS fixes, by extrapolating the last NAV-PVT
+ * solution along its velocity.
+ *
+ * Each fix's NED velocity is converted once into rates of change of latitude, longitude and
+ * height (using the WGS84 radii of curvature at the fix), so each prediction is just a few
+ * multiply-adds.  Predictions are lock-free, and can be made from any thread while update() feeds
+ * in new fixes.
+ *
+ * Fixes are timestamped with the host time at which the NAV-PVT message started arriving, so
+ * predictions lag reality by the receiver's output latency (see DriverStatistics::epochLatency).
+ * Use setLatencyCompensation() to take this out.
+ *
+ * To use this class, attach it with UBloxGPS::attachExtrapolator(), make sure NAV-PVT is enabled
+ * (configure() does this), and call UBloxGPS::update() regularly.
+ */
+class PositionExtrapolator
+{
+public:
+    /**
+     * @brief Construct a PositionExtrapolator.
+     *
+     * @param maxAcceleration Largest acceleration (m/s^2) expected between fixes.  Used for the
+     *                        error estimate.
+     * @param maxExtrapolation Longest time from a fix that predictions are made for
+     */
+    explicit PositionExtrapolator(
+        float maxAcceleration = 5.0f, std::chrono::microseconds maxExtrapolation = std::chrono::seconds(1));
+
+    PositionExtrapolator(PositionExtrapolator const &) = delete;
+    PositionExtrapolator& operator=(PositionExtrapolator const &) = delete;
+
+    /**
+     * @brief Feed a navigation solution into the extrapolator.  This is called automatically by
+     * UBloxGPS for every NAV-PVT message when the extrapolator is attached.  The velocity must
+     * be in mm/s, as parsed from NAV-PVT.
+     */
+    void onNavigationSolution(
+        const GeodeticPosition& position, const VelocityNED& velocity, const FixQuality& fix);
+
+    /**
+     * @brief Predict the position at a host time (e.g. UBloxGPS::now()).
+     *
+     * @param time Host time to predict the position at
+     * @param[out] prediction Predicted position and its estimated error
+     *
+     * @return true if a prediction was made, false if there is no 3D fix or \c time is more than
+     * maxExtrapolation away from it.
+     */
+    bool predictPosition(std::chrono::microseconds time, ExtrapolatedPosition& prediction) const;
+
+    /**
+     * @brief Set the time between the receiver's navigation epoch and the start of the NAV-PVT
+     * message, which is subtracted from each fix's timestamp.
+     */
+    void setLatencyCompensation(std::chrono::microseconds latency)
+    {
+        latencyCompensation_ = latency;
+    }
+
+    /**
+     * @brief Number of fixes fed into the extrapolator
+     */
+    uint32_t getFixCount() const
+    {
+        return fixCount_;
+    }
+
+private:
+    /**
+     * @brief State from the last fix, protected by the seqlock in sequence_.
+     */
+    struct State
+    {
+        /// Host time (us) of the fix
+        int64_t fixTimeUs = 0;
+
+        /// Position of the fix (degrees, degrees, m)
+        double latitude = 0;
+        double longitude = 0;
+        double height = 0;
+
+        /// Rates of change of the position (degrees/us, degrees/us, m/us)
+        double latitudeRate = 0;
+        double longitudeRate = 0;
+        double heightRate = 0;
+
+        /// Accuracy of the fix (m, m, m/us)
+        float horizontalAccuracy = 0;
+        float verticalAccuracy = 0;
+        float speedAccuracy = 0;
+
+        /// Whether the state holds a 3D fix
+        bool valid = false;
+    };
+
+    /**
+     * @brief Read a consistent copy of the state.
+     * @return false if a consistent copy could not be obtained (e.g. if called from an ISR that
+     * interrupted an update)
+     */
+    bool readState(State& state) const;
+
+    /// Half the max acceleration, in m/us^2
+    const float halfMaxAcceleration_;
+
+    const int64_t maxExtrapolationUs_;
+
+    std::chrono::microseconds latencyCompensation_{0};
+
+    /// Seqlock sequence number.  Odd while state_ is being written.
+    std::atomic<uint32_t> sequence_{0};
+
+    State state_;
+
+    uint32_t fixCount_ = 0;
+};
+
+}
+
+#endif // UBLOX_EXTRAPOLATOR_H
@@ -7,12 +7,37 @@
 // https://www.u-blox.com/en/docs/UBX-13003221
 
 #include "UBloxGPS.h"
+#include "UBloxExtrapolator.h"
+#include "UBloxPPSClock.h"
+#include "UBloxRTCM.h"
 #include <algorithm>
 #include <cstdarg>
 
 namespace UBlox
 {
 
+namespace
+{
+/// How long to wait for the GPS to answer a version poll
+constexpr us_time VERSION_TIMEOUT = 500ms;
+
+/// How long to wait for the ACK of each configuration command
+constexpr us_time CONFIGURATION_ACK_TIMEOUT = 1s;
+
+/// Most messages read by each call to poll(), so that a GPS which is streaming lots of data can't
+/// hold up the caller
+constexpr size_t MAX_MESSAGES_PER_POLL = 32;
+
+/// Bandwidth (bytes/s) used by a periodic message output once every epochsPerMessage epochs
+uint32_t messageBandwidth(uint8_t messageClass, uint8_t messageID, uint16_t rateHz, uint32_t epochsPerMessage)
+{
+    const uint32_t messageLength = getTypicalPayloadLength(messageClass, messageID) + UBX_HEADER_FOOTER_LENGTH;
+
+    // Round up, so a message sent every few seconds still counts
+    return (messageLength * rateHz + epochsPerMessage - 1) / epochsPerMessage;
+}
+}
+
 UBloxGPS::UBloxGPS(PinName user_RST)
     : reset_(user_RST, 1)
 {
@@ -83,50 +108,255 @@ bool UBloxGPS::begin(bool shouldConfigure)
     return true;
 }
 
-int UBloxGPS::update(us_time timeout)
+void UBloxGPS::beginAsync(bool shouldConfigure)
 {
-    Timer timeoutTimer;
-    timeoutTimer.start();
+    // Reset if not currently in reset
+    if (!resetInProgress_)
+    {
+        softwareReset(SWResetType::HOT_START);
+    }
 
-    int packetsRead = 0;
+    beginShouldConfigure_ = shouldConfigure;
+    beginState_ = BeginState::BOOTING;
+}
 
-    while (timeoutTimer.elapsed_time() <= timeout || timeout == 0us)
+UBloxGPS::BeginState UBloxGPS::poll()
+{
+    switch (beginState_)
     {
-        switch (readMessage())
-        {
-            case ReadStatus::DONE:
-                packetsRead++;
+        case BeginState::BOOTING:
+            if (resetTimer_.elapsed_time() < BOOT_TIME)
+            {
+                break;
+            }
+            resetInProgress_ = false;
+            resetTimer_.stop();
+
+            // Throw away anything left over from before the reset
+            resetFramer();
 
-                if (timeout == 0us)
+            versionReceived_ = false;
+            commandSentTime_ = now();
+            sendPacket(Packets::POLL_MON_VER, false, false, 0us);
+            beginState_ = BeginState::CHECKING_VERSION;
+            break;
+
+        case BeginState::CHECKING_VERSION:
+            readAvailableMessages();
+            if (versionReceived_)
+            {
+                DEBUG("%s booted up!\r\n", getName());
+                if (!beginShouldConfigure_)
+                {
+                    beginState_ = BeginState::DONE;
+                    break;
+                }
+
+                beginState_ = BeginState::CONFIGURING;
+                if (startConfiguration() == StepStatus::FAILED)
                 {
-                    return packetsRead;
+                    DEBUG("%s: failed to configure comm settings!\r\n", getName());
+                    beginState_ = BeginState::FAILED;
                 }
+            }
+            else if (now() - commandSentTime_ > VERSION_TIMEOUT)
+            {
+                stats_.timeouts++;
+                DEBUG("%s not detected!\r\n", getName());
+                beginState_ = BeginState::FAILED;
+            }
+            break;
+
+        case BeginState::CONFIGURING:
+            readAvailableMessages();
+            switch (advanceConfiguration())
+            {
+                case StepStatus::IN_PROGRESS:
+                    break;
+                case StepStatus::DONE:
+                    beginState_ = BeginState::DONE;
+                    break;
+                case StepStatus::FAILED:
+                    DEBUG("%s: failed to configure comm settings!\r\n", getName());
+                    beginState_ = BeginState::FAILED;
+                    break;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return beginState_;
+}
+
+bool UBloxGPS::configure()
+{
+    // Run the same steps as beginAsync(), blocking until they are done.  Every step is sent even
+    // if an earlier one fails.
+    StepStatus status = startConfiguration(true);
+    while (status == StepStatus::IN_PROGRESS)
+    {
+        waitForData(1ms);
+        readAvailableMessages();
+        status = advanceConfiguration();
+    }
+    return status == StepStatus::DONE;
+}
+
+UBloxGPS::StepStatus UBloxGPS::startConfiguration(bool save)
+{
+    configStep_ = 0;
+    configFailed_ = false;
+    configAckOverdue_ = false;
+    saveConfiguration_ = save;
+    return sendCurrentConfigurationStep();
+}
+
+UBloxGPS::StepStatus UBloxGPS::advanceConfiguration()
+{
+    if (configAckOverdue_)
+    {
+        // The step has already failed.  Wait for its late answer, so that it can't be taken as
+        // the next step's, but not forever, since it may have been lost.
+        if (ackState_ == AckState::NONE && now() - commandSentTime_ <= CONFIGURATION_ACK_TIMEOUT)
+        {
+            return StepStatus::IN_PROGRESS;
+        }
+        if (ackState_ != AckState::NONE)
+        {
+            DEBUG("Discarded late answer for message 0x%02" PRIx8 " 0x%02" PRIx8 "\r\n",
+                configCommandClass_, configCommandID_);
+        }
+        configAckOverdue_ = false;
+        configAckExpected_ = false;
+    }
+    else
+    {
+        switch (ackState_)
+        {
+            case AckState::NACK:
+                printf("NACK rcvd for message: %" PRIx8 " , %" PRIx8 "\r\n", configCommandClass_,
+                    configCommandID_);
+                stats_.nacks++;
+                configFailed_ = true;
                 break;
 
-            case ReadStatus::ERR:
-                return packetsRead;
+            case AckState::ACK:
+                stats_.commandRoundTrip.record((now() - commandSentTime_).count());
+                break;
 
-            case ReadStatus::NO_DATA:
-                // if we still haven't read a packet,
-                // try again (if timeout allows). Otherwise, we have emptied the message
-                // queue, so return the number of packets we have read.
-                if (packetsRead == 0 && timeout != 0us)
+            case AckState::NONE:
+            default:
+                if (now() - commandSentTime_ <= CONFIGURATION_ACK_TIMEOUT)
                 {
-                    continue;
+                    return StepStatus::IN_PROGRESS;
                 }
-                else
+                printf("Timeout waiting for ACK for message 0x%02" PRIx8 " 0x%02" PRIx8 "\r\n",
+                    configCommandClass_, configCommandID_);
+                stats_.timeouts++;
+                configFailed_ = true;
+
+                // Nothing is sent after the last step, so its late answer can't be misread
+                if (configStep_ + 1 < getNumConfigurationSteps())
                 {
-                    return packetsRead;
+                    configAckOverdue_ = true;
+                    commandSentTime_ = now();
+                    return StepStatus::IN_PROGRESS;
                 }
                 break;
         }
+        configAckExpected_ = false;
+    }
+
+    // Carry on with the rest of the steps even if this one failed
+    configStep_++;
+    return sendCurrentConfigurationStep();
+}
+
+UBloxGPS::StepStatus UBloxGPS::sendCurrentConfigurationStep()
+{
+    // A step which can't be sent is skipped, like one which is NACKed
+    for (; configStep_ < getNumConfigurationSteps(); configStep_++)
+    {
+        commandSentTime_ = now();
+        ackState_ = AckState::NONE;
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+        const uint32_t sequence = nextCommandSequence_++;
+#endif
+        if (sendConfigurationStep(configStep_))
+        {
+            // Remember what was sent, in case other commands are sent before the ACK arrives
+            configCommandClass_ = lastCommandClass_;
+            configCommandID_ = lastCommandID_;
+            configAckExpected_ = true;
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+            configCommandSequence_ = sequence;
+#endif
+            return StepStatus::IN_PROGRESS;
+        }
+        configFailed_ = true;
+    }
+    return configFailed_ ? StepStatus::FAILED : StepStatus::DONE;
+}
+
+void UBloxGPS::readAvailableMessages()
+{
+    for (size_t i = 0; i < MAX_MESSAGES_PER_POLL; i++)
+    {
+        if (readMessage() != ReadStatus::DONE)
+        {
+            break;
+        }
     }
+}
+
+int UBloxGPS::update(us_time timeout)
+{
+    return updateLoop(timeout, [this]() { return readMessage(); });
+}
+
+int UBloxGPS::updateWithBudget(size_t maxBytes, us_time maxDuration)
+{
+    // A timeout of 0 would make updateLoop() stop after one message
+    maxDuration = std::max(maxDuration, 1us);
+
+    const us_time startTime = now();
+    transferBudgetActive_ = true;
+    transferBudget_ = maxBytes;
+    transferDeadline_ = maxDuration < us_time::max() - startTime ? startTime + maxDuration : us_time::max();
+
+    const int packetsRead = updateLoop(maxDuration, [this]() { return readMessage(); });
+
+    transferBudgetActive_ = false;
     return packetsRead;
 }
 
+size_t UBloxGPS::transferBudgetRemaining() const
+{
+    if (!transferBudgetActive_)
+    {
+        return SIZE_MAX;
+    }
+
+    const us_time currentTime = now();
+    if (currentTime >= transferDeadline_)
+    {
+        return 0;
+    }
+
+    // Bytes which can be transferred before the deadline
+    const uint64_t bandwidth = getBusBandwidth();
+    const uint64_t timeLeftUs = (transferDeadline_ - currentTime).count();
+    const uint64_t bytesInTime = bandwidth == 0 || timeLeftUs >= UINT64_MAX / bandwidth
+        ? UINT64_MAX
+        : timeLeftUs * bandwidth / 1000000;
+    return static_cast<size_t>(std::min<uint64_t>(transferBudget_, bytesInTime));
+}
+
 void UBloxGPS::printGNSSConfig()
 {
-    if (!sendCommand(UBX_CLASS_CFG, UBX_CFG_GNSS, nullptr, 0, false, true, 500ms))
+    if (!sendPacket(Packets::POLL_CFG_GNSS, false, true, 500ms))
     {
         printf("Could not send UBX_CFG_GNSS message");
         return;
@@ -152,7 +382,7 @@ void UBloxGPS::printGNSSConfig()
 
 ssize_t UBloxGPS::getSatelliteInfo(SatelliteInfo* satelliteInfos, size_t infoLen)
 {
-    if (!sendCommand(UBX_CLASS_NAV, UBX_NAV_SAT, nullptr, 0, false, true, 1s))
+    if (!sendPacket(Packets::POLL_NAV_SAT, false, true, 1s))
     {
         printf("Could not send UBX_NAV_SAT message");
         return -1;
@@ -168,6 +398,7 @@ ssize_t UBloxGPS::getSatelliteInfo(SatelliteInfo* satelliteInfos, size_t infoLen
         if (flagOffset >= MAX_MESSAGE_LEN)
         {
             printf("Error: NAV-SAT message truncated by receive buffer size!\r\n");
+            stats_.truncations++;
 
             // keep the part that was valid
             return i;
@@ -198,7 +429,7 @@ ssize_t UBloxGPS::getSatelliteInfo(SatelliteInfo* satelliteInfos, size_t infoLen
 
 AntennaPowerStatus UBloxGPS::getAntennaPowerStatus()
 {
-    if (!sendCommand(UBX_CLASS_MON, UBX_MON_HW, nullptr, 0, false, true, 500ms))
+    if (!sendPacket(Packets::POLL_MON_HW, false, true, 500ms))
     {
         antennaPowerStatus = AntennaPowerStatus::NO_MESSAGE_RCVD;
     }
@@ -214,7 +445,7 @@ AntennaPowerStatus UBloxGPS::getAntennaPowerStatus()
 
 bool UBloxGPS::checkVersion(bool printVersion, bool printExtraInfo)
 {
-    if (!sendCommand(UBX_CLASS_MON, UBX_MON_VER, nullptr, 0, false, true, 500ms))
+    if (!sendPacket(Packets::POLL_MON_VER, false, true, 500ms))
     {
         return false;
     }
@@ -260,41 +491,240 @@ void UBloxGPS::hardwareReset()
 
 void UBloxGPS::requestTimepulseUpdate()
 {
-    sendCommand(UBX_CLASS_TIM, UBX_TIM_TP, nullptr, 0, false, false, 0us);
+    sendPacket(Packets::POLL_TIM_TP, false, false, 0us);
+}
+
+void UBloxGPS::requestLeapSecondUpdate()
+{
+    sendPacket(Packets::POLL_NAV_TIMELS, false, false, 0us);
+}
+
+bool UBloxGPS::enableEpochOutput(bool enabled)
+{
+    const uint8_t rate = enabled ? 1 : 0;
+
+    bool ret = true;
+#if UBLOX_GNSS_ENABLE_COVARIANCE
+    ret &= setMessageRate(UBX_CLASS_NAV, UBX_NAV_COV, rate);
+    ret &= setMessageRate(UBX_CLASS_NAV, UBX_NAV_DOP, rate);
+#endif
+    ret &= setMessageRate(UBX_CLASS_NAV, UBX_NAV_EOE, rate);
+    return ret;
+}
+
+#if UBLOX_GNSS_ENABLE_HEALTH_MONITOR
+bool UBloxGPS::enableHealthMonitoring(bool enabled, uint8_t rate)
+{
+    if (!enabled)
+    {
+        rate = 0;
+    }
+
+    bool ret = true;
+    ret &= setMessageRate(UBX_CLASS_MON, UBX_MON_HW, rate);
+    ret &= setMessageRate(UBX_CLASS_NAV, UBX_NAV_STATUS, rate);
+
+    // MON-RF and SEC-SIG were added in protocol version 27
+    if (getGPSGeneration() >= 9)
+    {
+        ret &= setMessageRate(UBX_CLASS_MON, UBX_MON_RF, rate);
+        ret &= setMessageRate(UBX_CLASS_SEC, UBX_SEC_SIG, rate);
+    }
+    return ret;
+}
+#endif
+
+bool UBloxGPS::setNavigationRate(uint16_t rateHz, RatePolicy policy)
+{
+    // Shortest measurement period the receivers accept is 25ms
+    static constexpr uint16_t MAX_RATE_HZ = 40;
+
+    if (rateHz == 0 || rateHz > MAX_RATE_HZ)
+    {
+        printf("%s: navigation rate of %" PRIu16 " Hz is not supported\r\n", getName(), rateHz);
+        return false;
+    }
+
+    const uint32_t budget
+        = static_cast<uint64_t>(getBusBandwidth()) * UBLOX_GNSS_BUS_BUDGET_PERCENT / 100;
+
+    // Find the smallest factor to slow down the other messages by so that everything fits
+    uint8_t scale = 1;
+    while (requiredBandwidth(rateHz, scale) > budget)
+    {
+        if (policy == RatePolicy::REFUSE || scale == UINT8_MAX)
+        {
+            printf("%s: %" PRIu16 " Hz needs %" PRIu32 " bytes/s, but the bus budget is %" PRIu32
+                   " bytes/s\r\n",
+                getName(), rateHz, requiredBandwidth(rateHz, scale), budget);
+            return false;
+        }
+        scale++;
+    }
+
+    // Slow the other messages down before speeding up, and only speed them back up (towards
+    // their base rates) after, so the bus is never overloaded
+    if (!applyRateScale(scale, true))
+    {
+        return false;
+    }
+
+    if (!sendMeasurementPeriod(1000 / rateHz))
+    {
+        printf("%s: navigation rate of %" PRIu16 " Hz was not accepted\r\n", getName(), rateHz);
+        return false;
+    }
+    navigationRateHz_ = rateHz;
+
+    if (!applyRateScale(scale, false))
+    {
+        return false;
+    }
+
+    if (scale > 1)
+    {
+        DEBUG("%s: slowed other messages by %" PRIu8 "x for %" PRIu16 " Hz\r\n", getName(), scale,
+            rateHz);
+    }
+    return true;
+}
+
+bool UBloxGPS::applyRateScale(uint8_t scale, bool slower)
+{
+    // The rates are recorded as they are sent, so iterate over a copy
+    MessageRate entries[UBLOX_GNSS_MAX_PERIODIC_MESSAGES];
+    const size_t numEntries = numMessageRates_;
+    std::copy(messageRates_, messageRates_ + numEntries, entries);
+
+    bool ret = true;
+    scalingMessageRates_ = true;
+    for (size_t i = 0; i < numEntries; i++)
+    {
+        const MessageRate& entry = entries[i];
+        if (entry.messageClass == UBX_CLASS_NAV && entry.messageID == UBX_NAV_PVT)
+        {
+            continue;
+        }
+
+        const uint8_t scaledRate = std::min<uint16_t>(entry.baseRate * scale, UINT8_MAX);
+        if (slower ? scaledRate > entry.rate : scaledRate < entry.rate)
+        {
+            if (!setMessageRate(entry.messageClass, entry.messageID, scaledRate))
+            {
+                ret = false;
+                break;
+            }
+        }
+    }
+    scalingMessageRates_ = false;
+    return ret;
+}
+
+void UBloxGPS::recordMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate)
+{
+    for (size_t i = 0; i < numMessageRates_; i++)
+    {
+        MessageRate& entry = messageRates_[i];
+        if (entry.messageClass == messageClass && entry.messageID == messageID)
+        {
+            if (rate == 0)
+            {
+                // Disabled, so move the last entry into its place
+                entry = messageRates_[--numMessageRates_];
+            }
+            else
+            {
+                // A rate scaled by setNavigationRate() keeps the base rate it was derived from
+                entry.rate = rate;
+                if (!scalingMessageRates_)
+                {
+                    entry.baseRate = rate;
+                }
+            }
+            return;
+        }
+    }
+
+    if (rate == 0)
+    {
+        return;
+    }
+
+    if (numMessageRates_ == UBLOX_GNSS_MAX_PERIODIC_MESSAGES)
+    {
+        printf("%s: too many periodic messages to budget bandwidth for, increase "
+               "UBLOX_GNSS_MAX_PERIODIC_MESSAGES\r\n",
+            getName());
+        return;
+    }
+    messageRates_[numMessageRates_++] = { messageClass, messageID, rate, rate };
+}
+
+uint32_t UBloxGPS::requiredBandwidth(uint16_t rateHz, uint8_t scale) const
+{
+    uint32_t bytesPerSecond = 0;
+    for (size_t i = 0; i < numMessageRates_; i++)
+    {
+        const MessageRate& entry = messageRates_[i];
+        const bool isPVT = entry.messageClass == UBX_CLASS_NAV && entry.messageID == UBX_NAV_PVT;
+        const uint32_t epochsPerMessage
+            = isPVT ? entry.baseRate : std::min<uint32_t>(entry.baseRate * scale, UINT8_MAX);
+        bytesPerSecond += messageBandwidth(entry.messageClass, entry.messageID, rateHz, epochsPerMessage);
+    }
+    return bytesPerSecond;
+}
+
+uint32_t UBloxGPS::getRequiredBandwidth() const
+{
+    uint32_t bytesPerSecond = 0;
+    for (size_t i = 0; i < numMessageRates_; i++)
+    {
+        const MessageRate& entry = messageRates_[i];
+        bytesPerSecond += messageBandwidth(entry.messageClass, entry.messageID, navigationRateHz_, entry.rate);
+    }
+    return bytesPerSecond;
 }
 
 bool UBloxGPS::sendCommand(uint8_t messageClass, uint8_t messageID, const uint8_t* data,
     uint16_t dataLen, bool shouldWaitForACK, bool shouldWaitForResponse, us_time timeout)
 {
-    // Prohibit sending commands with a payload larger than 500 bytes.
-    if (dataLen > MAX_MESSAGE_LEN)
+    if (inCallback_)
+    {
+        // Would overwrite the TX buffer, which may be in the middle of being sent
+        printf("%s: can't send 0x%02" PRIx8 " 0x%02" PRIx8 " from a callback\r\n", getName(),
+            messageClass, messageID);
+        return false;
+    }
+
+    // Assemble the packet, with header and footer, in the TX buffer
+    size_t packetLen = buildUBXPacket(txBuffer_, sizeof(txBuffer_), messageClass, messageID, data, dataLen);
+    if (packetLen == 0)
     {
         printf("ERROR: sendCommand received a command longer than %d bytes (%d)\r\n",
-            MAX_MESSAGE_LEN,
+            UBLOX_GNSS_TX_BUFFER_SIZE - UBX_HEADER_FOOTER_LENGTH,
             dataLen);
         return false;
     }
-    // make array to add header and footer
-    uint16_t packetLen = dataLen + 8;
-    uint8_t packet[packetLen]; // TODO AV-360 This should not be a variable length array
 
-    // send the sync chars
-    packet[0] = UBX_SYNC_CHAR_1;
-    packet[1] = UBX_SYNC_CHAR_2;
+    return sendPacket(txBuffer_, packetLen, shouldWaitForACK, shouldWaitForResponse, timeout);
+}
 
-    // send the header
-    packet[2] = messageClass;
-    packet[3] = messageID;
-    packet[4] = dataLen & 0xFF;
-    packet[5] = dataLen >> 8;
+bool UBloxGPS::sendPacket(const uint8_t* packet, uint16_t packetLen, bool shouldWaitForACK,
+    bool shouldWaitForResponse, us_time timeout)
+{
+    const uint8_t messageClass = packet[UBX_BYTE_CLASS];
+    const uint8_t messageID = packet[UBX_BYTE_ID];
 
-    for (uint16_t i = 0; i < dataLen; i++)
+    if (inCallback_)
     {
-        packet[i + 6] = data[i];
+        // Would start a transfer inside the one which delivered the callback
+        printf("%s: can't send 0x%02" PRIx8 " 0x%02" PRIx8 " from a callback\r\n", getName(),
+            messageClass, messageID);
+        return false;
     }
 
-    // compute checksum on header and data. Refer to datasheet
-    calcChecksum(packet, packetLen, packet[dataLen + 6], packet[dataLen + 7]);
+    lastCommandClass_ = messageClass;
+    lastCommandID_ = messageID;
 
     DEBUG("Sending: ");
     for (uint16_t i = 0; i < packetLen; i++)
@@ -303,6 +733,7 @@ bool UBloxGPS::sendCommand(uint8_t messageClass, uint8_t messageID, const uint8_
     }
     DEBUG("\r\n");
 
+    us_time sendTime = now();
     bool status = sendMessage(packet, packetLen);
 
     if (shouldWaitForACK)
@@ -317,6 +748,11 @@ bool UBloxGPS::sendCommand(uint8_t messageClass, uint8_t messageID, const uint8_
         status &= ret;
     }
 
+    if (status && (shouldWaitForACK || shouldWaitForResponse))
+    {
+        stats_.commandRoundTrip.record((now() - sendTime).count());
+    }
+
     return status;
 }
 
@@ -338,6 +774,7 @@ bool UBloxGPS::waitForACK(uint8_t sentMessageClass, uint8_t sentMessageID, us_ti
     {
         printf(
             "NACK rcvd for message: %" PRIx8 " , %" PRIx8 "\r\n", sentMessageClass, sentMessageID);
+        stats_.nacks++;
         return false;
     }
 
@@ -361,11 +798,11 @@ bool UBloxGPS::waitForMessage(uint8_t messageClass, uint8_t messageID, us_time t
         auto ret = readMessage();
         if (ret != ReadStatus::DONE)
         {
-            ThisThread::sleep_for(1ms);
+            waitForData(timeout - timeoutTimer.elapsed_time());
             continue;
         }
 
-        if (messageClass == rxBuffer[UBX_BYTE_CLASS]
+        if (rxBuffer[0] == UBX_MESSAGE_START_CHAR && messageClass == rxBuffer[UBX_BYTE_CLASS]
             && (messageID == rxBuffer[UBX_BYTE_ID] || messageID == ANY_MESSAGE_ID))
         {
             // messageID == ANY_MESSAGE_ID implies we only want to wait for a message for the given
@@ -374,6 +811,7 @@ bool UBloxGPS::waitForMessage(uint8_t messageClass, uint8_t messageID, us_time t
         }
     }
 
+    stats_.timeouts++;
     printf("Timeout after %.03fs waiting for message 0x%02" PRIx8 " 0x%02" PRIx8 ".\r\n",
         static_cast<float>(timeout.count()) / 1e6f,
         messageClass,
@@ -383,26 +821,124 @@ bool UBloxGPS::waitForMessage(uint8_t messageClass, uint8_t messageID, us_time t
 
 void UBloxGPS::processMessage()
 {
+    stats_.countFrame(rxBuffer[UBX_BYTE_CLASS], rxBuffer[UBX_BYTE_ID]);
+    stats_.dispatchLatency.record((now() - rxTimestamp_.lastByte).count());
+
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+    if (numPendingCommands_ > 0 && rxBuffer[UBX_BYTE_CLASS] != UBX_CLASS_ACK)
+    {
+        completePendingCommand(rxBuffer[UBX_BYTE_CLASS], rxBuffer[UBX_BYTE_ID], true);
+    }
+#endif
+
     switch (rxBuffer[UBX_BYTE_CLASS])
     {
+        case UBX_CLASS_ACK:
+            {
+                const uint8_t ackedClass = rxBuffer[UBX_DATA_OFFSET];
+                const uint8_t ackedID = rxBuffer[UBX_DATA_OFFSET + 1];
+
+                // Record the answer to the configuration step, unless it answers an async command
+                // with the same class and ID which was sent first
+                bool forConfiguration = configAckExpected_ && ackState_ == AckState::NONE
+                    && ackedClass == configCommandClass_ && ackedID == configCommandID_;
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+                forConfiguration = forConfiguration
+                    && !hasPendingCommandBefore(ackedClass, ackedID, configCommandSequence_);
+#endif
+                if (forConfiguration)
+                {
+                    ackState_ = rxBuffer[UBX_BYTE_ID] == UBX_ACK_ACK ? AckState::ACK : AckState::NACK;
+                }
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+                else
+                {
+                    completePendingCommand(ackedClass, ackedID, false);
+                }
+#endif
+                break;
+            }
         case UBX_CLASS_NAV:
             {
+                // All NAV messages we handle contain the iTOW of their epoch
+                recordEpochLatency();
+
                 switch (rxBuffer[UBX_BYTE_ID])
                 {
+#if UBLOX_GNSS_ENABLE_LEGACY_NAV
                     case UBX_NAV_POSLLH:
                         position = parseNAV_POSLLH(rxBuffer);
+                        position.rxTime = rxTimestamp_;
                         break;
                     case UBX_NAV_VELNED:
                         velocity = parseNAV_VELNED(rxBuffer);
+                        velocity.rxTime = rxTimestamp_;
                         break;
                     case UBX_NAV_SOL:
                         fixQuality = parseNAV_SOL(rxBuffer);
+                        fixQuality.rxTime = rxTimestamp_;
                         break;
                     case UBX_NAV_TIMEUTC:
                         time = parseNAV_TIMEUTC(rxBuffer);
+                        time.rxTime = rxTimestamp_;
+                        break;
+#endif
+#if UBLOX_GNSS_ENABLE_HIGH_PRECISION
+                    case UBX_NAV_HPPOSLLH:
+                        highPrecisionPosition = parseNAV_HPPOSLLH(rxBuffer);
+                        highPrecisionPosition.rxTime = rxTimestamp_;
+                        break;
+                    case UBX_NAV_HPPOSECEF:
+                        highPrecisionECEF = parseNAV_HPPOSECEF(rxBuffer);
+                        highPrecisionECEF.rxTime = rxTimestamp_;
+                        break;
+#endif
+#if UBLOX_GNSS_ENABLE_COVARIANCE
+                    case UBX_NAV_COV:
+                        parseNAV_COV(rxBuffer, covariance);
+                        covariance.rxTime = rxTimestamp_;
+                        break;
+                    case UBX_NAV_DOP:
+                        dilutionOfPrecision = parseNAV_DOP(rxBuffer);
+                        dilutionOfPrecision.rxTime = rxTimestamp_;
+                        break;
+#endif
+                    case UBX_NAV_EOE:
+                        if (epochCallback_)
+                        {
+                            uint32_t iTOW;
+                            memcpy(&iTOW, rxBuffer + UBX_DATA_OFFSET, sizeof(iTOW));
+                            inCallback_ = true;
+                            epochCallback_(iTOW);
+                            inCallback_ = false;
+                        }
+                        break;
+#if UBLOX_GNSS_ENABLE_RELPOSNED
+                    case UBX_NAV_RELPOSNED:
+                        relativePosition = parseNAV_RELPOSNED(rxBuffer);
+                        relativePosition.rxTime = rxTimestamp_;
+                        break;
+#endif
+#if UBLOX_GNSS_ENABLE_HEALTH_MONITOR
+                    case UBX_NAV_STATUS:
+                        parseNAV_STATUS(rxBuffer, health);
+                        health.statusTime = rxTimestamp_;
+                        break;
+#endif
+                    case UBX_NAV_TIMELS:
+                        leapSeconds = parseNAV_TIMELS(rxBuffer);
+                        leapSeconds.rxTime = rxTimestamp_;
                         break;
                     case UBX_NAV_PVT:
                         parseNAV_PVT(rxBuffer, position, velocity, fixQuality, time);
+                        position.rxTime = rxTimestamp_;
+                        velocity.rxTime = rxTimestamp_;
+                        fixQuality.rxTime = rxTimestamp_;
+                        time.rxTime = rxTimestamp_;
+                        if (extrapolator_ != nullptr)
+                        {
+                            extrapolator_->onNavigationSolution(position, velocity, fixQuality);
+                        }
                         break;
                     default:
                         return;
@@ -413,36 +949,549 @@ void UBloxGPS::processMessage()
             {
                 switch (rxBuffer[UBX_BYTE_ID])
                 {
+#if UBLOX_GNSS_ENABLE_TIMEPULSE
                     case UBX_TIM_TP:
                         timePulse = parseTIM_TP(rxBuffer);
+                        timePulse.rxTime = rxTimestamp_;
+                        if (ppsClock_ != nullptr)
+                        {
+                            ppsClock_->onTimepulseMessage(timePulse);
+                        }
+                        break;
+#endif
+#if UBLOX_GNSS_TIMEMARK_QUEUE_SIZE > 0
+                    case UBX_TIM_TM2:
+                        queueTimemarkEvent();
+                        break;
+#endif
+                }
+                break;
+            }
+        case UBX_CLASS_MON:
+            {
+                switch (rxBuffer[UBX_BYTE_ID])
+                {
+                    case UBX_MON_VER:
+                        versionReceived_ = true;
+                        break;
+#if UBLOX_GNSS_ENABLE_HEALTH_MONITOR
+                    case UBX_MON_RF:
+                        parseMON_RF(rxBuffer, health);
+                        health.rfTime = rxTimestamp_;
+                        antennaPowerStatus = health.antennaPower;
+                        break;
+                    case UBX_MON_HW:
+                        // Gen 9 receivers output MON-RF, which has a result for every band
+                        if (health.rfTime.lastByte == 0us || getGPSGeneration() < 9)
+                        {
+                            parseMON_HW(rxBuffer, health);
+                            health.rfTime = rxTimestamp_;
+                        }
+                        antennaPowerStatus = health.antennaPower;
                         break;
+#endif
+                }
+                break;
+            }
+#if UBLOX_GNSS_ENABLE_HEALTH_MONITOR
+        case UBX_CLASS_SEC:
+            {
+                if (rxBuffer[UBX_BYTE_ID] == UBX_SEC_SIG)
+                {
+                    parseSEC_SIG(rxBuffer, health);
+                    health.securityTime = rxTimestamp_;
                 }
                 break;
             }
+#endif
         default:
             return;
     }
 }
 
-bool UBloxGPS::calcChecksum(
-    const uint8_t* packet, uint32_t packetLen, uint8_t& chka, uint8_t& chkb) const
+#if UBLOX_GNSS_TIMEMARK_QUEUE_SIZE > 0
+void UBloxGPS::queueTimemarkEvent()
 {
-    // Start the checksum calculation after the sync bytes,
-    // and continue until the checksum bytes
-    chka = 0;
-    chkb = 0;
+    TimemarkEvent event = parseTIM_TM2(rxBuffer);
+    event.rxTime = rxTimestamp_;
+
+    if (haveTimemarkCount_ && event.newRisingEdge)
+    {
+        // Each message reports only the latest edge, so a jump of more than one in the count
+        // means edges were lost.
+        uint16_t edges = event.count - lastTimemarkCount_;
+        if (edges > 1)
+        {
+            stats_.timemarksMissed += edges - 1;
+        }
+    }
+    lastTimemarkCount_ = event.count;
+    haveTimemarkCount_ = true;
 
-    if (packetLen < 2)
+    if (timemarkQueue_.full())
+    {
+        // CircularBuffer overwrites the oldest element
+        stats_.timemarkOverflows++;
+    }
+    timemarkQueue_.push(event);
+}
+#endif
+
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+bool UBloxGPS::sendCommandAsync(uint8_t messageClass, uint8_t messageID, const uint8_t* data,
+    uint16_t dataLen, bool waitForResponse, CommandCallback callback, us_time timeout)
+{
+    PendingCommand* slot = nullptr;
+    for (PendingCommand& command : pendingCommands_)
     {
+        if (!command.active)
+        {
+            slot = &command;
+            break;
+        }
+    }
+
+    if (slot == nullptr)
+    {
+        printf("%s: too many pending commands, can't send 0x%02" PRIx8 " 0x%02" PRIx8 "\r\n",
+            getName(), messageClass, messageID);
         return false;
     }
 
-    for (uint32_t i = 2; i < packetLen - 2; i++)
+    const us_time sendTime = now();
+    if (!sendCommand(messageClass, messageID, data, dataLen, false, false, 0us))
     {
-        chka += packet[i];
-        chkb += chka;
+        return false;
     }
 
+    slot->callback = callback;
+    slot->sentTime = sendTime;
+    slot->timeout = timeout;
+    slot->sequence = nextCommandSequence_++;
+    slot->messageClass = messageClass;
+    slot->messageID = messageID;
+    slot->waitForResponse = waitForResponse;
+    slot->active = true;
+    numPendingCommands_++;
+    return true;
+}
+
+bool UBloxGPS::hasPendingCommandBefore(
+    uint8_t messageClass, uint8_t messageID, uint32_t sequence) const
+{
+    for (const PendingCommand& command : pendingCommands_)
+    {
+        if (command.active && command.messageClass == messageClass
+            && command.messageID == messageID && !command.waitForResponse
+            && static_cast<int32_t>(command.sequence - sequence) < 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void UBloxGPS::completePendingCommand(uint8_t messageClass, uint8_t messageID, bool isResponse)
+{
+    const bool isNACK = !isResponse && rxBuffer[UBX_BYTE_ID] == UBX_ACK_NACK;
+
+    // Find the oldest matching command.  Polls finish with their response, or a NACK if the GPS
+    // doesn't support them, and other commands with an ACK or NACK.
+    PendingCommand* oldest = nullptr;
+    for (PendingCommand& command : pendingCommands_)
+    {
+        if (!command.active || command.messageClass != messageClass || command.messageID != messageID)
+        {
+            continue;
+        }
+        if (isResponse != command.waitForResponse && !isNACK)
+        {
+            continue;
+        }
+        if (oldest == nullptr || static_cast<int32_t>(command.sequence - oldest->sequence) < 0)
+        {
+            oldest = &command;
+        }
+    }
+
+    if (oldest == nullptr)
+    {
+        return;
+    }
+
+    CommandResult result;
+    if (isResponse)
+    {
+        result = CommandResult::RESPONSE;
+    }
+    else if (isNACK)
+    {
+        stats_.nacks++;
+        result = CommandResult::NACK;
+    }
+    else
+    {
+        result = CommandResult::ACK;
+    }
+    stats_.commandRoundTrip.record((now() - oldest->sentTime).count());
+
+    // Free the slot before calling the callback, so that the next command can reuse it
+    CommandCallback callback = oldest->callback;
+    oldest->active = false;
+    numPendingCommands_--;
+
+    if (isResponse)
+    {
+        callCommandCallback(callback, result, rxBuffer, currMessageLength_);
+    }
+    else
+    {
+        callCommandCallback(callback, result, nullptr, 0);
+    }
+}
+
+void UBloxGPS::expirePendingCommands()
+{
+    const us_time currTime = now();
+    for (PendingCommand& command : pendingCommands_)
+    {
+        if (!command.active || currTime - command.sentTime <= command.timeout)
+        {
+            continue;
+        }
+
+        stats_.timeouts++;
+        CommandCallback callback = command.callback;
+        command.active = false;
+        numPendingCommands_--;
+
+        callCommandCallback(callback, CommandResult::TIMEOUT, nullptr, 0);
+    }
+}
+
+void UBloxGPS::callCommandCallback(
+    const CommandCallback& callback, CommandResult result, const uint8_t* message, size_t length)
+{
+    if (callback)
+    {
+        inCallback_ = true;
+        callback(result, message, length);
+        inCallback_ = false;
+    }
+}
+#endif
+
+#if UBLOX_GNSS_ENABLE_WATCHDOG
+void UBloxGPS::enableWatchdog(const WatchdogConfig& config)
+{
+    watchdogConfig_ = config;
+    watchdogEnabled_ = true;
+    recoveryStage_ = RecoveryStage::IDLE;
+    restartStreamChecks();
+}
+
+void UBloxGPS::disableWatchdog()
+{
+    watchdogEnabled_ = false;
+    recoveryStage_ = RecoveryStage::IDLE;
+}
+
+uint32_t UBloxGPS::countStreamErrors() const
+{
+    return stats_.checksumFailures + stats_.resyncs + stats_.truncations + stats_.busErrors;
+}
+
+void UBloxGPS::restartStreamChecks()
+{
+    const us_time currTime = now();
+    watchdogFrames_ = stats_.framesReceived + stats_.rtcmFramesReceived + stats_.nmeaSentences;
+    lastFrameTime_ = currTime;
+    errorWindowStart_ = currTime;
+    errorWindowBase_ = countStreamErrors();
+    stageStartTime_ = currTime;
+    stageFramesBase_ = watchdogFrames_;
+    stageErrorsBase_ = errorWindowBase_;
+    epochGapDetected_ = false;
+    stageWatching_ = true;
+
+    // Epochs are usually lost while the stream is down, so the gap up to the next one is expected
+    ignoreEpochGap_ = recoveryStage_ != RecoveryStage::IDLE;
+}
+
+void UBloxGPS::enterRecoveryStage(RecoveryStage stage)
+{
+    recoveryStage_ = stage;
+
+    switch (stage)
+    {
+        case RecoveryStage::IDLE:
+            restartStreamChecks();
+            break;
+
+        case RecoveryStage::RESYNC:
+            DEBUG("%s: stream fault, resynchronizing\r\n", getName());
+            resetFramer();
+            restartStreamChecks();
+            break;
+
+        case RecoveryStage::HOT_START:
+            DEBUG("%s: stream not recovered, hot starting\r\n", getName());
+            stats_.watchdogHotStarts++;
+            softwareReset(SWResetType::HOT_START);
+            stageWatching_ = false;
+            break;
+
+        case RecoveryStage::RECONFIGURE:
+            DEBUG("%s: stream not recovered, reconfiguring\r\n", getName());
+            stats_.watchdogReconfigures++;
+            resetFramer();
+            versionReceived_ = false;
+            watchdogConfiguring_ = false;
+            sendPacket(Packets::POLL_MON_VER, false, false, 0us);
+            stageStartTime_ = now();
+            stageWatching_ = false;
+            break;
+    }
+}
+
+void UBloxGPS::serviceWatchdog()
+{
+    const us_time currTime = now();
+    const uint32_t frames = stats_.framesReceived + stats_.rtcmFramesReceived + stats_.nmeaSentences;
+    const uint32_t errors = countStreamErrors();
+
+    // Counters going backwards means the statistics were reset
+    if (frames < watchdogFrames_ || errors < errorWindowBase_ || errors < stageErrorsBase_)
+    {
+        restartStreamChecks();
+        return;
+    }
+
+    if (frames != watchdogFrames_)
+    {
+        watchdogFrames_ = frames;
+        lastFrameTime_ = currTime;
+    }
+
+    switch (recoveryStage_)
+    {
+        case RecoveryStage::IDLE:
+            {
+                // The stream is expected to stop during a reset or initialization started by the
+                // application
+                if (resetInProgress_ || isBeginInProgress())
+                {
+                    restartStreamChecks();
+                    return;
+                }
+
+                bool fault = true;
+                if (currTime - lastFrameTime_ > watchdogConfig_.stallTimeout)
+                {
+                    stats_.streamStalls++;
+                }
+                else if (epochGapDetected_)
+                {
+                    stats_.epochGaps++;
+                }
+                else if (errors - errorWindowBase_ > watchdogConfig_.maxErrors)
+                {
+                    stats_.errorBursts++;
+                }
+                else
+                {
+                    fault = false;
+                }
+
+                if (fault)
+                {
+                    enterRecoveryStage(RecoveryStage::RESYNC);
+                }
+                else if (currTime - errorWindowStart_ > watchdogConfig_.errorWindow)
+                {
+                    errorWindowStart_ = currTime;
+                    errorWindowBase_ = errors;
+                }
+                return;
+            }
+
+        case RecoveryStage::HOT_START:
+            if (!stageWatching_)
+            {
+                // Wait out the boot time without blocking
+                if (resetTimer_.elapsed_time() < BOOT_TIME)
+                {
+                    return;
+                }
+                resetInProgress_ = false;
+                resetTimer_.stop();
+                resetFramer();
+                restartStreamChecks();
+                return;
+            }
+            break;
+
+        case RecoveryStage::RECONFIGURE:
+            if (!stageWatching_)
+            {
+                StepStatus status;
+                if (watchdogConfiguring_)
+                {
+                    status = advanceConfiguration();
+                }
+                else if (versionReceived_)
+                {
+                    // Only restore the RAM settings: the saved ones are unchanged by a fault
+                    watchdogConfiguring_ = true;
+                    status = startConfiguration(false);
+                }
+                else
+                {
+                    if (currTime - stageStartTime_ > watchdogConfig_.stageTimeout)
+                    {
+                        printf("%s: no response to version poll, retrying recovery\r\n", getName());
+                        enterRecoveryStage(RecoveryStage::HOT_START);
+                    }
+                    return;
+                }
+
+                if (status == StepStatus::IN_PROGRESS)
+                {
+                    return;
+                }
+
+                watchdogConfiguring_ = false;
+                if (status == StepStatus::FAILED)
+                {
+                    printf("%s: failed to reconfigure, retrying recovery\r\n", getName());
+                    enterRecoveryStage(RecoveryStage::HOT_START);
+                    return;
+                }
+                restartStreamChecks();
+                return;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    // Watching the stream after a stage: it has recovered if it stays healthy for stageTimeout
+    if (currTime - stageStartTime_ < watchdogConfig_.stageTimeout)
+    {
+        return;
+    }
+
+    const uint64_t allowedErrors = static_cast<uint64_t>(watchdogConfig_.maxErrors)
+        * watchdogConfig_.stageTimeout.count() / watchdogConfig_.errorWindow.count();
+    const bool healthy = frames != stageFramesBase_ && errors - stageErrorsBase_ <= allowedErrors
+        && !epochGapDetected_;
+
+    if (healthy)
+    {
+        DEBUG("%s: stream recovered\r\n", getName());
+        stats_.watchdogRecoveries++;
+        enterRecoveryStage(RecoveryStage::IDLE);
+    }
+    else if (recoveryStage_ == RecoveryStage::RESYNC)
+    {
+        enterRecoveryStage(RecoveryStage::HOT_START);
+    }
+    else if (recoveryStage_ == RecoveryStage::HOT_START)
+    {
+        enterRecoveryStage(RecoveryStage::RECONFIGURE);
+    }
+    else
+    {
+        // Nothing worked, so start again from the hot start
+        enterRecoveryStage(RecoveryStage::HOT_START);
+    }
+}
+#endif
+
+void UBloxGPS::recordEpochLatency()
+{
+    // Most NAV messages start with the iTOW, but newer ones have a version and flags first
+    size_t iTOWOffset = 0;
+    switch (rxBuffer[UBX_BYTE_ID])
+    {
+        case UBX_NAV_HPPOSLLH:
+        case UBX_NAV_HPPOSECEF:
+        case UBX_NAV_RELPOSNED:
+            iTOWOffset = 4;
+            break;
+        default:
+            break;
+    }
+
+    uint32_t iTOW = 0;
+    memcpy(&iTOW, rxBuffer + UBX_DATA_OFFSET + iTOWOffset, sizeof(iTOW));
+
+    // Only the first message of each epoch is used, since later ones are delayed by the earlier
+    // ones ahead of them.
+    if (haveEpochBaseline_ && iTOW == lastEpochITOW_)
+    {
+        return;
+    }
+
+    int64_t offset = rxTimestamp_.lastByte.count() - static_cast<int64_t>(iTOW) * 1000;
+
+    if (!haveEpochBaseline_ || iTOW < lastEpochITOW_)
+    {
+        // First epoch, or the week rolled over
+        epochOffsetBaseline_ = offset;
+        haveEpochBaseline_ = true;
+    }
+    else
+    {
+        // Each epoch should follow the last by one navigation period
+        const uint32_t periodMs = 1000 / navigationRateHz_;
+        const uint32_t epochs = (iTOW - lastEpochITOW_ + periodMs / 2) / periodMs;
+        if (epochs > 1)
+        {
+            stats_.epochsMissed += epochs - 1;
+#if UBLOX_GNSS_ENABLE_WATCHDOG
+            if (watchdogConfig_.maxMissedEpochs != 0 && epochs - 1 > watchdogConfig_.maxMissedEpochs
+                && !ignoreEpochGap_)
+            {
+                epochGapDetected_ = true;
+            }
+#endif
+        }
+
+#if UBLOX_GNSS_ENABLE_WATCHDOG
+        ignoreEpochGap_ = false;
+#endif
+
+        // Let the baseline creep upwards by ~120ppm of elapsed time so that it can follow drift
+        // between the host and GNSS clocks.
+        epochOffsetBaseline_ += (rxTimestamp_.lastByte - lastEpochTime_).count() / 8192;
+        epochOffsetBaseline_ = std::min(epochOffsetBaseline_, offset);
+    }
+
+    stats_.epochLatency.record(static_cast<uint32_t>(offset - epochOffsetBaseline_));
+
+    lastEpochITOW_ = iTOW;
+    lastEpochTime_ = rxTimestamp_.lastByte;
+}
+
+bool UBloxGPS::calcChecksum(
+    const uint8_t* packet, uint32_t packetLen, uint8_t& chka, uint8_t& chkb) const
+{
+    chka = 0;
+    chkb = 0;
+
+    if (packetLen < UBX_HEADER_FOOTER_LENGTH)
+    {
+        return false;
+    }
+
+    // Start the checksum calculation after the sync bytes,
+    // and continue until the checksum bytes
+    uint16_t checksum = calcUBXChecksum(packet + UBX_BYTE_CLASS, packetLen - 4);
+    chka = checksum & 0xFF;
+    chkb = checksum >> 8;
+
     return true;
 }
 
@@ -462,7 +1511,12 @@ bool UBloxGPS::verifyChecksum(uint32_t messageLength)
         {
             return false;
         }
-        return (chka == rxBuffer[messageLength - 2]) && (chkb == rxBuffer[messageLength - 1]);
+        if ((chka != rxBuffer[messageLength - 2]) || (chkb != rxBuffer[messageLength - 1]))
+        {
+            stats_.checksumFailures++;
+            return false;
+        }
+        return true;
     }
 
     // If the packet is NOT UBX, then it doesn't have a checksum.
@@ -470,6 +1524,352 @@ bool UBloxGPS::verifyChecksum(uint32_t messageLength)
     return true;
 }
 
+#if UBLOX_GNSS_RTCM_QUEUE_SIZE > 0
+bool UBloxGPS::injectRTCMFrame(const uint8_t* frame, size_t len)
+{
+    if (!isValidRTCMFrame(frame, len))
+    {
+        DEBUG("Rejected invalid RTCM3 frame (%zu bytes)\r\n", len);
+        rtcmInjectFramesInvalid_++;
+        rtcmInjectBytesDropped_ += len;
+        return false;
+    }
+
+    // Only queue whole frames, so that the GPS never receives part of one
+    if (UBLOX_GNSS_RTCM_QUEUE_SIZE - rtcmQueue_.size() < len)
+    {
+        DEBUG("RTCM3 queue full, dropping frame (%zu bytes)\r\n", len);
+        rtcmInjectBytesDropped_ += len;
+        return false;
+    }
+
+    rtcmQueue_.push(frame, len);
+    return true;
+}
+
+void UBloxGPS::flushRTCMQueue()
+{
+    while (true)
+    {
+        // Take the next frame's header off the queue to find its length.  It is kept until the
+        // whole frame can be sent.
+        if (rtcmNextFrameLength_ == 0)
+        {
+            if (rtcmQueue_.size() < RTCM3_HEADER_LENGTH)
+            {
+                break;
+            }
+            rtcmQueue_.pop(rtcmNextHeader_, RTCM3_HEADER_LENGTH);
+            rtcmNextFrameLength_ = getRTCMFrameLength(rtcmNextHeader_);
+        }
+
+        // Frames are only ever sent whole, so that no command can end up in the middle of one
+        const size_t frameLength = rtcmNextFrameLength_;
+        if (frameLength > transferBudgetRemaining())
+        {
+            break;
+        }
+        spendTransferBudget(frameLength);
+
+        // Send in pieces as large as the TX buffer (which is free outside of sendCommand())
+        bool sent = true;
+        for (size_t offset = 0; offset < frameLength;)
+        {
+            size_t chunkLen = std::min(frameLength - offset, sizeof(txBuffer_));
+
+            // The I2C port treats a one byte write as setting its register address, so never leave
+            // a single byte for the next write
+            if (frameLength - offset - chunkLen == 1)
+            {
+                chunkLen--;
+            }
+
+            size_t headerLen = 0;
+            if (offset == 0)
+            {
+                memcpy(txBuffer_, rtcmNextHeader_, RTCM3_HEADER_LENGTH);
+                headerLen = RTCM3_HEADER_LENGTH;
+            }
+            rtcmQueue_.pop(txBuffer_ + headerLen, chunkLen - headerLen);
+
+            sent = sendMessage(txBuffer_, chunkLen) && sent;
+            offset += chunkLen;
+        }
+        rtcmNextFrameLength_ = 0;
+
+        if (sent)
+        {
+            stats_.rtcmBytesInjected += frameLength;
+        }
+        else
+        {
+            stats_.rtcmBytesDropped += frameLength;
+        }
+    }
+}
+#endif
+
+UBloxGPS::ReadStatus UBloxGPS::receiveBytes(const uint8_t* data, size_t len, size_t& consumed)
+{
+    consumed = 0;
+    while (consumed < len)
+    {
+        if (rxFrameType_ == FrameType::NONE)
+        {
+            // check for the start of a frame
+            const uint8_t incoming = data[consumed++];
+            switch (incoming)
+            {
+                case UBX_MESSAGE_START_CHAR:
+                    rxFrameType_ = FrameType::UBX;
+                    break;
+
+                case NMEA_MESSAGE_START_CHAR:
+                    rxFrameType_ = FrameType::NMEA;
+                    break;
+
+                case RTCM3_PREAMBLE:
+                    rxFrameType_ = FrameType::RTCM;
+                    break;
+
+                case 0xFF:
+                    // 0xFF is sent by SPI and I2C to indicate no data
+                    stats_.idleBytes++;
+                    continue;
+
+                default:
+                    DEBUG("Received unknown byte 0x%" PRIx8
+                          ", not the start of a UBX, NMEA or RTCM3 message.\r\n",
+                        incoming);
+                    stats_.resyncs++;
+                    continue;
+            }
+
+            rxTimestamp_.firstByte = now();
+            rxBuffer[0] = incoming;
+            rxIndex_ = 1;
+            rxFrameLength_ = 0;
+        }
+        else if (rxFrameType_ == FrameType::NMEA)
+        {
+            // NMEA sentences end with CRLF
+            const uint8_t* lineEnd = static_cast<const uint8_t*>(
+                memchr(data + consumed, '\n', len - consumed));
+            const size_t chunk = lineEnd != nullptr ? (lineEnd - (data + consumed)) + 1 : len - consumed;
+
+            const size_t storable = rxIndex_ < MAX_MESSAGE_LEN ? std::min(chunk, MAX_MESSAGE_LEN - rxIndex_) : 0;
+            if (storable > 0 && rxBuffer + rxIndex_ != data + consumed)
+            {
+                memmove(rxBuffer + rxIndex_, data + consumed, storable);
+            }
+            rxIndex_ += chunk;
+            consumed += chunk;
+
+            if (lineEnd != nullptr)
+            {
+                return finishNMEASentence();
+            }
+        }
+        else if (rxFrameLength_ == 0)
+        {
+            // Receive the UBX or RTCM3 header one byte at a time, since it has to be checked
+            const uint8_t incoming = data[consumed++];
+            const bool badSync = rxFrameType_ == FrameType::UBX && rxIndex_ == 1
+                && incoming != UBX_MESSAGE_START_CHAR2;
+            rxBuffer[rxIndex_] = incoming;
+
+            if (!badSync && ++rxIndex_ == rxHeaderLength())
+            {
+                if (rxFrameType_ == FrameType::UBX)
+                {
+                    // Add 8 to account for the sync(2) bytes, class, id, length(2) and checksum(2) bytes
+                    rxFrameLength_ = (static_cast<uint16_t>(rxBuffer[5] << 8) | rxBuffer[4])
+                        + UBX_HEADER_FOOTER_LENGTH;
+                }
+                else
+                {
+                    // Zero if the reserved bits are not zero, i.e. this wasn't really a frame
+                    rxFrameLength_ = getRTCMFrameLength(rxBuffer);
+                }
+            }
+
+            if (badSync || (rxIndex_ == rxHeaderLength() && rxFrameLength_ == 0))
+            {
+                DEBUG("Bad %s header, resyncing.\r\n", rxFrameType_ == FrameType::UBX ? "UBX" : "RTCM3");
+                stats_.resyncs++;
+                resetFramer();
+
+                // The last byte may be the real start of the next frame
+                if (incoming == UBX_MESSAGE_START_CHAR || incoming == NMEA_MESSAGE_START_CHAR
+                    || incoming == RTCM3_PREAMBLE)
+                {
+                    consumed--;
+                }
+            }
+        }
+        else
+        {
+            // Copy as much of the body as possible in one go.  If the frame is too big for
+            // rxBuffer, its body is skipped.
+            const size_t chunk = std::min(len - consumed, rxFrameLength_ - rxIndex_);
+            if (rxFrameLength_ <= MAX_MESSAGE_LEN && rxBuffer + rxIndex_ != data + consumed)
+            {
+                memmove(rxBuffer + rxIndex_, data + consumed, chunk);
+            }
+            rxIndex_ += chunk;
+            consumed += chunk;
+
+            if (rxIndex_ == rxFrameLength_)
+            {
+                return rxFrameType_ == FrameType::UBX ? finishUBXFrame() : finishRTCMFrame();
+            }
+        }
+    }
+
+    return ReadStatus::NO_DATA;
+}
+
+uint8_t* UBloxGPS::rxWritePointer()
+{
+    if (rxFrameLength_ > MAX_MESSAGE_LEN)
+    {
+        // Body being skipped.  Overwrite the body area, keeping the header for debugging.
+        return rxBuffer + rxHeaderLength();
+    }
+    if (rxIndex_ >= MAX_MESSAGE_LEN)
+    {
+        // Overlong NMEA sentence being skipped
+        return rxBuffer + MAX_MESSAGE_LEN - 1;
+    }
+    return rxBuffer + rxIndex_;
+}
+
+size_t UBloxGPS::rxBytesWanted() const
+{
+    if (rxFrameType_ == FrameType::UBX || rxFrameType_ == FrameType::RTCM)
+    {
+        if (rxFrameLength_ == 0)
+        {
+            return rxHeaderLength() - rxIndex_;
+        }
+        if (rxFrameLength_ > MAX_MESSAGE_LEN)
+        {
+            return std::min<size_t>(rxFrameLength_ - rxIndex_, MAX_MESSAGE_LEN - rxHeaderLength());
+        }
+        return rxFrameLength_ - rxIndex_;
+    }
+
+    // Start of frame, or NMEA (where we have to look for the line ending)
+    return 1;
+}
+
+size_t UBloxGPS::rxHeaderLength() const
+{
+    return rxFrameType_ == FrameType::RTCM ? RTCM3_HEADER_LENGTH : UBX_DATA_OFFSET;
+}
+
+void UBloxGPS::resetFramer()
+{
+    rxFrameType_ = FrameType::NONE;
+    rxIndex_ = 0;
+    rxFrameLength_ = 0;
+}
+
+UBloxGPS::ReadStatus UBloxGPS::finishUBXFrame()
+{
+    rxTimestamp_.lastByte = now();
+    isNMEASentence = false;
+    currMessageLength_ = rxFrameLength_;
+    resetFramer();
+
+    if (currMessageLength_ > MAX_MESSAGE_LEN)
+    {
+        // Message didn't fit in rxBuffer, so the checksum can't be checked
+        printf("UBX message too long (%zu bytes), dropping it.\r\n", currMessageLength_);
+        stats_.truncations++;
+        return ReadStatus::ERR;
+    }
+
+    // add null terminator
+    rxBuffer[currMessageLength_] = 0;
+
+    DEBUG("Received packet (%zu bytes): ", currMessageLength_);
+    for (size_t j = 0; j < currMessageLength_; j++)
+    {
+        DEBUG(" %02" PRIx8, rxBuffer[j]);
+    }
+    DEBUG("\r\n");
+
+    if (!verifyChecksum(currMessageLength_))
+    {
+        printf("Checksums for UBX message don't match!\r\n");
+        return ReadStatus::ERR;
+    }
+
+    processMessage();
+    return ReadStatus::DONE;
+}
+
+UBloxGPS::ReadStatus UBloxGPS::finishRTCMFrame()
+{
+    rxTimestamp_.lastByte = now();
+    isNMEASentence = false;
+    currMessageLength_ = rxFrameLength_;
+    resetFramer();
+
+    if (currMessageLength_ > MAX_MESSAGE_LEN)
+    {
+        printf("RTCM3 message too long (%zu bytes), dropping it.\r\n", currMessageLength_);
+        stats_.truncations++;
+        stats_.rtcmFramesTooLong++;
+        return ReadStatus::ERR;
+    }
+
+    if (!isValidRTCMFrame(rxBuffer, currMessageLength_))
+    {
+        printf("CRC for RTCM3 message doesn't match!\r\n");
+        stats_.checksumFailures++;
+        return ReadStatus::ERR;
+    }
+
+    stats_.rtcmFramesReceived++;
+    if (rtcmOutputCallback_)
+    {
+        inCallback_ = true;
+        rtcmOutputCallback_(rxBuffer, currMessageLength_);
+        inCallback_ = false;
+    }
+    return ReadStatus::DONE;
+}
+
+UBloxGPS::ReadStatus UBloxGPS::finishNMEASentence()
+{
+    rxTimestamp_.lastByte = now();
+    isNMEASentence = true;
+    stats_.nmeaSentences++;
+
+    const bool truncated = rxIndex_ > MAX_MESSAGE_LEN;
+    currMessageLength_ = std::min<size_t>(rxIndex_, MAX_MESSAGE_LEN);
+    resetFramer();
+
+    rxBuffer[currMessageLength_] = 0;
+    if (truncated)
+    {
+        stats_.truncations++;
+        return ReadStatus::ERR;
+    }
+    return ReadStatus::DONE;
+}
+
+void UBloxGPS::waitForData(us_time timeout)
+{
+    if (timeout > 0us)
+    {
+        ThisThread::sleep_for(
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::min<us_time>(timeout, 1ms)));
+    }
+}
+
 int UBloxGPS::DEBUG_TR(const char* format, ...)
 {
 #if UBLOX_GNSS_TRANSACTION_DEBUG
@@ -2,14 +2,81 @@
 #define UBLOXGPS_H
 
 #include "UBloxGPSConstants.h"
+#include "UBloxGPSStatistics.h"
 #include "UBloxMessages.h"
+#include "UBloxPacket.h"
+#include "UBloxTime.h"
 #include "mbed.h"
+#include <atomic>
 #include <cinttypes>
 
 namespace UBlox
 {
 using us_time = std::chrono::microseconds;
 
+class PPSClock;
+class PositionExtrapolator;
+
+#if UBLOX_GNSS_ENABLE_WATCHDOG
+/**
+ * @brief Settings for the stream watchdog.  See UBloxGPS::enableWatchdog().
+ */
+struct WatchdogConfig
+{
+    /**
+     * @brief Time without any valid frame after which the stream is considered stalled
+     */
+    us_time stallTimeout = 3s;
+
+    /**
+     * @brief Largest number of consecutive navigation epochs which may be missing from the NAV
+     * messages before recovery is started.  0 disables iTOW gap detection.
+     */
+    uint8_t maxMissedEpochs = 5;
+
+    /**
+     * @brief Number of errors (checksum failures, resyncs, truncations and bus errors) within
+     * errorWindow which counts as an error burst
+     */
+    uint16_t maxErrors = 20;
+
+    us_time errorWindow = 1s;
+
+    /**
+     * @brief How long the stream must stay healthy after each recovery stage for the recovery to
+     * count as successful.  If it does not, the next stage is tried.
+     */
+    us_time stageTimeout = 2s;
+};
+
+/**
+ * @brief Stages of the watchdog's recovery, in the order they are tried
+ */
+enum class RecoveryStage : uint8_t
+{
+    /**
+     * @brief Stream is healthy, or the watchdog is disabled
+     */
+    IDLE,
+
+    /**
+     * @brief Frame parser has been reset, and the stream is being watched
+     */
+    RESYNC,
+
+    /**
+     * @brief Hot start requested.  Waits out the boot time, then watches the stream.
+     */
+    HOT_START,
+
+    /**
+     * @brief Waiting for the receiver to answer a version poll, after which it is reconfigured
+     * and the stream is watched
+     */
+    RECONFIGURE
+};
+#endif
+
 class UBloxGPS
 {
 public:
@@ -35,6 +102,42 @@ public:
         COLD_START = 0xFFFF
     };
 
+    /**
+     * @brief Progress of an initialization started by beginAsync()
+     */
+    enum class BeginState : uint8_t
+    {
+        /**
+         * @brief beginAsync() has not been called
+         */
+        IDLE,
+
+        /**
+         * @brief Waiting for the reset to finish
+         */
+        BOOTING,
+
+        /**
+         * @brief Waiting for the GPS to answer a version poll
+         */
+        CHECKING_VERSION,
+
+        /**
+         * @brief Sending the configuration commands, one at a time, and waiting for their ACKs
+         */
+        CONFIGURING,
+
+        /**
+         * @brief Initialization was successful
+         */
+        DONE,
+
+        /**
+         * @brief The GPS did not answer, or did not accept its configuration
+         */
+        FAILED
+    };
+
     /**
      * @brief Construct a generic UBloxGPS
      *
@@ -56,7 +159,8 @@ public:
      * @details This method starts a software reset (if one is not already in progress.)
      * If a reset was in progress but is not finished, begin() will wait the remaining time.
      * Additionally, proper communcation with the chip is checked, and settings are written to the
-     * chip, if requested.
+     * chip, if requested.  Every configuration command is sent even if an earlier one is refused
+     * or not acknowledged, and initialization fails if any of them was.
      *
      * @param[in] shouldConfigure whether or not to configure the chip. Some UBlox GPS units have NVM to
      * store the configuration, so if the unit has previously been configured, you can save time by
@@ -66,6 +170,48 @@ public:
      */
     bool begin(bool shouldConfigure);
 
+    /**
+     * @brief Start the same initialization as begin(), but without blocking.  Call poll()
+     * repeatedly to carry it out.
+     *
+     * @details Like begin(), this starts a software reset if one is not already in progress.
+     * Several receivers (and other devices) can be initialized concurrently from one thread by
+     * calling beginAsync() on each, then polling them all until they are finished.
+     *
+     * @param[in] shouldConfigure whether or not to configure the chip.  See begin().
+     */
+    void beginAsync(bool shouldConfigure);
+
+    /**
+     * @brief Carry out the next part of the initialization started by beginAsync(), if it is ready
+     * to be done.  Never sleeps or waits for the GPS.
+     *
+     * @details While the initialization is in progress, each call reads the messages waiting
+     * from the GPS, then sends the next command once the GPS has answered the last one.  Messages
+     * are processed as they would be by update().
+     *
+     * @return the state of the initialization.  It is finished once this returns
+     * BeginState::DONE or BeginState::FAILED.
+     */
+    BeginState poll();
+
+    /**
+     * @brief Get the state of the initialization started by beginAsync()
+     */
+    BeginState getBeginState() const
+    {
+        return beginState_;
+    }
+
+    /**
+     * @brief Whether an initialization started by beginAsync() has not finished yet
+     */
+    bool isBeginInProgress() const
+    {
+        return beginState_ != BeginState::IDLE && beginState_ != BeginState::DONE
+            && beginState_ != BeginState::FAILED;
+    }
+
     /**
      * @brief Attempts to read messages for a given amount of time.
      *
@@ -83,6 +229,32 @@ public:
      */
     int update(us_time timeout);
 
+    /**
+     * @brief Read and process messages within a fixed budget of bus bytes and time, for loops
+     * which need a bounded worst-case execution time.
+     *
+     * @details Messages are read until none are waiting, \c maxBytes bytes have been transferred,
+     * or \c maxDuration has passed, whichever comes first.  Never waits for data.  Each bus
+     * transfer is sized to fit in what is left of both budgets (converting time into bytes with
+     * getBusBandwidth()), so reading can stop part way through a frame.  The rest of the frame is
+     * read by the next call to this function or update().
+     *
+     * Queued RTCM3 corrections are sent out of the same budget, but only as whole frames, so that
+     * no command is ever sent in the middle of one.  A frame which doesn't fit in what is left of
+     * the budget waits for a later call, so when injecting corrections, make maxBytes at least as
+     * large as the largest frame (up to 1029 bytes).  Larger frames are only sent by update().
+     *
+     * Time on the bus is then at most maxBytes / getBusBandwidth(), and never runs past
+     * maxDuration, plus a fixed overhead for each transfer (e.g. an I2C length read).  Processing
+     * each complete message, and any commands sent by the watchdog, are not counted.
+     *
+     * @param maxBytes Most bytes to transfer
+     * @param maxDuration Most time to spend reading
+     *
+     * @return the number of messages processed.
+     */
+    int updateWithBudget(size_t maxBytes, us_time maxDuration = us_time::max());
+
     /**
      * @brief Reads and prints the current enabled GNSS Constellations and prints out the IDs for
      * them
@@ -108,7 +280,10 @@ public:
     ssize_t getSatelliteInfo(SatelliteInfo satelliteInfos[], size_t infoLen);
 
     /**
-     * @brief Wait to receive a single MON_RF message and returns the power status
+     * @brief Poll the GPS for a MON-HW message and return the antenna power status from it.
+     *
+     * @details This blocks for up to 500ms.  To check the antenna without blocking, use
+     * enableHealthMonitoring() and read health instead.
      *
      * @return the status of the power of the antenna, or AntennaPowerStatus::NO_MESSAGE_RCVD if we
      * timed out while waiting for a message.
@@ -144,220 +319,1416 @@ public:
     void requestTimepulseUpdate();
 
     /**
-     * @brief State Variable for position.
-     * @details This variable is populated when a new message is received.
-     * To update this variable explicitly, call waitForMessage() with a message type that contains
-     * positional information (NAV_POSLLH or NAV_PVT). Otherwise, call update periodically so that
-     * this variable is updated as new information is received. See UBloxMessages.cpp for options.
-     *
-     * Holds latitude, longitude, and height
+     * @brief Request that the GPS send us its leap second information (UBX-NAV-TIMELS).
+     * @details The response updates the leapSeconds state variable when it is received by update().
+     * Leap seconds change at most twice a year, so this only needs to be polled occasionally.
      */
-    GeodeticPosition position;
+    void requestLeapSecondUpdate();
 
     /**
-     * @brief State Variable for fix quality.
-     * @details This variable is populated when a new message is received.
-     * To update this variable, call waitForMessage() with a message type that contains velocity
-     * information (NAV_SOL or NAV_PVT). Otherwise, call update periodically so that this variable
-     * is updated as new information is received. See UBloxMessages.cpp for options.
+     * @brief What setNavigationRate() should do if the bus can't carry the enabled messages at
+     * the requested rate.
      */
-    FixQuality fixQuality;
+    enum class RatePolicy : uint8_t
+    {
+        /// Leave the rate unchanged and return false
+        REFUSE,
+
+        /// Output every message except NAV-PVT less often, so that the data fits
+        SCALE
+    };
 
     /**
-     * @brief State Variable for velocity
-     * @details This variable is populated when a new message is received.
-     * To update this variable, call waitForMessage() with a message type that contains velocity
-     * information (NAV_VELNED or NAV_PVT). Otherwise, call update() periodically so that this
-     * variable is updated as new information is received. See UBloxMessages.cpp for options.
+     * @brief Set the navigation solution rate (UBX-CFG-RATE or CFG-RATE-MEAS).
      *
-     * Holds north, east, and south velocity, and 3-D speed
+     * @details Before changing the rate, the bandwidth needed by the periodic messages enabled
+     * through this driver is compared with what the transport can carry (UBLOX_GNSS_BUS_BUDGET_PERCENT
+     * of its raw speed).  If it doesn't fit, the rate is refused, or with RatePolicy::SCALE, the
+     * other messages are slowed down by the smallest factor that makes it fit.  The factor is
+     * applied to the rates set with setMessageRate(), so it doesn't compound over several calls,
+     * and messages go back to those rates once a lower navigation rate no longer needs slowing.
+     *
+     * The receiver only sends as fast as update() reads, so make sure update() is called at least
+     * as often as getUpdateInterval().
+     *
+     * The navigation rate and any scaled message rates are only set in the receiver's RAM, so
+     * they are lost at power off.
+     *
+     * @note Multi-constellation navigation is limited to roughly 10Hz on the MAX-8 and 20Hz on the
+     * ZED-F9P (25Hz with fewer constellations), above which the receiver NACKs the rate.
+     *
+     * @param rateHz Navigation rate, 1-40 Hz
+     * @param policy What to do if the enabled messages would not fit on the bus
+     *
+     * @return true if the new rate was acknowledged by the GPS
      */
-    VelocityNED velocity;
+    bool setNavigationRate(uint16_t rateHz, RatePolicy policy = RatePolicy::REFUSE);
 
     /**
-     * @brief State Variable for time.
-     * @details This variable is populated when a new message is received.
-     * To update this variable, call waitForMessage() with a message type that contains time
-     * information (NAV_TIMEUTC or NAV_PVT). Otherwise, call update periodically so that this
-     * variable is updated as new information is received. See UBloxMessages.cpp for options.
+     * @brief Get the navigation rate set with setNavigationRate().
      */
-    UtcTime time;
+    uint16_t getNavigationRate() const
+    {
+        return navigationRateHz_;
+    }
 
     /**
-     * @brief State Variable for time pulse.
-     * @details This variable is populated when a new message is received.
-     * To update this variable, call waitForMessage() with a message type that contains timepulse
-     * information (TIM_TP). Otherwise, call update periodically so that this variable is updated as
-     * new information is received. See UBloxMessages.cpp for options.
+     * @brief Set how often a periodic UBX message is output on the port we are connected to.
+     *
+     * @details The rate is recorded so that setNavigationRate() can budget bus bandwidth for it.
+     *
+     * @param messageClass class of the message
+     * @param messageID id of the message
+     * @param rate Output once every this many navigation epochs, or 0 to disable it
+     *
+     * @return true if the setting was acknowledged by the GPS
      */
-    Timepulse timePulse;
+    virtual bool setMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate) = 0;
 
     /**
-     * @brief State Variable for antenna power status.
-     * @details This variable is populated when a new message is received.
-     * To update this variable, call getAntennaPowerStatus()
+     * @brief Estimate the bandwidth (bytes/s) used by the periodic messages enabled through this
+     * driver, at the current navigation rate.
      */
-    AntennaPowerStatus antennaPowerStatus;
+    uint32_t getRequiredBandwidth() const;
 
     /**
-     * @brief Configure the GPS with the appropriate communications and message settings for this
-     * driver. and save the configuration to NVM on the chip. After initial configuration, the
-     * settings should be reloaded automatically on power-up.
-     *
-     * However, note that on modules without flash memory, the configuration will be lost if the battery backup
-     * power is removed.
-     *
-     * @return true if the configuration was successful, false otherwise
+     * @brief Get the raw number of bytes per second which the transport can carry.
      */
-    virtual bool configure() = 0;
+    virtual uint32_t getBusBandwidth() const = 0;
 
-protected:
     /**
-     * Get the name of this GPS module for debug messages
-     * @return a c-string with the name of the GPS module
+     * @brief Get the longest interval between update() calls which keeps up with the receiver.
+     *
+     * @details This is half the navigation period, so that each epoch's messages are read well
+     * before the next ones are generated.  Call update() (with a timeout of 0) at least this often,
+     * e.g. from a Ticker-driven event queue, and keep calling it until it returns 0.
      */
-    virtual const char* getName() = 0;
+    us_time getUpdateInterval() const
+    {
+        return us_time(1000000 / (2 * navigationRateHz_));
+    }
 
     /**
-     * @brief Assemble a packet with the given payload with the preable, length and checksum, and
-     * send it to the chip.
+     * @brief Enable or disable UBX-TIM-TM2 time mark messages, which report the GNSS time of edges on
+     * the receiver's EXTINT pin.  Received events are queued and can be read with popTimemarkEvent().
      *
-     * @param messageClass class of message being sent
-     * @param messageID id of the message being sent
-     * @param data buffer containing data payload for the packet
-     * @param dataLen length of the data buffer
-     * @param waitForACK wait until an acknowledgement message is received.
-     * @param waitForResponse wait until a response for the message is received.
-     * @param timeout how long to wait before timing out while waiting for ACK or response
-     * @return true if the command was sent successfully, false otherwise.
+     * @note The receiver reports at most one event per edge type per navigation epoch, so the
+     * navigation rate must be at least as high as the event rate or some events will be missed.
+     * Missed events are counted in the statistics.
+     *
+     * @return true if the setting was acknowledged by the GPS
      */
-    bool sendCommand(uint8_t messageClass, uint8_t messageID, const uint8_t* data, uint16_t dataLen,
-        bool waitForACK, bool waitForResponse, us_time timeout);
+    virtual bool enableTimemarkOutput(bool enabled) = 0;
 
     /**
-     * @brief RX Buffer to hold an incoming message
+     * @brief Get the oldest queued time mark event.
+     *
+     * @param[out] event Event to fill in
+     * @return true if an event was returned, false if the queue was empty.
      */
-    uint8_t rxBuffer[MAX_MESSAGE_LEN + 1];
+    bool popTimemarkEvent(TimemarkEvent& event)
+    {
+#if UBLOX_GNSS_TIMEMARK_QUEUE_SIZE > 0
+        return timemarkQueue_.pop(event);
+#else
+        (void)event;
+        return false;
+#endif
+    }
 
     /**
-     * @brief Flag to indicate the type of message currently in UBloxGPS::spiRxBuffer.
-     * @note If true, the message is NMEA, otherwise UBX.
+     * @brief Get the number of time mark events waiting in the queue.
      */
-    bool isNMEASentence = false;
-
-    int DEBUG(const char* format, ...);
-    int DEBUG_TR(const char* format, ...);
+    size_t getTimemarkQueueSize() const
+    {
+#if UBLOX_GNSS_TIMEMARK_QUEUE_SIZE > 0
+        return timemarkQueue_.size();
+#else
+        return 0;
+#endif
+    }
 
-protected:
     /**
-     * @brief enum representing possible read outcomes.
+     * @brief Set a function to be called at the end of each navigation epoch (UBX-NAV-EOE), once
+     * all of that epoch's NAV messages have been received.
+     *
+     * @details The callback is called from update(), and is passed the epoch's iTOW (ms).  When
+     * it is called, position, velocity, covariance, etc. all hold data from the same epoch, so
+     * this is the place to feed them to an estimator.
+     *
+     * NAV-EOE must be enabled, e.g. with enableEpochOutput().
+     *
+     * Sending to the GPS from the callback fails, since it can run part way through a bus transfer.
+     *
+     * @param callback Function to call, or nullptr to stop.
      */
-    enum class ReadStatus : uint8_t
+    void attachEpochCallback(Callback<void(uint32_t iTOW)> callback)
     {
-        DONE = 0,
-        NO_DATA,
-        ERR
-    };
+        epochCallback_ = callback;
+    }
 
     /**
-     * @brief Perform an I2C or SPI write
+     * @brief Enable or disable NAV-COV, NAV-DOP (unless UBLOX_GNSS_ENABLE_COVARIANCE is 0) and
+     * NAV-EOE output every epoch, alongside NAV-PVT.
      *
-     * @note waitForACK assumes that the ACK message has not been read yet. To preserve this
-     * assumption, when checking for ACK, make sure to call waitForACK immediately after the initial
-     * message has been sent. If two messages are sent consecutively, the ACK message for the first
-     * message may be received during the TX of the second message, and it will be ignored. Note
-     * that not all message types report an ACK, so waitForACK does not always need to follow a call
-     * to sendMessage.
+     * @return true if all settings were acknowledged by the GPS
+     */
+    bool enableEpochOutput(bool enabled);
+
+#if UBLOX_GNSS_ENABLE_HEALTH_MONITOR
+    /**
+     * @brief Enable or disable periodic output of the messages which make up the health snapshot:
+     * MON-HW and NAV-STATUS, plus MON-RF and SEC-SIG on Gen 9 receivers.
      *
-     * @param packet buffer of bytes to send out to the chip
-     * @param packetLen number of bytes in packet.
+     * @details Once enabled, health is kept up to date by update() without any polling, so it can
+     * be checked every loop at no cost.
      *
-     * @return true if the write was successful, false otherwise.
+     * @param enabled Whether to output the messages
+     * @param rate Output rate, in navigation solutions per message.  These messages change slowly,
+     *             so at high navigation rates this can be raised to save bus bandwidth.
+     *
+     * @return true if all settings were acknowledged by the GPS
      */
-    virtual bool sendMessage(uint8_t* packet, uint16_t packetLen) = 0;
+    bool enableHealthMonitoring(bool enabled, uint8_t rate = 1);
+#endif
 
+#if UBLOX_GNSS_ENABLE_WATCHDOG
     /**
-     * @brief Read EXACTLY zero or one messages from the chip.
+     * @brief Start watching the stream from the GPS, and recover it automatically if it fails.
      *
-     * @return ReadStatus::DONE if a message was successfully read.
-     *         ReadStatus::NO_DATA if there was not a valid byte available
-     *         ReadStatus::ERR if an invalid byte or checksum was detected.
+     * @details After each update(), the watchdog checks for a stalled stream (no valid frames for
+     * stallTimeout), gaps in the navigation epochs, and bursts of errors.  When it finds one, it
+     * works through the RecoveryStage values in order: reset the frame parser, then hot start the
+     * receiver, then reconfigure it.  Each stage is given stageTimeout to bring the stream back
+     * before the next one is tried, and if reconfiguring does not work either, recovery starts
+     * again from the hot start.
+     *
+     * Recovery is carried out a step at a time by update(), so it never sleeps or waits for the
+     * receiver.  Reconfiguring sends the same commands as configure(), one per update() once the
+     * last has been acknowledged, but only writes the receiver's RAM and never saves to its flash.
+     *
+     * Epoch gaps are found from the iTOW of NAV messages, so they assume that at least one NAV
+     * message (e.g. NAV-PVT, which configure() enables) is output every epoch at the rate set by
+     * setNavigationRate().
+     *
+     * Call this after begin(), since a stream which has not started yet looks stalled.
      */
-    virtual ReadStatus readMessage() = 0;
+    void enableWatchdog(const WatchdogConfig& config);
 
     /**
-     * @brief Update state variable from information contained in the message in rxBuffer
+     * @brief Enable the watchdog with the default settings.
      */
-    void processMessage();
+    void enableWatchdog()
+    {
+        enableWatchdog(WatchdogConfig());
+    }
 
     /**
-     * @brief Verify the validity of the packet in rxBuffer
-     * @returns true if the packet is valid, false otherwise.
+     * @brief Stop the watchdog, abandoning any recovery in progress.
      */
-    bool verifyChecksum(uint32_t messageLength);
+    void disableWatchdog();
 
     /**
-     * @brief Length of message currently in currMessageLength
+     * @brief Get the recovery stage the watchdog is in.  Anything other than RecoveryStage::IDLE
+     * means the stream recently failed, and the state variables may be stale.
      */
-    size_t currMessageLength_ = 0;
+    RecoveryStage getRecoveryStage() const
+    {
+        return recoveryStage_;
+    }
+#endif
 
-private:
     /**
-     * @brief Wait for an ACK for the given message class and ID.
+     * @brief Set a function to be called with each RTCM3 frame received from the GPS, e.g. when
+     * it is acting as a base station.
      *
-     * @details This function assumes that the ACK message has not been read yet. To preserve this
-     * assumption, make sure to always call waitForACK immediately after the initial message has
-     * been sent. If two messages are sent consecutively, the ACK message for the first message may
-     * be received during the TX of the second message, and it will be ignored.
+     * @details The callback is called from update(), and is passed a pointer to the complete frame
+     * (header, payload and CRC) in the driver's RX buffer, which has already been CRC checked.  The
+     * frame is only valid until the callback returns, so copy it if you need to keep it.
      *
-     * @param sentMessageClass Class of the message for which we are expecting an ACK.
-     * @param sentMessageID ID of the message which which we are expecting an ACK
-     * @param timeout How long to wait for the message an ACK, before quitting and returning false.
-     * @return true if a correct ACK was received, false otherwise.
+     * Frames longer than the RX buffer (UBLOX_GNSS_RX_BUFFER_SIZE) are dropped, so set it to at
+     * least 1029 bytes to be sure of receiving every frame.
+     *
+     * The callback can run part way through a bus transfer, so it must not send anything to this
+     * GPS; sendCommand() and the functions built on it fail if it tries.  Passing the frame to
+     * another receiver (e.g. with its injectRTCMFrame()) is fine.
+     *
+     * @param callback Function to call, or nullptr to stop receiving frames.
      */
-    bool waitForACK(uint8_t sentMessageClass, uint8_t sentMessageID, us_time timeout = 1500ms);
+    void attachRTCMOutput(Callback<void(const uint8_t* frame, size_t len)> callback)
+    {
+        rtcmOutputCallback_ = callback;
+    }
 
+#if UBLOX_GNSS_RTCM_QUEUE_SIZE > 0
     /**
-     * Wait for a specific message to be received.
-     * If we get another message that is not the one we're looking for during this time, then we
-     * process that message using processMessage()
-     * If the message is not received before the timeout, returns false.
+     * @brief Queue an RTCM3 correction frame (e.g. from an NTRIP caster or a base station radio)
+     * to be sent to the GPS.
      *
-     * @param messageClass Class of the message to wait for
-     * @param messageID ID of the of the message to wait for. If msgID doesn't matter, put 0xFF
-     * @param timeout How long to wait for the message.
-     * @return
+     * @details Queued data is sent by update(), before each message is read, so call update()
+     * regularly.  The frame is copied, so the buffer can be reused once this returns.  This may be
+     * called from a different thread than update(), but only from one thread at a time.  It
+     * touches only the queue, which is protected by a critical section, and its own drop
+     * counters.
+     *
+     * The GPS's port must accept RTCM3 input; see UBloxGen9::enableRTCMInput().
+     *
+     * @param frame A complete RTCM3 frame, including the header and CRC
+     * @param len Length of the frame
+     *
+     * @return true if the frame was queued, false if it was invalid or there was no room for it.
+     *         Dropped frames are counted in the statistics.
      */
-    bool waitForMessage(uint8_t messageClass, uint8_t messageID = 0xFF, us_time timeout = 1500ms);
+    bool injectRTCMFrame(const uint8_t* frame, size_t len);
 
     /**
-     * @brief Calculate the checksum for the given packet. The packet should include the sync bytes
-     * and rest of header.
-     *
-     * @param[in] packet pointer to packet
-     * @param[in] length of packet, including header and checksum bytes. I.e. data length + 8
-     * @param[out] The chka portion of the checksum (first byte)
-     * @param[out] The chkb portion of the checksum (second byte)
-     * @returns true if the calculation was successful, otherwise false.
+     * @brief Get the number of bytes of correction data waiting to be sent to the GPS.
      */
-    bool calcChecksum(
-        const uint8_t* packet, uint32_t packetLen, uint8_t& chka, uint8_t& chkb) const;
+    size_t getRTCMQueueSize() const
+    {
+        return rtcmQueue_.size() + (rtcmNextFrameLength_ > 0 ? RTCM3_HEADER_LENGTH : 0);
+    }
+#endif
 
     /**
-     * @brief Hardware Reset pin
+     * @brief Attach a PositionExtrapolator, which will be fed every NAV-PVT message received from
+     * this GPS.
+     * @param extrapolator Extrapolator to attach, or nullptr to detach.
      */
-    DigitalOut reset_;
+    void attachExtrapolator(PositionExtrapolator* extrapolator)
+    {
+        extrapolator_ = extrapolator;
+    }
 
+#if UBLOX_GNSS_ENABLE_TIMEPULSE
     /**
-     * @brief Timer to keep track of time since reset.
+     * @brief Attach a PPSClock, which will be fed every TIM-TP message received from this GPS.
+     * @param clock Clock to attach, or nullptr to detach.
      */
-    Timer resetTimer_;
+    void attachPPSClock(PPSClock* clock)
+    {
+        ppsClock_ = clock;
+    }
+#endif
 
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
     /**
-     * @brief Flag to indicate that a reset had been initiated.
+     * @brief How an asynchronous command finished
      */
-    bool resetInProgress_ = false;
-};
+    enum class CommandResult : uint8_t
+    {
+        /**
+         * @brief The GPS acknowledged the command
+         */
+        ACK,
+
+        /**
+         * @brief The GPS rejected the command
+         */
+        NACK,
+
+        /**
+         * @brief The GPS answered a poll with the requested message
+         */
+        RESPONSE,
+
+        /**
+         * @brief No answer arrived before the timeout
+         */
+        TIMEOUT
+    };
+
+    /**
+     * @brief Function called when an asynchronous command finishes.
+     *
+     * @details For CommandResult::RESPONSE, \c message points to the whole UBX message (header,
+     * payload and checksum) in the driver's RX buffer, and \c length is its length.  It is only
+     * valid until the callback returns.  For the other results, \c message is nullptr.
+     */
+    using CommandCallback = Callback<void(CommandResult result, const uint8_t* message, size_t length)>;
+
+    /**
+     * @brief Send a command to the GPS without waiting for its answer.  The callback is called
+     * once the answer arrives, or the timeout expires.
+     *
+     * @details Answers are picked up as messages are processed, by update() (or by any of the
+     * blocking functions while they read from the GPS), and timeouts are checked at the end of
+     * each update().  So the callback is always called from whichever thread calls update().
+     *
+     * The callback can be called part way through a bus transfer (e.g. when the answer is clocked
+     * in over SPI while another command is being sent), so it must not send anything to the GPS:
+     * sendCommandAsync() and the other sending functions fail if called from it.  To chain a
+     * sequence of commands, note the result in the callback and send the next command after
+     * update() returns.
+     *
+     * Several commands may be outstanding at once (up to UBLOX_GNSS_MAX_PENDING_COMMANDS).  If
+     * more than one is waiting for an answer from the same message, they are answered in the order
+     * they were sent.
+     *
+     * @param messageClass class of message being sent
+     * @param messageID id of the message being sent
+     * @param data buffer containing data payload for the packet
+     * @param dataLen length of the data buffer
+     * @param waitForResponse if true, the command is a poll, and finishes with a message of the
+     *                        same class and ID.  Otherwise, it finishes with an ACK or NACK.
+     * @param callback function to call when the command finishes
+     * @param timeout how long to wait for the answer
+     *
+     * @return true if the command was sent.  If false, the callback will not be called.
+     */
+    bool sendCommandAsync(uint8_t messageClass, uint8_t messageID, const uint8_t* data,
+        uint16_t dataLen, bool waitForResponse, CommandCallback callback, us_time timeout = 1500ms);
+
+    /**
+     * @brief Poll the GPS for a message without waiting for it.  See sendCommandAsync().
+     */
+    bool pollAsync(uint8_t messageClass, uint8_t messageID, CommandCallback callback,
+        us_time timeout = 1500ms)
+    {
+        return sendCommandAsync(messageClass, messageID, nullptr, 0, true, callback, timeout);
+    }
+
+    /**
+     * @brief Get the number of asynchronous commands waiting for an answer.
+     */
+    size_t getPendingCommandCount() const
+    {
+        return numPendingCommands_;
+    }
+#endif
+
+    /**
+     * @brief Get a snapshot of the driver's statistics (frame counts, bus errors, latencies, etc.)
+     * @details Statistics are updated by whichever thread calls update() and the other functions of
+     * this class, so the snapshot should be taken from that same thread.  Frames rejected by
+     * injectRTCMFrame() are counted separately, so that it can be called from another thread.
+     */
+    DriverStatistics getStatistics() const
+    {
+        DriverStatistics stats = stats_;
+#if UBLOX_GNSS_RTCM_QUEUE_SIZE > 0
+        stats.rtcmBytesDropped += rtcmInjectBytesDropped_.load();
+        stats.rtcmFramesInvalid = rtcmInjectFramesInvalid_.load();
+#endif
+        return stats;
+    }
+
+    /**
+     * @brief Reset all statistics counters and histograms to zero.
+     */
+    void resetStatistics()
+    {
+        stats_ = DriverStatistics();
+#if UBLOX_GNSS_RTCM_QUEUE_SIZE > 0
+        rtcmInjectBytesDropped_ = 0;
+        rtcmInjectFramesInvalid_ = 0;
+#endif
+    }
+
+    /**
+     * @brief Get the current time on the monotonic host clock used to timestamp messages.
+     */
+    static us_time now()
+    {
+        return HighResClock::now().time_since_epoch();
+    }
+
+    /**
+     * @brief Get the host time at which the most recently received message arrived.
+     */
+    RxTimestamp getLastMessageTime() const
+    {
+        return rxTimestamp_;
+    }
+
+    /**
+     * @brief Get how long ago the data in one of the state variables (position, velocity, etc.)
+     * was received.  If the variable has never been populated, this is the time since boot.
+     *
+     * @param stateVariable Any of this class's state variables (anything with an \c rxTime member)
+     */
+    template <typename StateVariable> us_time getAge(const StateVariable& stateVariable) const
+    {
+        return now() - stateVariable.rxTime.lastByte;
+    }
+
+    /**
+     * @brief State Variable for position.
+     * @details This variable is populated when a new message is received.
+     * To update this variable explicitly, call waitForMessage() with a message type that contains
+     * positional information (NAV_POSLLH or NAV_PVT). Otherwise, call update periodically so that
+     * this variable is updated as new information is received. See UBloxMessages.cpp for options.
+     *
+     * Holds latitude, longitude, and height, and the time the data was received.
+     */
+    GeodeticPosition position;
+
+    /**
+     * @brief State Variable for fix quality.
+     * @details This variable is populated when a new message is received.
+     * To update this variable, call waitForMessage() with a message type that contains velocity
+     * information (NAV_SOL or NAV_PVT). Otherwise, call update periodically so that this variable
+     * is updated as new information is received. See UBloxMessages.cpp for options.
+     */
+    FixQuality fixQuality;
+
+    /**
+     * @brief State Variable for velocity
+     * @details This variable is populated when a new message is received.
+     * To update this variable, call waitForMessage() with a message type that contains velocity
+     * information (NAV_VELNED or NAV_PVT). Otherwise, call update() periodically so that this
+     * variable is updated as new information is received. See UBloxMessages.cpp for options.
+     *
+     * Holds north, east, and south velocity, and 3-D speed
+     */
+    VelocityNED velocity;
+
+#if UBLOX_GNSS_ENABLE_HIGH_PRECISION
+    /**
+     * @brief State Variable for high precision geodetic position.
+     * @details This variable is populated when a UBX-NAV-HPPOSLLH message is received.  Enable it
+     * with setMessageRate(UBX_CLASS_NAV, UBX_NAV_HPPOSLLH, 1) and call update() periodically.
+     *
+     * Holds latitude and longitude to 1e-9 degrees and height to 0.1 mm, in fixed point.
+     */
+    HighPrecisionGeodeticPosition highPrecisionPosition{};
+
+    /**
+     * @brief State Variable for high precision ECEF position.
+     * @details This variable is populated when a UBX-NAV-HPPOSECEF message is received.  Enable it
+     * with setMessageRate(UBX_CLASS_NAV, UBX_NAV_HPPOSECEF, 1) and call update() periodically.
+     */
+    HighPrecisionECEFPosition highPrecisionECEF{};
+#endif
+
+#if UBLOX_GNSS_ENABLE_COVARIANCE
+    /**
+     * @brief State Variable for position and velocity covariance.
+     * @details This variable is populated when a UBX-NAV-COV message is received, which is decoded
+     * directly into it.  Enable it with enableEpochOutput() and call update() periodically.
+     */
+    NavigationCovariance covariance{};
+
+    /**
+     * @brief State Variable for dilution of precision.
+     * @details This variable is populated when a UBX-NAV-DOP message is received.  Enable it
+     * with enableEpochOutput() and call update() periodically.
+     */
+    DilutionOfPrecision dilutionOfPrecision{};
+#endif
+
+#if UBLOX_GNSS_ENABLE_RELPOSNED
+    /**
+     * @brief State Variable for position relative to the RTK reference station or moving base.
+     * @details This variable is populated when a UBX-NAV-RELPOSNED message is received.  Enable it
+     * with setMessageRate(UBX_CLASS_NAV, UBX_NAV_RELPOSNED, 1) (or use MovingBaseLink) and call
+     * update() periodically.
+     */
+    RelativePositionNED relativePosition{};
+#endif
+
+#if UBLOX_GNSS_ENABLE_HEALTH_MONITOR
+    /**
+     * @brief State Variable for the receiver's antenna, jamming and spoofing status.
+     * @details This variable is populated when UBX-MON-RF, UBX-MON-HW, UBX-NAV-STATUS or
+     * UBX-SEC-SIG messages are received.  Enable them with enableHealthMonitoring() and call
+     * update() periodically.
+     */
+    ReceiverHealth health{};
+#endif
+
+    /**
+     * @brief State Variable for time.
+     * @details This variable is populated when a new message is received.
+     * To update this variable, call waitForMessage() with a message type that contains time
+     * information (NAV_TIMEUTC or NAV_PVT). Otherwise, call update periodically so that this
+     * variable is updated as new information is received. See UBloxMessages.cpp for options.
+     */
+    UtcTime time;
+
+    /**
+     * @brief State Variable for time pulse.
+     * @details This variable is populated when a new message is received.
+     * To update this variable, call waitForMessage() with a message type that contains timepulse
+     * information (TIM_TP). Otherwise, call update periodically so that this variable is updated as
+     * new information is received. See UBloxMessages.cpp for options.
+     */
+#if UBLOX_GNSS_ENABLE_TIMEPULSE
+    Timepulse timePulse;
+#endif
+
+    /**
+     * @brief State Variable for leap seconds.
+     * @details This variable is populated when a UBX-NAV-TIMELS message is received.  To update it,
+     * call requestLeapSecondUpdate() and then update().  Until then, it holds the leap second count
+     * as of 2017 and currentValid is false.  Use it with the conversions in UBloxTime.h.
+     */
+    LeapSecondInfo leapSeconds{ Time::DEFAULT_LEAP_SECONDS, false, 0, 0, false, {} };
+
+    /**
+     * @brief State Variable for antenna power status.
+     * @details This variable is populated when a new message is received.
+     * To update this variable, call getAntennaPowerStatus(), or enable health monitoring.
+     */
+    AntennaPowerStatus antennaPowerStatus;
+
+    /**
+     * @brief Configure the GPS with the appropriate communications and message settings for this
+     * driver. and save the configuration to NVM on the chip. After initial configuration, the
+     * settings should be reloaded automatically on power-up.
+     *
+     * However, note that on modules without flash memory, the configuration will be lost if the battery backup
+     * power is removed.
+     *
+     * The configuration is sent one command at a time (see sendConfigurationStep()), waiting for
+     * each command's ACK.  beginAsync() sends the same commands without blocking.  If a command
+     * times out, the next is held back until its late ACK has been discarded, or for another
+     * timeout, so that the late ACK can't be taken as the next command's.
+     *
+     * @return true if the configuration was successful, false otherwise
+     */
+    bool configure();
+
+protected:
+    /**
+     * Get the name of this GPS module for debug messages
+     * @return a c-string with the name of the GPS module
+     */
+    virtual const char* getName() = 0;
+
+    /**
+     * @brief Assemble a packet with the given payload with the preable, length and checksum, and
+     * send it to the chip.
+     *
+     * @param messageClass class of message being sent
+     * @param messageID id of the message being sent
+     * @param data buffer containing data payload for the packet
+     * @param dataLen length of the data buffer
+     * @param waitForACK wait until an acknowledgement message is received.
+     * @param waitForResponse wait until a response for the message is received.
+     * @param timeout how long to wait before timing out while waiting for ACK or response
+     * @return true if the command was sent successfully, false otherwise.
+     */
+    bool sendCommand(uint8_t messageClass, uint8_t messageID, const uint8_t* data, uint16_t dataLen,
+        bool waitForACK, bool waitForResponse, us_time timeout);
+
+    /**
+     * @brief Send an already-assembled UBX packet (e.g. one made by makeUBXPacket()) to the chip.
+     *
+     * @param packet complete packet, including sync chars, header and checksum
+     * @param packetLen length of the packet
+     * @param waitForACK wait until an acknowledgement message is received.
+     * @param waitForResponse wait until a response for the message is received.
+     * @param timeout how long to wait before timing out while waiting for ACK or response
+     * @return true if the command was sent successfully, false otherwise.
+     */
+    bool sendPacket(const uint8_t* packet, uint16_t packetLen, bool waitForACK, bool waitForResponse,
+        us_time timeout);
+
+    /**
+     * @brief Send a packet assembled at compile time.  See above.
+     */
+    template <size_t PacketLen>
+    bool sendPacket(const std::array<uint8_t, PacketLen>& packet, bool waitForACK,
+        bool waitForResponse, us_time timeout)
+    {
+        return sendPacket(packet.data(), PacketLen, waitForACK, waitForResponse, timeout);
+    }
+
+    /**
+     * @brief TX Buffer used to assemble outgoing commands
+     */
+    uint8_t txBuffer_[UBLOX_GNSS_TX_BUFFER_SIZE];
+
+    /**
+     * @brief RX Buffer to hold an incoming message
+     */
+    uint8_t rxBuffer[MAX_MESSAGE_LEN + 1];
+
+    /**
+     * @brief Flag to indicate the type of message currently in UBloxGPS::spiRxBuffer.
+     * @note If true, the message is NMEA, otherwise UBX.
+     */
+    bool isNMEASentence = false;
+
+    /**
+     * @brief Statistics about the link to the GPS.  Transports update the counters that
+     * apply to them.
+     */
+    DriverStatistics stats_;
+
+    /**
+     * @brief Host time at which the message in rxBuffer was received.
+     * Transports must set firstByte when they see the start of a message and lastByte when they
+     * finish receiving it (using now()).
+     */
+    RxTimestamp rxTimestamp_;
+
+    int DEBUG(const char* format, ...);
+    int DEBUG_TR(const char* format, ...);
+
+protected:
+    /**
+     * @brief enum representing possible read outcomes.
+     */
+    enum class ReadStatus : uint8_t
+    {
+        DONE = 0,
+        NO_DATA,
+        ERR
+    };
+
+    /**
+     * @brief Perform an I2C or SPI write
+     *
+     * @note waitForACK assumes that the ACK message has not been read yet. To preserve this
+     * assumption, when checking for ACK, make sure to call waitForACK immediately after the initial
+     * message has been sent. If two messages are sent consecutively, the ACK message for the first
+     * message may be received during the TX of the second message, and it will be ignored. Note
+     * that not all message types report an ACK, so waitForACK does not always need to follow a call
+     * to sendMessage.
+     *
+     * @param packet buffer of bytes to send out to the chip
+     * @param packetLen number of bytes in packet.
+     *
+     * @return true if the write was successful, false otherwise.
+     */
+    virtual bool sendMessage(const uint8_t* packet, uint16_t packetLen) = 0;
+
+    /**
+     * @brief Read EXACTLY zero or one messages from the chip.
+     *
+     * @return ReadStatus::DONE if a message was successfully read.
+     *         ReadStatus::NO_DATA if there was not a valid byte available
+     *         ReadStatus::ERR if an invalid byte or checksum was detected.
+     */
+    virtual ReadStatus readMessage() = 0;
+
+    /**
+     * @brief Implementation of update().
+     *
+     * This is a template so that classes which know their transport statically (see
+     * UBloxReceiver) can instantiate it with a direct call to their readMessage(), which the
+     * compiler can then inline.
+     *
+     * @param timeout see update()
+     * @param readFunction callable returning ReadStatus which reads zero or one messages
+     */
+    template <typename ReadFunction> int updateLoop(us_time timeout, ReadFunction readFunction);
+
+    /**
+     * @brief Tell the GPS to change the baud rate of its UART1 port.
+     * @details The GPS switches rates immediately, so this does not wait for an ACK.  Used by
+     * UBloxGPSSerial::setBaudRate().
+     *
+     * @return true if the command was sent
+     */
+    virtual bool sendBaudRateCommand(uint32_t baudRate) = 0;
+
+    /**
+     * @brief Tell the GPS to change its measurement period.  One navigation solution is computed
+     * per measurement.  Used by setNavigationRate().
+     *
+     * @return true if the setting was acknowledged by the GPS
+     */
+    virtual bool sendMeasurementPeriod(uint16_t periodMs) = 0;
+
+    /**
+     * @brief Get the number of commands which make up configure().
+     */
+    virtual size_t getNumConfigurationSteps() const = 0;
+
+    /**
+     * @brief Whether the configuration being sent should also be saved to the GPS's
+     * non-volatile memory.  False while the watchdog reconfigures the GPS, so that each recovery
+     * doesn't wear the flash.  Implementations of getNumConfigurationSteps() and
+     * sendConfigurationStep() should write only the RAM layer, and skip any save command, if so.
+     */
+    bool isSavingConfiguration() const { return saveConfiguration_; }
+
+    /**
+     * @brief Whether setMessageRate() is being called by setNavigationRate() to scale a rate.
+     * Scaled rates change with the navigation rate, so implementations of setMessageRate()
+     * should write only the RAM layer if so.
+     */
+    bool isScalingMessageRates() const { return scalingMessageRates_; }
+
+    /**
+     * @brief Send one of the commands which make up configure(), without waiting for its ACK.
+     * Each step must be a single command which the GPS acknowledges.
+     *
+     * @param step index of the command, from 0 to getNumConfigurationSteps() - 1
+     *
+     * @return true if the command was sent
+     */
+    virtual bool sendConfigurationStep(size_t step) = 0;
+
+    /**
+     * @brief Record the output rate of a periodic message, for bandwidth budgeting.  Called by
+     * implementations of setMessageRate() once the GPS has accepted the rate.
+     */
+    void recordMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate);
+
+    /**
+     * @brief Update state variable from information contained in the message in rxBuffer
+     */
+    void processMessage();
+
+    /**
+     * @brief Verify the validity of the packet in rxBuffer
+     * @returns true if the packet is valid, false otherwise.
+     */
+    bool verifyChecksum(uint32_t messageLength);
+
+    /**
+     * @brief Length of message currently in currMessageLength
+     */
+    size_t currMessageLength_ = 0;
+
+    /**
+     * @brief Feed bytes received from the GPS into the frame parser.
+     *
+     * @details Transports which receive a stream of bytes (rather than whole messages) use this to
+     * find UBX frames and NMEA sentences.  Partial frames are kept between calls, so bytes can be
+     * passed in chunks of any size.  Parsing stops at the end of the first complete frame, which is
+     * then checked and (for UBX) passed to processMessage().
+     *
+     * To avoid copying, transports can read directly into rxWritePointer() (at most
+     * rxBytesWanted() bytes) and pass that pointer back in as \c data.
+     *
+     * @param data received bytes
+     * @param len number of bytes in data
+     * @param[out] consumed number of bytes of data which were used.  If less than len, the rest
+     *             should be passed in again on the next call.
+     *
+     * @return ReadStatus::DONE if a valid frame was completed
+     *         ReadStatus::NO_DATA if all bytes were consumed without completing a frame
+     *         ReadStatus::ERR if a frame was completed but had to be dropped
+     */
+    ReadStatus receiveBytes(const uint8_t* data, size_t len, size_t& consumed);
+
+    /**
+     * @brief Get the location in rxBuffer where the next received byte belongs.
+     */
+    uint8_t* rxWritePointer();
+
+    /**
+     * @brief Get the number of bytes that can be read into rxWritePointer() without going past
+     * the end of the current frame.  This is 1 if the frame's length is not known yet.
+     */
+    size_t rxBytesWanted() const;
+
+    /**
+     * @brief Discard any partially received frame, e.g. after the link has been disrupted.
+     */
+    void resetFramer();
+
+    /**
+     * @brief Whether the frame parser is part way through a frame.
+     */
+    bool rxFrameInProgress() const
+    {
+        return rxFrameType_ != FrameType::NONE;
+    }
+
+    /**
+     * @brief Get the number of bytes which can still be transferred in this updateWithBudget()
+     * call.  Transports must size each transfer to fit in this, and return ReadStatus::NO_DATA
+     * when it is 0.  Outside updateWithBudget(), this is unlimited.
+     */
+    size_t transferBudgetRemaining() const;
+
+    /**
+     * @brief Take bytes which have been transferred out of the budget of updateWithBudget().
+     */
+    void spendTransferBudget(size_t bytes)
+    {
+        if (transferBudgetActive_)
+        {
+            transferBudget_ -= std::min(bytes, transferBudget_);
+        }
+    }
+
+    /**
+     * @brief Wait until the transport may have new data to read, or the timeout expires.
+     * @details Used while waiting for messages.  Transports which can be notified of incoming data
+     * override this; the default just sleeps for 1ms (or the timeout, if shorter).
+     */
+    virtual void waitForData(us_time timeout);
+
+private:
+    /**
+     * @brief Wait for an ACK for the given message class and ID.
+     *
+     * @details This function assumes that the ACK message has not been read yet. To preserve this
+     * assumption, make sure to always call waitForACK immediately after the initial message has
+     * been sent. If two messages are sent consecutively, the ACK message for the first message may
+     * be received during the TX of the second message, and it will be ignored.
+     *
+     * @param sentMessageClass Class of the message for which we are expecting an ACK.
+     * @param sentMessageID ID of the message which which we are expecting an ACK
+     * @param timeout How long to wait for the message an ACK, before quitting and returning false.
+     * @return true if a correct ACK was received, false otherwise.
+     */
+    bool waitForACK(uint8_t sentMessageClass, uint8_t sentMessageID, us_time timeout = 1500ms);
+
+    /**
+     * Wait for a specific message to be received.
+     * If we get another message that is not the one we're looking for during this time, then we
+     * process that message using processMessage()
+     * If the message is not received before the timeout, returns false.
+     *
+     * @param messageClass Class of the message to wait for
+     * @param messageID ID of the of the message to wait for. If msgID doesn't matter, put 0xFF
+     * @param timeout How long to wait for the message.
+     * @return
+     */
+    bool waitForMessage(uint8_t messageClass, uint8_t messageID = 0xFF, us_time timeout = 1500ms);
+
+    /**
+     * @brief Calculate the checksum for the given packet. The packet should include the sync bytes
+     * and rest of header.
+     *
+     * @param[in] packet pointer to packet
+     * @param[in] length of packet, including header and checksum bytes. I.e. data length + 8
+     * @param[out] The chka portion of the checksum (first byte)
+     * @param[out] The chkb portion of the checksum (second byte)
+     * @returns true if the calculation was successful, otherwise false.
+     */
+    bool calcChecksum(
+        const uint8_t* packet, uint32_t packetLen, uint8_t& chka, uint8_t& chkb) const;
+
+    /**
+     * @brief Outcome of advancing a multi-step operation
+     */
+    enum class StepStatus : uint8_t
+    {
+        IN_PROGRESS,
+        DONE,
+        FAILED
+    };
+
+    /**
+     * @brief Send the first configuration step.  Continue with advanceConfiguration().
+     *
+     * @param save whether the configuration should also be saved to the GPS's non-volatile
+     *        memory.  The watchdog passes false, so that recovery only writes RAM.
+     */
+    StepStatus startConfiguration(bool save = true);
+
+    /**
+     * @brief Check whether the last configuration step has been acknowledged, and if so, send
+     * the next one.  Does not read from the GPS; the ACK is picked up by processMessage().
+     */
+    StepStatus advanceConfiguration();
+
+    /**
+     * @brief Send the configuration step in configStep_, or the first one after it which can be
+     * sent.  Returns DONE or FAILED once there are no steps left.
+     */
+    StepStatus sendCurrentConfigurationStep();
+
+    /**
+     * @brief Read and process the messages waiting from the GPS, up to a limit, without blocking.
+     */
+    void readAvailableMessages();
+
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+    /**
+     * @brief Finish the oldest pending command waiting for the given answer, if any.
+     *
+     * @param messageClass class of the command, or of the message polled for
+     * @param messageID ID of the command, or of the message polled for
+     * @param isResponse true if the message in rxBuffer is the message polled for, false if it is
+     *                   an ACK or NACK
+     */
+    void completePendingCommand(uint8_t messageClass, uint8_t messageID, bool isResponse);
+
+    /**
+     * @brief Whether a pending command with the given class and ID, sent before \c sequence, is
+     * waiting for an ACK or NACK.
+     */
+    bool hasPendingCommandBefore(uint8_t messageClass, uint8_t messageID, uint32_t sequence) const;
+
+    /**
+     * @brief Finish any pending commands whose timeouts have expired.
+     */
+    void expirePendingCommands();
+
+    /**
+     * @brief A command sent by sendCommandAsync() which is waiting for its answer
+     */
+    struct PendingCommand
+    {
+        CommandCallback callback;
+        us_time sentTime;
+        us_time timeout;
+
+        /// Order in which the command was sent
+        uint32_t sequence;
+
+        uint8_t messageClass;
+        uint8_t messageID;
+        bool waitForResponse;
+        bool active;
+    };
+
+    PendingCommand pendingCommands_[UBLOX_GNSS_MAX_PENDING_COMMANDS] = {};
+
+    size_t numPendingCommands_ = 0;
+
+    uint32_t nextCommandSequence_ = 0;
+
+    /**
+     * @brief Call a CommandCallback, with sending blocked while it runs.
+     */
+    void callCommandCallback(
+        const CommandCallback& callback, CommandResult result, const uint8_t* message, size_t length);
+#endif
+
+#if UBLOX_GNSS_ENABLE_WATCHDOG
+    /**
+     * @brief Check the stream for faults and advance any recovery in progress.  Called at the end
+     * of each update().
+     */
+    void serviceWatchdog();
+
+    /**
+     * @brief Start the given recovery stage.
+     */
+    void enterRecoveryStage(RecoveryStage stage);
+
+    /**
+     * @brief Start watching the stream afresh from the current counters, e.g. after a stage has
+     * been started.
+     */
+    void restartStreamChecks();
+
+    /**
+     * @brief Total of the error counters the watchdog watches for error bursts.
+     */
+    uint32_t countStreamErrors() const;
+#endif
+
+    /**
+     * @brief Update the epoch latency statistic using the iTOW of the NAV message in rxBuffer.
+     * @details Unknown NAV messages are assumed to start with the iTOW.
+     */
+    void recordEpochLatency();
+
+    /**
+     * @brief Check and process the UBX frame which the frame parser just completed.
+     */
+    ReadStatus finishUBXFrame();
+
+    /**
+     * @brief Check the NMEA sentence which the frame parser just completed.
+     */
+    ReadStatus finishNMEASentence();
+
+    /**
+     * @brief Check the RTCM3 frame which the frame parser just completed, and pass it to the RTCM
+     * output callback.
+     */
+    ReadStatus finishRTCMFrame();
+
+    /**
+     * @brief Get the header length of the type of frame being received.
+     */
+    size_t rxHeaderLength() const;
+
+    /**
+     * @brief Bandwidth (bytes/s) used by the recorded periodic messages at the given navigation
+     * rate, if every message except NAV-PVT is slowed down from its base rate by \c scale.
+     */
+    uint32_t requiredBandwidth(uint16_t rateHz, uint8_t scale) const;
+
+    /**
+     * @brief Send the rate of every recorded message except NAV-PVT which should change to slow
+     * it down from its base rate by \c scale.
+     *
+     * @param slower true to send only the rates which get slower, false for those which get faster
+     */
+    bool applyRateScale(uint8_t scale, bool slower);
+
+    /**
+     * @brief Output rate of a periodic message
+     */
+    struct MessageRate
+    {
+        uint8_t messageClass;
+        uint8_t messageID;
+
+        /// Output once every this many epochs, as set through setMessageRate()
+        uint8_t baseRate;
+
+        /// Output once every this many epochs, as last sent to the GPS.  This is baseRate slowed
+        /// down by setNavigationRate() with RatePolicy::SCALE.
+        uint8_t rate;
+    };
+
+    /**
+     * @brief Periodic messages enabled through setMessageRate()
+     */
+    MessageRate messageRates_[UBLOX_GNSS_MAX_PERIODIC_MESSAGES];
+
+    /**
+     * @brief Number of entries used in messageRates_
+     */
+    size_t numMessageRates_ = 0;
+
+    /**
+     * @brief Whether setNavigationRate() is sending scaled rates, which recordMessageRate()
+     * should not take as new base rates
+     */
+    bool scalingMessageRates_ = false;
+
+    /**
+     * @brief Current navigation rate (Hz)
+     */
+    uint16_t navigationRateHz_ = 1;
+
+    /**
+     * @brief Class and ID of the last command sent to the GPS
+     */
+    uint8_t lastCommandClass_ = 0;
+    uint8_t lastCommandID_ = 0;
+
+    /**
+     * @brief Class and ID of the configuration step waiting for its ACK
+     */
+    uint8_t configCommandClass_ = 0;
+    uint8_t configCommandID_ = 0;
+
+    /**
+     * @brief Whether an ACK or NACK matching configCommandClass_ and configCommandID_ belongs to
+     * the configuration step.  Set when a step is sent, and cleared once its answer arrives or it
+     * has been given up on.
+     */
+    bool configAckExpected_ = false;
+
+    /**
+     * @brief Whether the configuration step has timed out, and the next one is being held back
+     * until its late answer arrives (and is discarded) or a second timeout passes.  Every Gen9
+     * step is a CFG-VALSET, and an ACK only names the class and ID it answers, so otherwise the
+     * late answer would be taken as the next step's.
+     */
+    bool configAckOverdue_ = false;
+
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+    /**
+     * @brief Order in which the configuration step was sent, relative to the pending commands.
+     * The GPS answers commands in order, so an answer goes to the step only if no pending command
+     * with the same class and ID was sent before it.
+     */
+    uint32_t configCommandSequence_ = 0;
+#endif
+
+    /**
+     * @brief Whether the configuration step has been ACKed or NACKed
+     */
+    enum class AckState : uint8_t
+    {
+        NONE,
+        ACK,
+        NACK
+    };
+    AckState ackState_ = AckState::NONE;
+
+    /**
+     * @brief Host time at which the last command was sent
+     */
+    us_time commandSentTime_ = 0us;
+
+    /**
+     * @brief Whether a MON-VER message has been received since the last version poll
+     */
+    bool versionReceived_ = false;
+
+    /**
+     * @brief Configuration step in progress
+     */
+    size_t configStep_ = 0;
+
+    /**
+     * @brief Whether any step of the configuration in progress has failed
+     */
+    bool configFailed_ = false;
+
+    /**
+     * @brief Whether the configuration being sent is also saved to non-volatile memory
+     */
+    bool saveConfiguration_ = true;
+
+    /**
+     * @brief State of the initialization started by beginAsync()
+     */
+    BeginState beginState_ = BeginState::IDLE;
+
+    /**
+     * @brief Whether the initialization started by beginAsync() should configure the GPS
+     */
+    bool beginShouldConfigure_ = true;
+
+    /**
+     * @brief Whether a user callback (command, epoch or RTCM3 output) is running.  Callbacks can
+     * run part way through a bus transfer, so nothing may be sent while this is set.
+     */
+    bool inCallback_ = false;
+
+    /**
+     * @brief Function to call at the end of each navigation epoch
+     */
+    Callback<void(uint32_t)> epochCallback_;
+
+    /**
+     * @brief Function to pass received RTCM3 frames to
+     */
+    Callback<void(const uint8_t*, size_t)> rtcmOutputCallback_;
+
+    /**
+     * @brief Type of frame being received by the frame parser
+     */
+    enum class FrameType : uint8_t
+    {
+        NONE, ///< Looking for the start of a frame
+        UBX,
+        NMEA,
+        RTCM
+    };
+
+    /**
+     * @brief Type of the frame currently being received
+     */
+    FrameType rxFrameType_ = FrameType::NONE;
+
+    /**
+     * @brief Number of bytes of the current frame received so far
+     */
+    size_t rxIndex_ = 0;
+
+    /**
+     * @brief Total length of the current frame, or 0 if it is not known yet
+     */
+    size_t rxFrameLength_ = 0;
+
+    /**
+     * @brief iTOW (ms) of the last navigation epoch seen
+     */
+    uint32_t lastEpochITOW_ = 0;
+
+    /**
+     * @brief Lowest (host time - iTOW) offset seen (us), which serves as the zero point for
+     * epoch latency measurements.
+     */
+    int64_t epochOffsetBaseline_ = 0;
+
+    /**
+     * @brief Host time of the last navigation epoch seen
+     */
+    us_time lastEpochTime_ = 0us;
+
+    /**
+     * @brief Whether epochOffsetBaseline_ has been initialized
+     */
+    bool haveEpochBaseline_ = false;
+
+#if UBLOX_GNSS_TIMEMARK_QUEUE_SIZE > 0
+    /**
+     * @brief Add a time mark event from the message in rxBuffer to the queue
+     */
+    void queueTimemarkEvent();
+
+    /**
+     * @brief Queue of received time mark events
+     */
+    CircularBuffer<TimemarkEvent, UBLOX_GNSS_TIMEMARK_QUEUE_SIZE> timemarkQueue_;
+
+    /**
+     * @brief Rising edge count of the last time mark event
+     */
+    uint16_t lastTimemarkCount_ = 0;
+
+    /**
+     * @brief Whether lastTimemarkCount_ is valid
+     */
+    bool haveTimemarkCount_ = false;
+#endif
+
+#if UBLOX_GNSS_ENABLE_WATCHDOG
+    WatchdogConfig watchdogConfig_;
+
+    bool watchdogEnabled_ = false;
+
+    RecoveryStage recoveryStage_ = RecoveryStage::IDLE;
+
+    /**
+     * @brief Frame count when the watchdog last checked the stream
+     */
+    uint32_t watchdogFrames_ = 0;
+
+    /**
+     * @brief Host time at which the watchdog last saw a new frame
+     */
+    us_time lastFrameTime_ = 0us;
+
+    /**
+     * @brief Start time and error count at the start of the current error window
+     */
+    us_time errorWindowStart_ = 0us;
+    uint32_t errorWindowBase_ = 0;
+
+    /**
+     * @brief Host time at which the stream started being watched in the current recovery stage
+     */
+    us_time stageStartTime_ = 0us;
+
+    /**
+     * @brief Frame and error counts when the stream started being watched in the current stage
+     */
+    uint32_t stageFramesBase_ = 0;
+    uint32_t stageErrorsBase_ = 0;
+
+    /**
+     * @brief Whether a gap in the epochs longer than maxMissedEpochs has been seen
+     */
+    bool epochGapDetected_ = false;
+
+    /**
+     * @brief Whether to ignore the gap before the next epoch, which follows a recovery stage
+     */
+    bool ignoreEpochGap_ = false;
+
+    /**
+     * @brief Whether the configuration commands are being sent in the RECONFIGURE stage
+     */
+    bool watchdogConfiguring_ = false;
+
+    /**
+     * @brief Whether the stream is being watched in the current stage (as opposed to waiting for
+     * the receiver to boot or answer)
+     */
+    bool stageWatching_ = false;
+#endif
+
+    /**
+     * @brief Extrapolator to feed navigation solutions into, if any
+     */
+    PositionExtrapolator* extrapolator_ = nullptr;
+
+#if UBLOX_GNSS_ENABLE_TIMEPULSE
+    /**
+     * @brief PPS clock to feed timepulse messages into, if any
+     */
+    PPSClock* ppsClock_ = nullptr;
+#endif
+
+#if UBLOX_GNSS_RTCM_QUEUE_SIZE > 0
+    /**
+     * @brief Send queued RTCM3 frames to the GPS, as many as fit in the transfer budget.  Frames
+     * are always sent whole.
+     */
+    void flushRTCMQueue();
+
+    /**
+     * @brief Queue of RTCM3 data waiting to be sent to the GPS.  Only whole frames are added.
+     */
+    CircularBuffer<uint8_t, UBLOX_GNSS_RTCM_QUEUE_SIZE> rtcmQueue_;
+
+    /// Header of the next frame to send, once it has been taken off the queue
+    uint8_t rtcmNextHeader_[RTCM3_HEADER_LENGTH];
+
+    /// Length of the next frame to send, or 0 if its header is still in the queue
+    size_t rtcmNextFrameLength_ = 0;
+
+    /// Bytes and frames rejected by injectRTCMFrame().  Only written by the thread injecting
+    /// corrections, and added to stats_ by getStatistics().
+    std::atomic<uint32_t> rtcmInjectBytesDropped_{0};
+    std::atomic<uint32_t> rtcmInjectFramesInvalid_{0};
+#endif
+
+    /**
+     * @brief Hardware Reset pin
+     */
+    DigitalOut reset_;
+
+    /**
+     * @brief Timer to keep track of time since reset.
+     */
+    Timer resetTimer_;
+
+    /**
+     * @brief Flag to indicate that a reset had been initiated.
+     */
+    bool resetInProgress_ = false;
+
+    /// Whether updateWithBudget() is running
+    bool transferBudgetActive_ = false;
+
+    /// Bytes left in the budget of updateWithBudget()
+    size_t transferBudget_ = 0;
+
+    /// Time at which updateWithBudget() must stop reading
+    us_time transferDeadline_ = 0us;
+};
+
+template <typename ReadFunction> int UBloxGPS::updateLoop(us_time timeout, ReadFunction readFunction)
+{
+    const us_time startTime = now();
+    int packetsRead = 0;
+    bool done = false;
+
+    while (!done && (timeout == 0us || now() - startTime <= timeout))
+    {
+#if UBLOX_GNSS_RTCM_QUEUE_SIZE > 0
+        // Keep the GPS's input fed with corrections between reads
+        if (!rtcmQueue_.empty() || rtcmNextFrameLength_ > 0)
+        {
+            flushRTCMQueue();
+        }
+#endif
+
+        switch (readFunction())
+        {
+            case ReadStatus::DONE:
+                packetsRead++;
+                done = timeout == 0us;
+                break;
+
+            case ReadStatus::ERR:
+                done = true;
+                break;
+
+            case ReadStatus::NO_DATA:
+                // if we still haven't read a packet,
+                // try again (if timeout allows). Otherwise, we have emptied the message
+                // queue, so return the number of packets we have read.
+                done = packetsRead != 0 || timeout == 0us || transferBudgetActive_;
+                if (!done)
+                {
+                    waitForData(timeout - (now() - startTime));
+                }
+                break;
+        }
+    }
+
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+    if (numPendingCommands_ > 0)
+    {
+        expirePendingCommands();
+    }
+#endif
+
+#if UBLOX_GNSS_ENABLE_WATCHDOG
+    if (watchdogEnabled_)
+    {
+        serviceWatchdog();
+    }
+#endif
+
+    stats_.updateDuration.record((now() - startTime).count());
+    return packetsRead;
+}
 
 }
 
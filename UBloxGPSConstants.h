@@ -13,10 +13,113 @@
 // ZED-F9P measured to need at least 675ms after reset before it can accept commands :/
 #define BOOT_TIME 675ms
 
-// Max size of command that can be sent to the chip. This value is chosen somewhat
+// The options below set the RAM used by each driver instance and which optional message
+// decoders are compiled in.  They change the layout of the driver classes, so they must be the
+// same in every file that includes the driver -- set them through the CMake cache variables of
+// the same name rather than defining them in individual source files.
+
+// Max size of message payload that can be received from the chip. This value is chosen somewhat
 // empirically: it doesn't seem like any of the messages in the datasheet will end up being
-// longer than 500 bytes.
-#define MAX_MESSAGE_LEN 500
+// longer than 500 bytes.  NAV-SAT is 8 + 12 * numSvs bytes long, so this may be reduced if
+// getSatelliteInfo() is not used, in which case larger messages are dropped.  RTCM3 frames from
+// the receiver can be up to 1029 bytes: MSM7 messages with many signals tracked (e.g. 1077 on a
+// dual band receiver) can exceed 500, so raise this if they are output.  RTCM3 frames which are
+// dropped are counted in the rtcmFramesTooLong statistic.
+#ifndef UBLOX_GNSS_RX_BUFFER_SIZE
+#define UBLOX_GNSS_RX_BUFFER_SIZE 500
+#endif
+#define MAX_MESSAGE_LEN UBLOX_GNSS_RX_BUFFER_SIZE
+
+// Size of the buffer that commands are assembled in, including the UBX header and checksum.
+// The largest command the driver itself sends is CFG-TP5 (40 bytes).
+#ifndef UBLOX_GNSS_TX_BUFFER_SIZE
+#define UBLOX_GNSS_TX_BUFFER_SIZE 64
+#endif
+
+// Number of UBX-TIM-TM2 time mark events which can be queued before the oldest is overwritten.
+// Set to 0 to remove the time mark decoder and queue.
+#ifndef UBLOX_GNSS_TIMEMARK_QUEUE_SIZE
+#define UBLOX_GNSS_TIMEMARK_QUEUE_SIZE 16
+#endif
+
+// Size of the queue (in bytes) of RTCM3 correction data waiting to be sent to the GPS.  The
+// default holds a typical epoch of MSM4 corrections for four constellations.  Frames are only
+// queued whole, so this must be at least 1029 bytes (the max frame size) to accept every frame.
+// Set to 0 to remove correction injection.
+#ifndef UBLOX_GNSS_RTCM_QUEUE_SIZE
+#define UBLOX_GNSS_RTCM_QUEUE_SIZE 2048
+#endif
+
+// If 0, the latency histograms in DriverStatistics are removed, leaving only the counters.
+#ifndef UBLOX_GNSS_ENABLE_HISTOGRAMS
+#define UBLOX_GNSS_ENABLE_HISTOGRAMS 1
+#endif
+
+// Number of UBX message types whose frames are counted individually in DriverStatistics.
+#ifndef UBLOX_GNSS_MAX_FRAME_TYPES
+#define UBLOX_GNSS_MAX_FRAME_TYPES 16
+#endif
+
+// If 0, the UBX-TIM-TP decoder and the timePulse state variable are removed.  PPSClock needs
+// this to be enabled.
+#ifndef UBLOX_GNSS_ENABLE_TIMEPULSE
+#define UBLOX_GNSS_ENABLE_TIMEPULSE 1
+#endif
+
+// If 0, the decoders for NAV-POSLLH, NAV-VELNED, NAV-SOL and NAV-TIMEUTC are removed.  Their
+// contents are all also in NAV-PVT, which is what configure() enables.
+#ifndef UBLOX_GNSS_ENABLE_LEGACY_NAV
+#define UBLOX_GNSS_ENABLE_LEGACY_NAV 1
+#endif
+
+// If 0, the NAV-HPPOSLLH and NAV-HPPOSECEF decoders and their state variables are removed.
+// These messages are only output by high precision receivers (e.g. the ZED-F9P).
+#ifndef UBLOX_GNSS_ENABLE_HIGH_PRECISION
+#define UBLOX_GNSS_ENABLE_HIGH_PRECISION 1
+#endif
+
+// If 0, the NAV-RELPOSNED decoder and its state variable are removed.  It is output by RTK
+// rovers (e.g. the ZED-F9P), and gives the heading between two antennas in a moving base setup.
+#ifndef UBLOX_GNSS_ENABLE_RELPOSNED
+#define UBLOX_GNSS_ENABLE_RELPOSNED 1
+#endif
+
+// If 0, the NAV-COV and NAV-DOP decoders and their state variables are removed.
+#ifndef UBLOX_GNSS_ENABLE_COVARIANCE
+#define UBLOX_GNSS_ENABLE_COVARIANCE 1
+#endif
+
+// If 0, the MON-RF, MON-HW, NAV-STATUS and SEC-SIG decoders and the health snapshot are removed.
+#ifndef UBLOX_GNSS_ENABLE_HEALTH_MONITOR
+#define UBLOX_GNSS_ENABLE_HEALTH_MONITOR 1
+#endif
+
+// If 0, the stream watchdog and its automatic recovery are removed.
+#ifndef UBLOX_GNSS_ENABLE_WATCHDOG
+#define UBLOX_GNSS_ENABLE_WATCHDOG 1
+#endif
+
+// Number of periodic UBX messages whose output rates are tracked for bus bandwidth budgeting.
+#ifndef UBLOX_GNSS_MAX_PERIODIC_MESSAGES
+#define UBLOX_GNSS_MAX_PERIODIC_MESSAGES 12
+#endif
+
+// Number of commands sent with sendCommandAsync() which can be waiting for their ACK or response
+// at once.  Set to 0 to remove the asynchronous command API.
+#ifndef UBLOX_GNSS_MAX_PENDING_COMMANDS
+#define UBLOX_GNSS_MAX_PENDING_COMMANDS 4
+#endif
+
+// Number of receivers which one UBloxGPSManager can schedule reads for.
+#ifndef UBLOX_GNSS_MAX_MANAGED_RECEIVERS
+#define UBLOX_GNSS_MAX_MANAGED_RECEIVERS 4
+#endif
+
+// Percentage of the raw bus bandwidth that periodic messages may use.  The rest is left for
+// polling overhead (I2C length reads, SPI idle bytes), commands and correction data.
+#ifndef UBLOX_GNSS_BUS_BUDGET_PERCENT
+#define UBLOX_GNSS_BUS_BUDGET_PERCENT 50
+#endif
 
 // Characters at the start of every UBX message
 #define UBX_SYNC_CHAR_1 0xB5
@@ -29,6 +132,11 @@
 #define UBX_DATA_OFFSET 6          // start byte of message data
 #define UBX_HEADER_FOOTER_LENGTH 8 // length of message header and footer
 
+// RTCM3 framing
+#define RTCM3_PREAMBLE 0xD3
+#define RTCM3_HEADER_LENGTH 3 // preamble, then 6 reserved bits and 10 bit payload length
+#define RTCM3_CRC_LENGTH 3
+
 // class ACK
 #define UBX_CLASS_ACK 0x5
 #define UBX_ACK_NACK 0x0
@@ -51,9 +159,17 @@
 #define UBX_NAV_POSLLH 0x2 // LLH stands for Latitude-Longitude-Height
 #define UBX_NAV_SOL 0x06
 #define UBX_NAV_TIMEUTC 0x21
+#define UBX_NAV_TIMELS 0x26
 #define UBX_NAV_SAT 0x35
 #define UBX_NAV_VELNED 0x12
 #define UBX_NAV_PVT 0x7
+#define UBX_NAV_HPPOSECEF 0x13
+#define UBX_NAV_HPPOSLLH 0x14
+#define UBX_NAV_RELPOSNED 0x3C
+#define UBX_NAV_DOP 0x04
+#define UBX_NAV_COV 0x36
+#define UBX_NAV_EOE 0x61
+#define UBX_NAV_STATUS 0x03
 
 // class MON
 #define UBX_CLASS_MON 0xA
@@ -64,11 +180,27 @@
 // class TIM
 #define UBX_CLASS_TIM 0x0D
 #define UBX_TIM_TP 0x01
+#define UBX_TIM_TM2 0x03
 
 // class RXM
 #define UBX_CLASS_RXM 0x02
 #define UBX_RXM_RAWX 0x15
 
+// class SEC
+#define UBX_CLASS_SEC 0x27
+#define UBX_SEC_SIG 0x09
+
+// class RTCM3 (the class and IDs which UBX-CFG-MSG uses for RTCM3 output messages)
+#define UBX_CLASS_RTCM3 0xF5
+#define UBX_RTCM3_1005 0x05
+#define UBX_RTCM3_1074 0x4A
+#define UBX_RTCM3_1077 0x4D
+#define UBX_RTCM3_1084 0x54
+#define UBX_RTCM3_1094 0x5E
+#define UBX_RTCM3_1124 0x7C
+#define UBX_RTCM3_1230 0xE6
+#define UBX_RTCM3_4072_0 0xFE
+
 #define UBX_MESSAGE_START_CHAR 0xB5
 #define UBX_MESSAGE_START_CHAR2 0x62
 #define NMEA_MESSAGE_START_CHAR '$'
@@ -89,15 +221,53 @@
 #define CFG_MSGOUT_UBX_NAV_PVT 0x20910006
 #define CFG_MSGOUT_UBX_NAV_SAT 0x20910015
 #define CFG_MSGOUT_UBX_NAV_VELNED 0x20910042
+#define CFG_MSGOUT_UBX_NAV_TIMELS 0x20910060
+#define CFG_MSGOUT_UBX_NAV_HPPOSLLH 0x20910033
+#define CFG_MSGOUT_UBX_NAV_HPPOSECEF 0x2091002e
+#define CFG_MSGOUT_UBX_NAV_RELPOSNED 0x2091008d
+#define CFG_MSGOUT_UBX_NAV_COV 0x20910083
+#define CFG_MSGOUT_UBX_NAV_DOP 0x20910038
+#define CFG_MSGOUT_UBX_NAV_EOE 0x2091015f
+#define CFG_MSGOUT_UBX_NAV_STATUS 0x2091001a
+#define CFG_MSGOUT_UBX_MON_RF 0x20910359
+#define CFG_MSGOUT_UBX_MON_HW 0x209101b4
+#define CFG_MSGOUT_UBX_SEC_SIG 0x20910634
 
 #define CFG_MSGOUT_UBX_RXM_RAWX 0x209102a4
 
+#define CFG_MSGOUT_UBX_TIM_TM2 0x20910178
+
+#define CFG_MSGOUT_RTCM_3X_TYPE1005 0x209102bd
+#define CFG_MSGOUT_RTCM_3X_TYPE1074 0x2091035e
+#define CFG_MSGOUT_RTCM_3X_TYPE1077 0x209102cc
+#define CFG_MSGOUT_RTCM_3X_TYPE1084 0x20910363
+#define CFG_MSGOUT_RTCM_3X_TYPE1094 0x20910368
+#define CFG_MSGOUT_RTCM_3X_TYPE1124 0x2091036d
+#define CFG_MSGOUT_RTCM_3X_TYPE1230 0x20910303
+#define CFG_MSGOUT_RTCM_3X_TYPE4072_0 0x209102fe
+
 #define CFG_I2CINPROT_NMEA 0x10710002
 #define CFG_I2CINPROT_UBX 0x10710001
 
 #define CFG_I2COUTPROT_UBX 0x10720001
 #define CFG_I2COUTPROT_NMEA 0x10720002
 
+#define CFG_UART1INPROT_UBX 0x10730001
+#define CFG_UART1INPROT_NMEA 0x10730002
+
+#define CFG_UART1OUTPROT_UBX 0x10740001
+#define CFG_UART1OUTPROT_NMEA 0x10740002
+
+#define CFG_UART1_BAUDRATE 0x40520001
+
+#define CFG_I2CINPROT_RTCM3X 0x10710004
+#define CFG_UART1INPROT_RTCM3X 0x10730004
+#define CFG_SPIINPROT_RTCM3X 0x10790004
+
+#define CFG_I2COUTPROT_RTCM3X 0x10720004
+#define CFG_UART1OUTPROT_RTCM3X 0x10740004
+#define CFG_SPIOUTPROT_RTCM3X 0x107a0004
+
 #define CFG_SPIINPROT_UBX 0x10790001
 #define CFG_SPIINPROT_NMEA 0x10790002
 
@@ -108,4 +278,8 @@
 
 #define CFG_NAVSPG_DYNMODEL 0x20110021
 
+// section RATE (navigation solution rate)
+#define CFG_RATE_MEAS 0x30210001 // measurement period, ms
+#define CFG_RATE_NAV 0x30210002  // measurements per navigation solution
+
 #endif // HAMSTER_UBLOXGPSCONSTANTS_H
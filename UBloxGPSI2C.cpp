@@ -1,18 +1,25 @@
 #include "UBloxGPSI2C.h"
+#include "internal/BusLock.h"
 
 namespace UBlox
 {
-UBloxGPSI2C::UBloxGPSI2C(I2C & i2c, PinName user_RSTpin, uint8_t i2cAddress)
+UBloxGPSI2C::UBloxGPSI2C(I2C & i2c, PinName user_RSTpin, uint8_t i2cAddress, int i2cFrequency)
     : UBloxGPS(user_RSTpin)
     , i2cAddress_(i2cAddress)
     , i2cPort_(i2c)
+    , i2cFrequency_(i2cFrequency)
 {
 }
 
-bool UBloxGPSI2C::sendMessage(uint8_t* packet, uint16_t packetLen)
+bool UBloxGPSI2C::sendMessage(const uint8_t* packet, uint16_t packetLen)
 {
-    // to indicate an i2c write, shift the 7 bit address up 1 bit and keep bit 0 as a 0
-    I2C::Result result = i2cPort_.write(i2cAddress_ << 1, reinterpret_cast<const char *>(packet), packetLen);
+    I2C::Result result;
+    {
+        BusLock<I2C> lock(i2cPort_, stats_);
+
+        // to indicate an i2c write, shift the 7 bit address up 1 bit and keep bit 0 as a 0
+        result = i2cPort_.write(i2cAddress_ << 1, reinterpret_cast<const char *>(packet), packetLen);
+    }
 
     if(result == I2C::ACK)
     {
@@ -22,82 +29,87 @@ bool UBloxGPSI2C::sendMessage(uint8_t* packet, uint16_t packetLen)
     else
     {
         printf("%s I2C write failed!\r\n", getName());
+        stats_.busErrors++;
         return false;
     }
 }
 
 UBloxGPS::ReadStatus UBloxGPSI2C::readMessage()
 {
-    const size_t ubxHeaderLen = 6;
-	const size_t ubxChecksumLen = 2;
-
-	// First check how many bytes are in the buffer
-	int32_t bufLen = readLen();
-	if(bufLen < 0)
-	{
-		DEBUG("Didn't receive ack from %s reading len\r\n", getName());
-		return ReadStatus::ERR;
-	}
-
-	if(static_cast<uint32_t>(bufLen) < ubxHeaderLen)
-	{
-		// Not a full header in the buffer
-		return ReadStatus::NO_DATA;
-	}
-
-	if(i2cPort_.read((i2cAddress_ << 1) | 0x01, reinterpret_cast<char *>(rxBuffer), ubxHeaderLen) != 0)
-	{
-		DEBUG("Didn't receive ack from %s reading header\r\n", getName());
-		return ReadStatus::ERR;
-	}
-
-	// check format
-	if(rxBuffer[0] != UBX_MESSAGE_START_CHAR || rxBuffer[1] != UBX_MESSAGE_START_CHAR2)
-	{
-		DEBUG("Bad message header received from %s (magic bytes = %" PRIx8 " %" PRIx8"\r\n", getName(), rxBuffer[0], rxBuffer[1]);
-		return ReadStatus::ERR;
-	}
-
-	size_t ubxMsgRemainingLen = (static_cast<uint16_t>(rxBuffer[5] << 8) | rxBuffer[4]) + ubxChecksumLen;
-	currMessageLength_ = ubxMsgRemainingLen + ubxHeaderLen;
-
-	if(currMessageLength_ > MAX_MESSAGE_LEN)
-	{
-		// can't read this!
-		DEBUG("Message too long, %zu bytes.  Bailing out.\r\n", ubxMsgRemainingLen);
-		return ReadStatus::ERR;
-	}
-
-	// read rest of message
-	if(i2cPort_.read((i2cAddress_ << 1) | 0x01, reinterpret_cast<char *>(rxBuffer + ubxHeaderLen), ubxMsgRemainingLen) != 0)
+	while(true)
 	{
-		DEBUG("Didn't receive ack from %s reading body\r\n", getName());
-		return ReadStatus::ERR;
+		// Only ask how many bytes are in the buffer once we have read all the ones it reported last
+		// time, which saves a transaction per message when several are queued.
+		if(transferBudgetRemaining() == 0)
+		{
+			// Any partial message is finished by the next update
+			return ReadStatus::NO_DATA;
+		}
+
+		if(bytesAvailable_ == 0)
+		{
+			int32_t bufLen = readLen();
+			if(bufLen < 0)
+			{
+				DEBUG("Didn't receive ack from %s reading len\r\n", getName());
+				stats_.busErrors++;
+				return ReadStatus::ERR;
+			}
+			if(bufLen == 0)
+			{
+				// Any partial message is kept until the rest arrives
+				return ReadStatus::NO_DATA;
+			}
+			bytesAvailable_ = bufLen;
+		}
+
+		// When looking for the start of a message, read a whole UBX header at once.  The frame
+		// parser copes if it turns out to contain something else.
+		size_t readSize = rxFrameInProgress() ? rxBytesWanted() : UBX_DATA_OFFSET;
+		readSize = std::min<size_t>({readSize, bytesAvailable_, transferBudgetRemaining()});
+		if(readSize == 0)
+		{
+			return ReadStatus::NO_DATA;
+		}
+
+		uint8_t* const readPointer = rxWritePointer();
+		I2C::Result result;
+		{
+			BusLock<I2C> lock(i2cPort_, stats_);
+			result = i2cPort_.read((i2cAddress_ << 1) | 0x01, reinterpret_cast<char *>(readPointer), readSize);
+		}
+		if(result != I2C::ACK)
+		{
+			DEBUG("Didn't receive ack from %s reading data\r\n", getName());
+			stats_.busErrors++;
+			bytesAvailable_ = 0;
+			resetFramer();
+			return ReadStatus::ERR;
+		}
+		stats_.bytesRead += readSize;
+		spendTransferBudget(readSize);
+		bytesAvailable_ -= readSize;
+
+		size_t consumed;
+		const ReadStatus status = receiveBytes(readPointer, readSize, consumed);
+		if(status != ReadStatus::NO_DATA)
+		{
+			if(consumed < readSize)
+			{
+				// Only possible if a garbled header contained a very short NMEA sentence
+				stats_.resyncs++;
+			}
+			return status;
+		}
 	}
-
-	// add null terminator
-	rxBuffer[currMessageLength_] = 0;
-
-	DEBUG("Read stream of %s: ", getName());
-    for (size_t j = 0; j < currMessageLength_; j++)
-    {
-        DEBUG("%02" PRIx8, rxBuffer[j]);
-    }
-    DEBUG(";\r\n");
-
-    if (!verifyChecksum(currMessageLength_))
-    {
-        DEBUG("Checksums for UBX message don't match!\r\n");
-        return ReadStatus::ERR;
-    }
-
-	processMessage();
-
-    return ReadStatus::DONE;
 }
 
 int32_t UBloxGPSI2C::readLen()
 {
+    // Hold the bus across both transfers, so that no other driver's transfer can come between
+    // setting the register pointer and reading the register
+    BusLock<I2C> lock(i2cPort_, stats_);
+
     // Do a one-byte write to set the register read pointer
     char setReadPointerCmd[] = {0xFD}; // Bytes Available register
     auto result = i2cPort_.write((i2cAddress_ << 1) | 0x00, setReadPointerCmd, 1, true);
@@ -23,8 +23,24 @@ public:
      *                     on \c i2c before using the GPS.
      * @param user_RSTpin  Output pin connected to NRST
      * @param i2cAddress   I2C address. The MAX8 defaults to 0x42
+     * @param i2cFrequency Frequency which \c i2c is set to.  Only used to budget bus bandwidth, see
+     *                     UBloxGPS::setNavigationRate().
      */
-    UBloxGPSI2C(I2C & i2c, PinName user_RSTpin, uint8_t i2cAddress = UBloxGPS_I2C_DEF_ADDRESS);
+    UBloxGPSI2C(I2C & i2c, PinName user_RSTpin, uint8_t i2cAddress = UBloxGPS_I2C_DEF_ADDRESS,
+        int i2cFrequency = 100000);
+
+    /**
+     * @brief U-Blox port ID of the I2C (DDC) port.  Used to select port-specific configuration.
+     */
+    static constexpr uint8_t PORT_ID = MSGOUT_OFFSET_I2C;
+
+    /**
+     * @brief see UBloxGPS::getBusBandwidth.  Each byte takes 9 clocks, including the ACK.
+     */
+    uint32_t getBusBandwidth() const override
+    {
+        return i2cFrequency_ / 9;
+    }
 
 protected:
     /**
@@ -37,7 +53,11 @@ protected:
      */
     I2C & i2cPort_;
 
-private:
+    /**
+     * @brief I2C bus frequency
+     */
+    const int i2cFrequency_;
+
     /**
      * @brief Perform an I2C write
      *
@@ -48,23 +68,32 @@ private:
      *
      * @return true if the write was successful, false otherwise (if the sensor does not ACK)
      */
-    virtual bool sendMessage(uint8_t* packet, uint16_t packetLen) final;
+    virtual bool sendMessage(const uint8_t* packet, uint16_t packetLen) final;
 
     /**
      * @brief Perform an I2C read
      *
+     * Reads until a complete message has been received or the GPS's buffer is empty.  Partial
+     * messages are kept and finished on the next call.
+     *
      * @return ReadStatus::DONE if the read was successful
      *         ReadStatus::NO_DATA if there were no valid bytes available
      *         ReadStatus::ERR if an invalid byte or checksum was detected.
      */
     virtual ReadStatus readMessage() final;
 
+private:
     /**
      * @brief Returns length of buffer in the GPS module's I2C output buffer.
      *
      * @returns Length of buffer, or -1 if unsuccessful.
      */
     int32_t readLen();
+
+    /**
+     * @brief Number of bytes left in the GPS's output buffer, as of the last readLen()
+     */
+    size_t bytesAvailable_ = 0;
 };
 };
 
@@ -0,0 +1,158 @@
+#include "UBloxGPSManager.h"
+
+#include <algorithm>
+
+namespace UBlox
+{
+
+UBloxGPSManager::UBloxGPSManager(us_time pollInterval, size_t maxMessagesPerTurn)
+    : pollInterval_(pollInterval)
+    , maxMessagesPerTurn_(maxMessagesPerTurn)
+{
+}
+
+bool UBloxGPSManager::addReceiver(UBloxGPS& gps, DigitalIn* txReady, bool txReadyActiveLow)
+{
+    if (numReceivers_ >= UBLOX_GNSS_MAX_MANAGED_RECEIVERS)
+    {
+        printf("UBloxGPSManager: cannot add receiver, already managing %d receivers\r\n",
+            UBLOX_GNSS_MAX_MANAGED_RECEIVERS);
+        return false;
+    }
+
+    Receiver& receiver = receivers_[numReceivers_++];
+    receiver.gps = &gps;
+    receiver.txReady = txReady;
+    receiver.txReadyActiveLow = txReadyActiveLow;
+    receiver.nextPollTime = UBloxGPS::now();
+
+    // No burst has been seen yet, so poll at the normal interval until the first one
+    receiver.burstStartTime = receiver.nextPollTime - 1s;
+    return true;
+}
+
+int UBloxGPSManager::update()
+{
+    const us_time updateTime = UBloxGPS::now();
+    int totalMessages = 0;
+
+    for (size_t offset = 0; offset < numReceivers_; offset++)
+    {
+        Receiver& receiver = receivers_[(firstReceiver_ + offset) % numReceivers_];
+
+        us_time dueTime;
+        if (isDue(receiver, updateTime, dueTime))
+        {
+            totalMessages += service(receiver, dueTime);
+        }
+    }
+
+    if (numReceivers_ > 0)
+    {
+        firstReceiver_ = (firstReceiver_ + 1) % numReceivers_;
+    }
+
+    return totalMessages;
+}
+
+void UBloxGPSManager::resetStatistics()
+{
+    for (size_t index = 0; index < numReceivers_; index++)
+    {
+        receivers_[index].stats = ManagedReceiverStatistics();
+    }
+}
+
+bool UBloxGPSManager::isDue(Receiver& receiver, us_time updateTime, us_time& dueTime)
+{
+    // Answers to commands can arrive at any time, and nothing else is known about them
+    bool waitingForAnswer = receiver.gps->isBeginInProgress();
+#if UBLOX_GNSS_MAX_PENDING_COMMANDS > 0
+    waitingForAnswer = waitingForAnswer || receiver.gps->getPendingCommandCount() > 0;
+#endif
+    if (waitingForAnswer)
+    {
+        dueTime = updateTime;
+        return true;
+    }
+
+    if (receiver.txReady != nullptr)
+    {
+        if (receiver.txReady->read() == (receiver.txReadyActiveLow ? 0 : 1))
+        {
+            dueTime = updateTime;
+            return true;
+        }
+
+        receiver.stats.txReadySkips++;
+        return false;
+    }
+
+    dueTime = receiver.nextPollTime;
+    return updateTime >= receiver.nextPollTime;
+}
+
+int UBloxGPSManager::service(Receiver& receiver, us_time dueTime)
+{
+    const us_time startTime = UBloxGPS::now();
+    receiver.stats.polls++;
+    receiver.stats.pollDelay.record(
+        startTime > dueTime ? static_cast<uint32_t>((startTime - dueTime).count()) : 0);
+
+    int messages = 0;
+    if (receiver.gps->isBeginInProgress())
+    {
+        // poll() does its own reading, and sends the next initialization step when it is ready
+        receiver.gps->poll();
+    }
+    else
+    {
+        while (messages < static_cast<int>(maxMessagesPerTurn_))
+        {
+            const int read = receiver.gps->update(0us);
+            if (read <= 0)
+            {
+                break;
+            }
+            messages += read;
+        }
+    }
+
+    const us_time endTime = UBloxGPS::now();
+    receiver.stats.busTimeUs += (endTime - startTime).count();
+    receiver.stats.messages += messages;
+
+    if (messages > 0 && !receiver.inBurst)
+    {
+        receiver.burstStartTime = startTime;
+        receiver.inBurst = true;
+    }
+
+    if (messages >= static_cast<int>(maxMessagesPerTurn_))
+    {
+        // More may be waiting; come back next update()
+        receiver.stats.turnLimitHits++;
+        receiver.nextPollTime = endTime;
+    }
+    else if (messages > 0)
+    {
+        // The receiver sends each epoch's messages as they are generated, so the burst may not
+        // be over yet
+        receiver.nextPollTime = endTime + pollInterval_;
+    }
+    else
+    {
+        receiver.stats.emptyPolls++;
+        receiver.inBurst = false;
+
+        // Sleep until shortly before the next epoch's burst is expected.  If that has already
+        // passed, the epoch is late, so keep polling at the normal interval.
+        const us_time period(1000000 / std::max<uint16_t>(receiver.gps->getNavigationRate(), 1));
+        const us_time expectedBurst = receiver.burstStartTime + period - period / 8;
+        receiver.nextPollTime = std::max(endTime + pollInterval_, expectedBurst);
+    }
+
+    return messages;
+}
+
+}
@@ -0,0 +1,160 @@
+#ifndef UBLOXGPS_MANAGER_H
+#define UBLOXGPS_MANAGER_H
+
+#include "UBloxGPS.h"
+
+namespace UBlox
+{
+
+/**
+ * @brief Scheduling statistics for one receiver owned by a UBloxGPSManager
+ */
+struct ManagedReceiverStatistics
+{
+    /// Number of times the receiver was read
+    uint32_t polls = 0;
+
+    /// Reads which found nothing waiting.  On I2C, each of these still costs a length read.
+    uint32_t emptyPolls = 0;
+
+    /// Messages read from the receiver
+    uint32_t messages = 0;
+
+    /// Number of times the receiver was passed over because its TX-ready pin showed no data waiting
+    uint32_t txReadySkips = 0;
+
+    /// Number of times reading stopped at the per-turn message limit to let the other receivers in
+    uint32_t turnLimitHits = 0;
+
+    /// Total time spent reading the receiver (us).  Compare between receivers to check fairness.
+    uint64_t busTimeUs = 0;
+
+    /// Time between the receiver becoming due and it being read
+    LatencyHistogram pollDelay;
+};
+
+/**
+ * @brief Owns several receivers sharing one bus, and schedules their reads from a single thread.
+ *
+ * Calling update() on each receiver independently polls every one of them each time, and on I2C
+ * every poll starts with a length read even when nothing is waiting.  The manager instead reads
+ * a receiver only when it is expected to have data:
+ *  - If the receiver's TX-ready pin is connected, when the pin is asserted.  This costs no bus
+ *    time at all for idle receivers.
+ *  - Otherwise, from shortly before its next navigation epoch (going by the time of the last
+ *    burst of messages and the navigation rate), and then frequently until the burst ends.
+ *  - Always while it is initializing (see UBloxGPS::beginAsync()) or has asynchronous commands
+ *    waiting for an answer, since those answers can come at any time.
+ *
+ * Each due receiver is drained in one go, so its transactions are batched (on I2C, one length
+ * read covers every message waiting), up to a limit per turn so that one busy receiver can't
+ * hold up the rest.  The receiver that goes first rotates each update().
+ *
+ * The receivers must not be used by any other thread while they are owned by the manager.
+ * Configure them before adding them (or use beginAsync() and let the manager poll them).
+ */
+class UBloxGPSManager
+{
+public:
+    /**
+     * @brief Construct a UBloxGPSManager.
+     *
+     * @param pollInterval How often to poll a receiver without a TX-ready pin while it is in
+     *                     the middle of a burst of messages, or when its next epoch is overdue.
+     * @param maxMessagesPerTurn Largest number of messages read from one receiver per update()
+     */
+    explicit UBloxGPSManager(us_time pollInterval = 5ms, size_t maxMessagesPerTurn = 8);
+
+    UBloxGPSManager(UBloxGPSManager const &) = delete;
+    UBloxGPSManager& operator=(UBloxGPSManager const &) = delete;
+
+    /**
+     * @brief Add a receiver to the manager.
+     *
+     * @param gps Receiver to add.  Must outlive the manager.
+     * @param txReady Input connected to the receiver's TX-ready output, or nullptr if it is not
+     *                connected.  TX-ready must be enabled on the receiver itself (CFG-PRT on
+     *                Gen8, CFG-TXREADY-* on Gen9).
+     * @param txReadyActiveLow Whether the TX-ready output is active low
+     *
+     * @return false if UBLOX_GNSS_MAX_MANAGED_RECEIVERS receivers have already been added
+     */
+    bool addReceiver(UBloxGPS& gps, DigitalIn* txReady = nullptr, bool txReadyActiveLow = false);
+
+    /**
+     * @brief Get the number of receivers added.
+     */
+    size_t getNumReceivers() const
+    {
+        return numReceivers_;
+    }
+
+    /**
+     * @brief Read from every receiver which is due.  Call this regularly (at least every
+     * pollInterval) from the thread which owns the bus, instead of calling update() on the
+     * receivers themselves.
+     *
+     * @return the total number of messages read
+     */
+    int update();
+
+    /**
+     * @brief Get the scheduling statistics of a receiver.
+     *
+     * @param index Index of the receiver, in the order they were added
+     */
+    const ManagedReceiverStatistics& getStatistics(size_t index) const
+    {
+        return receivers_[index].stats;
+    }
+
+    /**
+     * @brief Reset the scheduling statistics of all receivers.
+     */
+    void resetStatistics();
+
+private:
+    struct Receiver
+    {
+        UBloxGPS* gps = nullptr;
+        DigitalIn* txReady = nullptr;
+        bool txReadyActiveLow = false;
+
+        /// When a receiver without a TX-ready pin should next be polled
+        us_time nextPollTime = 0us;
+
+        /// When the last burst of messages started
+        us_time burstStartTime = 0us;
+
+        /// Whether the last poll found any messages
+        bool inBurst = false;
+
+        ManagedReceiverStatistics stats;
+    };
+
+    /**
+     * @brief Check whether a receiver should be read now.
+     * @param[out] dueTime When the receiver became due
+     */
+    bool isDue(Receiver& receiver, us_time updateTime, us_time& dueTime);
+
+    /**
+     * @brief Read everything waiting from a receiver (up to maxMessagesPerTurn_), and schedule
+     * its next poll.
+     * @return the number of messages read
+     */
+    int service(Receiver& receiver, us_time dueTime);
+
+    const us_time pollInterval_;
+    const size_t maxMessagesPerTurn_;
+
+    Receiver receivers_[UBLOX_GNSS_MAX_MANAGED_RECEIVERS];
+    size_t numReceivers_ = 0;
+
+    /// Index of the receiver which goes first in the next update()
+    size_t firstReceiver_ = 0;
+};
+
+}
+
+#endif // UBLOXGPS_MANAGER_H
@@ -1,5 +1,5 @@
-#include "internal/ScopeGuard.h"
 #include "UBloxGPSSPI.h"
+#include "internal/BusLock.h"
 
 namespace UBlox
 {
@@ -11,152 +11,103 @@ UBloxGPSSPI::UBloxGPSSPI(PinName user_MOSIpin, PinName user_MISOpin, PinName use
 {
     spiPort_.format(8, 0); // Setup SPI for 8 bit data, SPI Mode 0. UBLox8 default is SPI Mode 0
     spiPort_.frequency(spiClockRate_);
-    spiPort_.lock();
+    spiPort_.set_default_write_value(0xFF); // sent while reading, to indicate that we have no data
+}
+
+void UBloxGPSSPI::transfer(const uint8_t* txData, size_t txLen, uint8_t* rxData, size_t rxLen)
+{
+    BusLock<SPI> lock(spiPort_, stats_);
+    spiPort_.select();
+    spiPort_.write(reinterpret_cast<const char*>(txData), txLen, reinterpret_cast<char*>(rxData), rxLen);
     spiPort_.deselect();
 }
 
-UBloxGPS::ReadStatus UBloxGPSSPI::performSPITransaction(uint8_t* packet, uint16_t packetLen)
+UBloxGPS::ReadStatus UBloxGPSSPI::performSPITransaction(const uint8_t* packet, uint16_t packetLen)
 {
 
     DEBUG_TR("Beginning SPI transaction ----------------------------------\r\n");
 
-    auto init_spi = [this]() { spiPort_.select(); };
+    // The GNSS treats SPI as a byte stream, so chip select (and the bus lock) is released between
+    // transfers, and the bytes read are parsed while other drivers can use the bus.
 
-    auto cleanup_spi = [this]() { spiPort_.deselect(); };
-
-    ScopeGuard<decltype(init_spi), decltype(cleanup_spi)> spiManager(init_spi, cleanup_spi);
-
-    // If we are receiving a UBX message, this variable gets filled with the expected length.
-    uint32_t ubxMsgLen = 0;
+    // Send the packet in blocks, passing the bytes clocked in at the same time to the frame
+    // parser.  Any RX errors during the TX are ignored.
+    uint8_t incoming[SPI_BLOCK_SIZE];
+    for (uint16_t bytesSent = 0; bytesSent < packetLen;)
+    {
+        const uint16_t blockLen = std::min<uint16_t>(packetLen - bytesSent, SPI_BLOCK_SIZE);
+        transfer(packet + bytesSent, blockLen, incoming, blockLen);
+        stats_.bytesRead += blockLen;
+        spendTransferBudget(blockLen);
+        bytesSent += blockLen;
 
-    // If we are receiving a message in this transaction, this index is nonzero and indicates where
-    // in the RX buffer to save the current byte of the message
-    uint32_t rxIndex = 0;
+        for (size_t offset = 0; offset < blockLen;)
+        {
+            size_t consumed;
+            receiveBytes(incoming + offset, blockLen - offset, consumed);
+            offset += consumed;
+        }
+    }
 
-    // True if this is the first loop of an RX-only transaction.
-    bool isRXOnly = packetLen == 0;
+    if (packetLen > 0)
+    {
+        DEBUG_TR("Sent packet (% " PRIu16 " bytes): ", packetLen);
+        for (uint16_t j = 0; j < packetLen; j++)
+        {
+            DEBUG_TR(" %02" PRIx8, packet[j]);
+        }
+        DEBUG_TR("\r\n");
+    }
 
     /* CONTINUE WHILE:
-     * we still have data to send OR
      * we are in the middle of receiving a packet OR
      * we are trying to start an RX only transaction.
      *
      * QUIT IF:
-     * we have been going for 10000 cycles OR
-     * checksums do not match OR
+     * we have received MAX_TRANSACTION_BYTES OR
+     * the budget of updateWithBudget() is used up OR
+     * a packet was received in an RX only transaction OR
      * no data is received with an RX only transaction.
      */
-    for (int i = 0; (i < packetLen || rxIndex > 0 || isRXOnly) && i < 10000; i++)
+    for (size_t bytesReceived = 0;
+         (packetLen == 0 || rxFrameInProgress()) && bytesReceived < MAX_TRANSACTION_BYTES;)
     {
-        uint8_t dataToSend = (i < packetLen) ? packet[i] : 0xFF;
-        uint8_t incoming = spiPort_.write(dataToSend);
-
-        DEBUG_TR(
-            "SPI 0x%" PRIx8 " <--> 0x%" PRIx8 " (rxIndex = %d)\r\n", incoming, dataToSend, rxIndex);
-
-        // last byte of original packet?
-        if (i == packetLen - 1)
+        // Clock the rest of the current frame (or the next byte, if we don't know its length yet)
+        // straight into rxBuffer, sending 0xFF
+        const size_t readLen = std::min(rxBytesWanted(), transferBudgetRemaining());
+        if (readLen == 0)
         {
-            DEBUG_TR("Sent packet (% " PRIu16 " bytes): ");
-            for (uint16_t j = 0; j < packetLen; j++)
-            {
-                DEBUG_TR(" %02" PRIx8, packet[j]);
-            }
-            DEBUG_TR("\r\n");
+            // Out of budget.  Any partial frame is finished by the next update.
+            return packetLen == 0 ? ReadStatus::NO_DATA : ReadStatus::DONE;
         }
 
-        if (rxIndex < MAX_MESSAGE_LEN)
-        {
-            rxBuffer[rxIndex] = incoming;
-        }
+        uint8_t* const readPointer = rxWritePointer();
+        transfer(nullptr, 0, readPointer, readLen);
+        stats_.bytesRead += readLen;
+        spendTransferBudget(readLen);
+        bytesReceived += readLen;
 
-        // check for the start of a packet
-        if (rxIndex == 0)
-        {
-            switch (incoming)
-            {
-                case NMEA_MESSAGE_START_CHAR:
-                    isNMEASentence = true;
-                    break;
-
-                case UBX_MESSAGE_START_CHAR:
-                    isNMEASentence = false;
-                    break;
-
-                case 0xFF:
-                    // 0xFF is sent to indicate no data
-                    if (isRXOnly)
-                    {
-                        return ReadStatus::NO_DATA;
-                    }
-                    else
-                    {
-                        continue;
-                    }
-                default:
-                    printf("Received unknown byte 0x%" PRIx8
-                           ", not the start of a UBX or NMEA message.\r\n",
-                        incoming);
-                    rxIndex = 0;
-                    continue;
-            }
-        }
-        else if (rxIndex == 5 && !isNMEASentence)
-        {
-            // Populate ubxMsgLen with the size of the incoming UBX message
-            // Add 8 to account for the sync(2) bytes, class, id, length(2) and checksum(2) bytes
-            ubxMsgLen = (static_cast<uint16_t>(rxBuffer[rxIndex] << 8) | rxBuffer[rxIndex - 1]) + 8;
-        }
+        DEBUG_TR("SPI read %zu bytes (first 0x%" PRIx8 ")\r\n", readLen, readPointer[0]);
 
-        // if it's an NMEA sentence, there is a CRLF at the end
-        // if it's an UBX  sentence, there is a length passed before the payload
-        if (isNMEASentence && incoming == '\n')
+        size_t consumed;
+        const ReadStatus status = receiveBytes(readPointer, readLen, consumed);
+        if (status != ReadStatus::NO_DATA)
         {
-            currMessageLength_ = rxIndex + 1;
-            rxIndex = 0;
-            if (i >= packetLen)
-            {
-                return ReadStatus::DONE;
-            }
+            return packetLen == 0 ? status : ReadStatus::DONE;
         }
-        else if (!isNMEASentence && ubxMsgLen != 0 && rxIndex == ubxMsgLen - 1)
+
+        if (packetLen == 0 && !rxFrameInProgress() && readPointer[readLen - 1] == 0xFF)
         {
-            DEBUG("Received packet (% " PRIu16 " bytes): ", ubxMsgLen);
-            for (uint16_t j = 0; j < ubxMsgLen; j++)
-            {
-                DEBUG(" %02" PRIx8, rxBuffer[j]);
-            }
-            DEBUG("\r\n");
-
-            if (rxIndex < MAX_MESSAGE_LEN)
-            {
-                rxBuffer[rxIndex + 1] = 0;
-            }
-
-            if (!verifyChecksum(ubxMsgLen))
-            {
-                printf("Checksums for UBX message don't match!\r\n");
-                if (i >= packetLen)
-                {
-                    return ReadStatus::ERR;
-                }
-            }
-
-            processMessage();
-            currMessageLength_ = rxIndex + 1;
-            if (i >= packetLen)
-            {
-                return ReadStatus::DONE;
-            }
+            // 0xFF is sent to indicate no data
+            return ReadStatus::NO_DATA;
         }
-        rxIndex++;
     }
 
     DEBUG_TR("\r\n\r\n");
-    return ReadStatus::DONE;
+    return packetLen == 0 ? ReadStatus::NO_DATA : ReadStatus::DONE;
 }
 
-bool UBloxGPSSPI::sendMessage(uint8_t* packet, uint16_t packetLen)
+bool UBloxGPSSPI::sendMessage(const uint8_t* packet, uint16_t packetLen)
 {
     return performSPITransaction(packet, packetLen) == ReadStatus::DONE;
 }
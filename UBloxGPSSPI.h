@@ -29,6 +29,39 @@ public:
     UBloxGPSSPI(PinName user_MOSIpin, PinName user_MISOpin, PinName user_RSTpin,
         PinName user_SCLKpin, PinName user_CSPin, int spiClockRate = 1000000);
 
+    /**
+     * @brief U-Blox port ID of the SPI port.  Used to select port-specific configuration.
+     */
+    static constexpr uint8_t PORT_ID = MSGOUT_OFFSET_SPI;
+
+    /**
+     * @brief see UBloxGPS::getBusBandwidth
+     */
+    uint32_t getBusBandwidth() const override
+    {
+        return spiClockRate_ / 8;
+    }
+
+protected:
+    /**
+     * @brief Perform an SPI write
+     *
+     * @param packet buffer of bytes to send out to the chip
+     * @param packetLen number of bytes in packet.
+     *
+     * @return true if the write was successful, false otherwise.
+     */
+    virtual bool sendMessage(const uint8_t* packet, uint16_t packetLen) final;
+
+    /**
+     * @brief Perform an SPI read
+     *
+     * @return ReadStatus::DONE if the read was successful
+     *         ReadStatus::NO_DATA if there were no valid bytes available
+     *         ReadStatus::ERR if an invalid byte or checksum was detected.
+     */
+    virtual ReadStatus readMessage() final;
+
 private:
     /**
      * @brief Perform an SPI Transaction, and attempt to exit as quickly as possible
@@ -39,39 +72,29 @@ private:
      * while processing any packets that are received. If an RX operation is in progress when all of
      * the TX bytes have been sent out, performSPITransaction will complete the read of the current
      * packet, process it, and exit. If any RX errors occur during the TX of the packet, those
-     * errors are ignored until the packet has been completely sent out.
+     * errors are ignored.
+     *
+     * Once the length of an incoming packet is known, the rest of it is read with a single block
+     * transfer directly into rxBuffer.
      *
      * @param packet buffer of bytes to send out to the chip
      * @param packetLen number of bytes in packet.
      *
      * @return ReadStatus::DONE if an RX-only operation was initiated, and a packet was read; or if
-     * a TX operation was initiated, and the message was sent successfully
+     * a TX operation was initiated
      *         ReadStatus::NO_DATA if an RX-only operation was initiated and there was not a valid
      * byte available
      *         ReadStatus::ERR if an invalid byte or checksum was detected.
      */
-    ReadStatus performSPITransaction(uint8_t* packet, uint16_t packetLen);
+    ReadStatus performSPITransaction(const uint8_t* packet, uint16_t packetLen);
 
     /**
-     * @brief Perform an SPI write
-     *
-     * @param packet buffer of bytes to send out to the chip
-     * @param packetLen number of bytes in packet.
-     *
-     * @return true if the write was successful, false otherwise.
+     * @brief Do one transfer on the SPI bus, holding its lock and chip select only for the
+     * transfer itself.  Sends txLen bytes from txData (then 0xFF), and reads rxLen bytes into
+     * rxData.
      */
-    virtual bool sendMessage(uint8_t* packet, uint16_t packetLen) final;
+    void transfer(const uint8_t* txData, size_t txLen, uint8_t* rxData, size_t rxLen);
 
-    /**
-     * @brief Perform an SPI read
-     *
-     * @return ReadStatus::DONE if the read was successful
-     *         ReadStatus::NO_DATA if there were no valid bytes available
-     *         ReadStatus::ERR if an invalid byte or checksum was detected.
-     */
-    virtual ReadStatus readMessage() final;
-
-private:
     /**
      * @brief SPI port
      */
@@ -82,6 +105,18 @@ private:
      */
     const int spiClockRate_;
 
+    /**
+     * @brief Number of bytes sent per block while transmitting.  The bytes received at the same time
+     * are staged in a buffer of this size on the stack.
+     */
+    static constexpr uint16_t SPI_BLOCK_SIZE = 32;
+
+    /**
+     * @brief Max bytes to read in one transaction, so that a GPS sending garbage can't hold the
+     * bus forever.
+     */
+    static constexpr size_t MAX_TRANSACTION_BYTES = 10000;
+
     /** The maximum SPI frequency, in Hz (5.5 MHz) */
 #define UBLOX_SPI_MAX_SPEED 5500000
 };
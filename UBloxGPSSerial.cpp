@@ -0,0 +1,157 @@
+#include "UBloxGPSSerial.h"
+
+#include <cerrno>
+
+namespace UBlox
+{
+UBloxGPSSerial::UBloxGPSSerial(PinName user_TXpin, PinName user_RXpin, PinName user_RSTpin, int baudRate)
+    : UBloxGPS(user_RSTpin)
+    , serialPort_(user_TXpin, user_RXpin, baudRate)
+    , baudRate_(baudRate)
+{
+    // Reads return immediately with whatever is buffered, waits are done with poll()
+    serialPort_.set_blocking(false);
+}
+
+bool UBloxGPSSerial::sendMessage(const uint8_t* packet, uint16_t packetLen)
+{
+    // Max time to wait for space in the TX buffer
+    static constexpr int WRITE_TIMEOUT_MS = 100;
+
+    uint16_t bytesWritten = 0;
+    while (bytesWritten < packetLen)
+    {
+        ssize_t result = serialPort_.write(packet + bytesWritten, packetLen - bytesWritten);
+        if (result == -EAGAIN)
+        {
+            pollfh fds[1] = { { &serialPort_, POLLOUT, 0 } };
+            if (mbed::poll(fds, 1, WRITE_TIMEOUT_MS) <= 0)
+            {
+                printf("%s serial write timed out!\r\n", getName());
+                stats_.busErrors++;
+                return false;
+            }
+            continue;
+        }
+        if (result < 0)
+        {
+            printf("%s serial write failed!\r\n", getName());
+            stats_.busErrors++;
+            return false;
+        }
+        bytesWritten += result;
+    }
+
+    DEBUG("Sent packet (%" PRIu16 " bytes) to %s over serial\r\n", packetLen, getName());
+    return true;
+}
+
+UBloxGPS::ReadStatus UBloxGPSSerial::readMessage()
+{
+    while (true)
+    {
+        size_t consumed;
+        if (readAheadStart_ < readAheadEnd_)
+        {
+            // Finish the bytes left over from the last block read first
+            const ReadStatus status
+                = receiveBytes(readAhead_ + readAheadStart_, readAheadEnd_ - readAheadStart_, consumed);
+            readAheadStart_ += consumed;
+            if (status != ReadStatus::NO_DATA)
+            {
+                return status;
+            }
+            continue;
+        }
+
+        // While the length of the frame is known, read straight into rxBuffer, never past its end.
+        // Otherwise (NMEA sentences and the start of each frame), read a block into readAhead_
+        // and keep whatever the parser doesn't use for the next frame.
+        const bool readDirect = rxBytesWanted() > 1;
+        const size_t readSize
+            = std::min(readDirect ? rxBytesWanted() : READ_AHEAD_SIZE, transferBudgetRemaining());
+        if (readSize == 0)
+        {
+            // Any partial message is finished by the next update
+            return ReadStatus::NO_DATA;
+        }
+
+        uint8_t* const readPointer = readDirect ? rxWritePointer() : readAhead_;
+        const ssize_t bytesRead = serialPort_.read(readPointer, readSize);
+        if (bytesRead == -EAGAIN || bytesRead == 0)
+        {
+            return ReadStatus::NO_DATA;
+        }
+        if (bytesRead < 0)
+        {
+            printf("%s serial read failed!\r\n", getName());
+            stats_.busErrors++;
+            return ReadStatus::ERR;
+        }
+        stats_.bytesRead += bytesRead;
+        spendTransferBudget(bytesRead);
+
+        if (!readDirect)
+        {
+            readAheadStart_ = 0;
+            readAheadEnd_ = bytesRead;
+            continue;
+        }
+
+        const ReadStatus status = receiveBytes(readPointer, bytesRead, consumed);
+        if (status != ReadStatus::NO_DATA)
+        {
+            if (consumed < static_cast<size_t>(bytesRead))
+            {
+                // Only possible if a garbled header contained a very short NMEA sentence
+                stats_.resyncs++;
+            }
+            return status;
+        }
+    }
+}
+
+void UBloxGPSSerial::waitForData(us_time timeout)
+{
+    if (timeout <= 0us)
+    {
+        return;
+    }
+
+    pollfh fds[1] = { { &serialPort_, POLLIN, 0 } };
+    mbed::poll(fds, 1, std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+}
+
+bool UBloxGPSSerial::setBaudRate(int baudRate)
+{
+    if (!sendBaudRateCommand(baudRate))
+    {
+        return false;
+    }
+
+    // Wait for the command to leave the TX buffer, then for the last couple of characters
+    // (10 bits each) to leave the UART hardware
+    serialPort_.sync();
+    ThisThread::sleep_for(std::chrono::milliseconds(1 + (2 * 10 * 1000) / baudRate_));
+
+    // Give the GPS a moment to switch over, then switch ourselves and discard anything received
+    // around the change
+    ThisThread::sleep_for(10ms);
+    serialPort_.set_baud(baudRate);
+    baudRate_ = baudRate;
+
+    while (serialPort_.read(readAhead_, sizeof(readAhead_)) > 0)
+    {
+    }
+    readAheadStart_ = 0;
+    readAheadEnd_ = 0;
+    resetFramer();
+
+    if (!sendPacket(Packets::POLL_MON_VER, false, true, 500ms))
+    {
+        printf("%s did not respond at %d baud!\r\n", getName(), baudRate);
+        return false;
+    }
+    return true;
+}
+};
@@ -0,0 +1,126 @@
+#ifndef UBLOXGPS_SERIAL_H
+#define UBLOXGPS_SERIAL_H
+
+#include "UBloxGPS.h"
+
+namespace UBlox
+{
+/**
+ * @brief Specialization of UBloxGPS for communication over a UART (the GPS's UART1 port)
+ *
+ * Received bytes are read from the serial port's buffer straight into rxBuffer, in chunks as large
+ * as the current frame allows.  While waiting for data, the thread sleeps in poll() until the
+ * serial port has bytes available rather than polling the port.
+ *
+ * @note At high baud rates, make sure the serial RX buffer (drivers.uart-serial-rxbuf-size in
+ * mbed_app.json) can hold all the data the GPS sends between calls to update().
+ */
+class UBloxGPSSerial : virtual public UBloxGPS
+{
+public:
+    /**
+     * @brief Construct a serial UBloxGPS, providing pins and parameters.
+     *
+     * The UBloxGPSSerial class should not (and can not) be directly instantiated, since it virtually
+     * inherits from UBloxGPS. Instead, either ZEDF9PSerial or MAX8Serial should be instantiated.
+     *
+     * @note This doesn't actually initialize the chip, you will need to call begin() for that.
+     *
+     * @param user_TXpin  UART TX pin, connected to the GPS's RXD pin
+     * @param user_RXpin  UART RX pin, connected to the GPS's TXD pin
+     * @param user_RSTpin Output pin connected to NRST
+     * @param baudRate    Baud rate which the GPS's UART is currently set to
+     */
+    UBloxGPSSerial(PinName user_TXpin, PinName user_RXpin, PinName user_RSTpin, int baudRate);
+
+    /**
+     * @brief U-Blox port ID of the UART1 port.  Used to select port-specific configuration.
+     */
+    static constexpr uint8_t PORT_ID = MSGOUT_OFFSET_UART1;
+
+    /**
+     * @brief Change the baud rate used to talk to the GPS.
+     *
+     * The GPS is told to switch rates, then the local serial port is switched to match.  The link
+     * is then checked by polling the GPS's version.
+     *
+     * The new rate is only set in the GPS's RAM (CFG-UART1-BAUDRATE on Gen9, UBX-CFG-PRT on Gen8),
+     * so it lasts until the GPS loses power, after which it talks at its saved rate again.
+     *
+     * @return true if the GPS responded at the new baud rate
+     */
+    bool setBaudRate(int baudRate);
+
+    /**
+     * @brief Get the current baud rate.
+     */
+    int getBaudRate() const
+    {
+        return baudRate_;
+    }
+
+    /**
+     * @brief see UBloxGPS::getBusBandwidth.  Each byte takes 10 bits, including start and stop.
+     */
+    uint32_t getBusBandwidth() const override
+    {
+        return baudRate_ / 10;
+    }
+
+protected:
+    /**
+     * @brief Write a packet to the serial port
+     *
+     * @param packet buffer of bytes to send out to the chip
+     * @param packetLen number of bytes in packet.
+     *
+     * @return true if the write was successful, false otherwise.
+     */
+    virtual bool sendMessage(const uint8_t* packet, uint16_t packetLen) final;
+
+    /**
+     * @brief Read buffered bytes from the serial port until a message is complete, or there are
+     * no more bytes.  Partial messages are kept and finished on the next call.
+     *
+     * @return ReadStatus::DONE if the read was successful
+     *         ReadStatus::NO_DATA if a complete message was not available
+     *         ReadStatus::ERR if an invalid message or checksum was detected.
+     */
+    virtual ReadStatus readMessage() final;
+
+    /**
+     * @brief Sleep until the serial port has data available, or the timeout expires.
+     */
+    void waitForData(us_time timeout) override;
+
+private:
+    /**
+     * @brief Serial port
+     */
+    BufferedSerial serialPort_;
+
+    /**
+     * @brief Current baud rate
+     */
+    int baudRate_;
+
+    /**
+     * @brief Size of readAhead_
+     */
+    static constexpr size_t READ_AHEAD_SIZE = 64;
+
+    /**
+     * @brief Bytes read in a block while the length of the current frame was unknown (e.g. an
+     * NMEA sentence), which the parser has not used yet
+     */
+    uint8_t readAhead_[READ_AHEAD_SIZE];
+
+    /**
+     * @brief Range of readAhead_ which the parser has not used yet
+     */
+    size_t readAheadStart_ = 0;
+    size_t readAheadEnd_ = 0;
+};
+};
+
+#endif
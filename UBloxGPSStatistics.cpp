@@ -0,0 +1,100 @@
+#include "UBloxGPSStatistics.h"
+
+namespace UBlox
+{
+
+#if UBLOX_GNSS_ENABLE_HISTOGRAMS
+void LatencyHistogram::record(uint32_t us)
+{
+    // bucket index is the bit width of the sample
+    size_t bucket = us == 0 ? 0 : 32 - __builtin_clz(us);
+    if (bucket >= NUM_BUCKETS)
+    {
+        bucket = NUM_BUCKETS - 1;
+    }
+
+    buckets[bucket]++;
+    count++;
+    totalUs += us;
+    if (us > maxUs)
+    {
+        maxUs = us;
+    }
+}
+
+uint32_t LatencyHistogram::meanUs() const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    return static_cast<uint32_t>(totalUs / count);
+}
+
+uint32_t LatencyHistogram::percentileUs(uint8_t percentile) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // Number of samples which must be at or below the returned bucket, rounded up
+    uint64_t threshold = (static_cast<uint64_t>(count) * percentile + 99) / 100;
+
+    uint64_t cumulative = 0;
+    for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+    {
+        cumulative += buckets[bucket];
+        if (cumulative >= threshold && cumulative > 0)
+        {
+            return bucketLowerBoundUs(bucket);
+        }
+    }
+    return bucketLowerBoundUs(NUM_BUCKETS - 1);
+}
+
+uint32_t LatencyHistogram::bucketLowerBoundUs(size_t bucket)
+{
+    return bucket == 0 ? 0 : (1u << (bucket - 1));
+}
+#endif
+
+void DriverStatistics::countFrame(uint8_t messageClass, uint8_t messageID)
+{
+    framesReceived++;
+
+    for (size_t i = 0; i < numFrameTypes; i++)
+    {
+        if (framesByType[i].messageClass == messageClass
+            && framesByType[i].messageID == messageID)
+        {
+            framesByType[i].count++;
+            return;
+        }
+    }
+
+    if (numFrameTypes < MAX_FRAME_TYPES)
+    {
+        framesByType[numFrameTypes] = { messageClass, messageID, 1 };
+        numFrameTypes++;
+    }
+    else
+    {
+        otherFrames++;
+    }
+}
+
+uint32_t DriverStatistics::getFrameCount(uint8_t messageClass, uint8_t messageID) const
+{
+    for (size_t i = 0; i < numFrameTypes; i++)
+    {
+        if (framesByType[i].messageClass == messageClass
+            && framesByType[i].messageID == messageID)
+        {
+            return framesByType[i].count;
+        }
+    }
+    return 0;
+}
+
+}
@@ -0,0 +1,216 @@
+#ifndef UBLOXGPS_STATISTICS_H
+#define UBLOXGPS_STATISTICS_H
+
+#include "UBloxGPSConstants.h"
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace UBlox
+{
+
+#if UBLOX_GNSS_ENABLE_HISTOGRAMS
+/**
+ * @brief Histogram of durations, in microseconds, with power-of-two bucket widths.
+ *
+ * Bucket 0 counts samples of 0us, and bucket n (n >= 1) counts samples in [2^(n-1), 2^n) us.
+ * The last bucket also collects everything too large for the others.  Recording a sample is
+ * a handful of integer operations, so histograms can be updated on every message.
+ */
+struct LatencyHistogram
+{
+    static constexpr size_t NUM_BUCKETS = 20;
+
+    /// Sample counts for each bucket
+    uint32_t buckets[NUM_BUCKETS] = {};
+
+    /// Total number of samples recorded
+    uint32_t count = 0;
+
+    /// Largest sample recorded (us)
+    uint32_t maxUs = 0;
+
+    /// Sum of all samples recorded (us)
+    uint64_t totalUs = 0;
+
+    /**
+     * @brief Add a sample to the histogram.
+     */
+    void record(uint32_t us);
+
+    /**
+     * @brief Get the mean of all samples (us), or 0 if nothing has been recorded.
+     */
+    uint32_t meanUs() const;
+
+    /**
+     * @brief Get the lower edge (us) of the bucket containing the given percentile (0-100)
+     * of samples.  This is a conservative estimate, accurate to a factor of two.
+     */
+    uint32_t percentileUs(uint8_t percentile) const;
+
+    /**
+     * @brief Get the lower edge (us) of the given bucket.
+     */
+    static uint32_t bucketLowerBoundUs(size_t bucket);
+};
+#else
+/**
+ * @brief Placeholder used when UBLOX_GNSS_ENABLE_HISTOGRAMS is 0.  Samples are discarded and all
+ * queries return 0.
+ */
+struct LatencyHistogram
+{
+    static constexpr size_t NUM_BUCKETS = 0;
+
+    void record(uint32_t) {}
+
+    uint32_t meanUs() const { return 0; }
+
+    uint32_t percentileUs(uint8_t) const { return 0; }
+
+    static uint32_t bucketLowerBoundUs(size_t) { return 0; }
+};
+#endif
+
+/**
+ * @brief Number of frames received with a particular UBX class and ID.
+ */
+struct FrameCounter
+{
+    uint8_t messageClass;
+    uint8_t messageID;
+    uint32_t count;
+};
+
+/**
+ * @brief Counters and histograms describing the health of the link to a GNSS.
+ *
+ * These are updated by the driver as it runs, and can be retrieved as a snapshot via
+ * UBloxGPS::getStatistics().
+ */
+struct DriverStatistics
+{
+    /// Max number of distinct UBX message types counted individually in framesByType
+    static constexpr size_t MAX_FRAME_TYPES = UBLOX_GNSS_MAX_FRAME_TYPES;
+
+    /// Frames received for each UBX message type, in the order they were first seen
+    FrameCounter framesByType[MAX_FRAME_TYPES] = {};
+
+    /// Number of valid entries in framesByType
+    uint8_t numFrameTypes = 0;
+
+    /// UBX frames whose type did not fit in framesByType
+    uint32_t otherFrames = 0;
+
+    /// Total UBX frames received with a valid checksum
+    uint32_t framesReceived = 0;
+
+    /// NMEA sentences received (and ignored)
+    uint32_t nmeaSentences = 0;
+
+    /// Total bytes clocked in from the GNSS, including idle bytes
+    uint64_t bytesRead = 0;
+
+    /// 0xFF bytes received while waiting for the start of a frame (SPI only)
+    uint32_t idleBytes = 0;
+
+    /// UBX or RTCM3 frames dropped because their checksum did not match
+    uint32_t checksumFailures = 0;
+
+    /// Times the receiver had to skip unexpected bytes to find the start of a frame
+    uint32_t resyncs = 0;
+
+    /// NACKs received in response to commands
+    uint32_t nacks = 0;
+
+    /// Timeouts while waiting for an ACK or a response
+    uint32_t timeouts = 0;
+
+    /// Frames which were too large for the RX buffer
+    uint32_t truncations = 0;
+
+    /// Bus transactions which were not acknowledged by the GNSS (I2C only)
+    uint32_t busErrors = 0;
+
+    /// Time mark events overwritten because the queue was full
+    uint32_t timemarkOverflows = 0;
+
+    /// Time mark events the receiver did not report (detected from gaps in the edge count)
+    uint32_t timemarksMissed = 0;
+
+    /// RTCM3 correction bytes sent to the receiver
+    uint32_t rtcmBytesInjected = 0;
+
+    /// RTCM3 correction bytes dropped because they were invalid, did not fit in the queue, or
+    /// could not be sent
+    uint32_t rtcmBytesDropped = 0;
+
+    /// RTCM3 frames rejected by injectRTCMFrame() because of a bad header or CRC
+    uint32_t rtcmFramesInvalid = 0;
+
+    /// RTCM3 frames received from the receiver with a valid CRC
+    uint32_t rtcmFramesReceived = 0;
+
+    /// RTCM3 frames from the receiver dropped because they were too large for the RX buffer (see
+    /// UBLOX_GNSS_RX_BUFFER_SIZE).  These are also counted in truncations.
+    uint32_t rtcmFramesTooLong = 0;
+
+    /// Navigation epochs with no NAV messages (detected from gaps in the iTOW)
+    uint32_t epochsMissed = 0;
+
+    /// Times the watchdog found that no valid frames had been received for its stall timeout
+    uint32_t streamStalls = 0;
+
+    /// Times the watchdog found a burst of checksum, framing or bus errors
+    uint32_t errorBursts = 0;
+
+    /// Times the watchdog found a gap in the navigation epochs longer than it allows
+    uint32_t epochGaps = 0;
+
+    /// Times the watchdog escalated recovery to a hot start
+    uint32_t watchdogHotStarts = 0;
+
+    /// Times the watchdog escalated recovery to reconfiguring the receiver
+    uint32_t watchdogReconfigures = 0;
+
+    /// Times the stream was healthy again after a recovery stage
+    uint32_t watchdogRecoveries = 0;
+
+    /// Time spent in each call to UBloxGPS::update()
+    LatencyHistogram updateDuration;
+
+    /// Time between the last byte of a frame arriving and the frame being processed
+    LatencyHistogram dispatchLatency;
+
+    /// Time between sending a command and receiving its ACK or response
+    LatencyHistogram commandRoundTrip;
+
+    /// Time spent waiting for other drivers to release a shared bus (I2C and SPI only)
+    LatencyHistogram busLockWait;
+
+    /// Time the bus lock was held for each transfer (I2C and SPI only)
+    LatencyHistogram busLockHold;
+
+    /**
+     * Time between the start of a navigation epoch (its iTOW) and the first message of that epoch
+     * arriving at the host.  Since the host and GNSS clocks are not tied together, this is measured
+     * relative to the lowest latency seen, so it shows the variation in latency (e.g. from polling
+     * and bus delays) rather than its absolute value.
+     */
+    LatencyHistogram epochLatency;
+
+    /**
+     * @brief Count a received UBX frame of the given type.
+     */
+    void countFrame(uint8_t messageClass, uint8_t messageID);
+
+    /**
+     * @brief Get the number of frames received for a given UBX message type.
+     */
+    uint32_t getFrameCount(uint8_t messageClass, uint8_t messageID) const;
+};
+
+}
+
+#endif // UBLOXGPS_STATISTICS_H
@@ -2,72 +2,79 @@
 
 namespace UBlox
 {
-UBloxGen8::UBloxGen8()
+UBloxGen8::UBloxGen8(uint8_t portID)
+    : portID_(portID)
 {
 }
 
-bool UBloxGen8::configure()
+size_t UBloxGen8::getNumConfigurationSteps() const
 {
-    // Configure DDC(I2C) by writing
+    // The last step saves the settings
+    return isSavingConfiguration() ? 3 : 2;
+}
+
+bool UBloxGen8::sendConfigurationStep(size_t step)
+{
+    // Configure the port we are connected to
 
     // Configures the MAX8 to output in UBX format instead of NMEA format.
 
     /*
     UBX-CFG-PRT Payload
-    1 PortId  = 0
+    1 PortId  = 0 (I2C) or 1 (UART1)
     1 reserved1
     2 txReady
-    4 mode - 7 address and 0 for write
-    4 reserved - all 0s
+    4 mode - I2C: 7 address and 0 for write.  UART: character format
+    4 baudRate - UART only, reserved for I2C
     2 inProtoMask - keep 0th bit on, rest off
     2 outProtoMask - keep 0th bit on, rest off
     2 flags - all 0
     2 reserved - all 0
     */
 
-    static constexpr uint16_t DATA_LEN = 20;
-    uint8_t data[DATA_LEN];
-
-    setCFG_PRTPayload(data);
-
-    data[1] = 0; // Reserved
-
-    // disable TX ready
-    data[2] = 0;
-    data[3] = 0;
+    switch (step)
+    {
+        case 0:
+            {
+                uint8_t data[CFG_PRT_LEN];
+                buildCFG_PRTPayload(data);
+                return sendCommand(UBX_CLASS_CFG, UBX_CFG_PRT, data, CFG_PRT_LEN, false, false, 0us);
+            }
+        case 1:
+            // enable NAV messages
+            return sendMessageRate(UBX_CLASS_NAV, UBX_NAV_PVT, 1, false);
+        case 2:
+            return saveSettings(false);
+        default:
+            return false;
+    }
+}
 
-    data[5] = 0;
-    data[6] = 0;
-    data[7] = 0;
+void UBloxGen8::buildCFG_PRTPayload(uint8_t* data)
+{
+    // Mode, baud rate, etc. are zero unless set by the port-specific setCFG_PRTPayload()
+    memset(data, 0, CFG_PRT_LEN);
 
-    data[8] = 0;
-    data[9] = 0;
-    data[10] = 0;
-    data[11] = 0;
+    data[0] = portID_;
 
     data[12] = 0x01; // enabling UBX mode for input
-    data[13] = 0;
-
     data[14] = 0x01; // enabling UBX mode for output
-    data[15] = 0;
 
-    data[16] = 0;
-    data[17] = 0;
-    data[18] = 0;
-    data[19] = 0;
+    setCFG_PRTPayload(data);
+}
 
-    if (!sendCommand(UBX_CLASS_CFG, UBX_CFG_PRT, data, DATA_LEN, true, false, 500ms))
-    {
-        return false;
-    }
+bool UBloxGen8::sendBaudRateCommand(uint32_t baudRate)
+{
+    uint8_t data[CFG_PRT_LEN];
+    buildCFG_PRTPayload(data);
 
-    // enable NAV messages
-    if (!setMessageEnabled(UBX_CLASS_NAV, UBX_NAV_PVT, true))
-    {
-        return false;
-    }
+    data[8] = baudRate & 0xFF;
+    data[9] = (baudRate >> 8) & 0xFF;
+    data[10] = (baudRate >> 16) & 0xFF;
+    data[11] = (baudRate >> 24) & 0xFF;
 
-    return saveSettings();
+    // The GPS switches rate as soon as it processes this, so its ACK can't be relied on
+    return sendCommand(UBX_CLASS_CFG, UBX_CFG_PRT, data, CFG_PRT_LEN, false, false, 0us);
 }
 
 bool UBloxGen8::configureTimepulse(uint32_t frequency, float onPercentage, chrono::nanoseconds delayTime)
@@ -127,31 +134,60 @@ bool UBloxGen8::configureTimepulse(uint32_t frequency, float onPercentage, chron
     }
 }
 
-bool UBloxGen8::setMessageEnabled(uint8_t messageClass, uint8_t messageID, bool enabled)
+bool UBloxGen8::enableTimemarkOutput(bool enabled)
+{
+    return setMessageRate(UBX_CLASS_TIM, UBX_TIM_TM2, enabled ? 1 : 0);
+}
+
+bool UBloxGen8::setMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate)
+{
+    if (!sendMessageRate(messageClass, messageID, rate, true))
+    {
+        printf("Message rate NOT set : 0x%" PRIx8 " , 0x%" PRIx8 " \r\n", messageClass, messageID);
+        return false;
+    }
+
+    printf("Message rate set : 0x%" PRIx8 " , 0x%" PRIx8 " every %" PRIu8 " epochs\r\n",
+        messageClass, messageID, rate);
+    return true;
+}
+
+bool UBloxGen8::sendMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate, bool waitForACK)
 {
     static constexpr size_t DATA_LEN = 3;
     uint8_t data[DATA_LEN];
 
-    data[0] = messageClass;                          // byte 0: class
-    data[1] = messageID;                             // byte 1: ID
-    data[2] = static_cast<uint8_t>(enabled ? 1 : 0); // byte 2: rate
+    data[0] = messageClass; // byte 0: class
+    data[1] = messageID;    // byte 1: ID
+    data[2] = rate;         // byte 2: rate on the current port
 
-    if (!sendCommand(UBX_CLASS_CFG, UBX_CFG_MSG, data, DATA_LEN, true, false, 500ms))
+    if (!sendCommand(UBX_CLASS_CFG, UBX_CFG_MSG, data, DATA_LEN, waitForACK, false, 500ms))
     {
-        printf(
-            "Message NOT enabled : 0x%" PRIx8 " , 0x%" PRIx8 " \r\n", messageClass, messageID);
         return false;
     }
-    else
-    {
-        printf(
-            "Message Enabled : 0x%" PRIx8 " , 0x%" PRIx8 " \r\n", messageClass, messageID);
-        return true;
-    }
+
+    // Without the ACK, the rate is recorded once it is sent.  A NACK fails configuration anyway.
+    recordMessageRate(messageClass, messageID, rate);
+    return true;
+}
+
+bool UBloxGen8::sendMeasurementPeriod(uint16_t periodMs)
+{
+    static constexpr size_t DATA_LEN = 6;
+    uint8_t data[DATA_LEN];
+
+    data[0] = periodMs & 0xFF; // measRate (ms)
+    data[1] = periodMs >> 8;
+    data[2] = 1; // navRate: one solution per measurement
+    data[3] = 0;
+    data[4] = 1; // timeRef: align measurements to GPS time
+    data[5] = 0;
+
+    return sendCommand(UBX_CLASS_CFG, UBX_CFG_RATE, data, DATA_LEN, true, false, 500ms);
 }
 
 
-bool UBloxGen8::saveSettings()
+bool UBloxGen8::saveSettings(bool waitForACK)
 {
     static constexpr size_t DATA_LEN = 13;
     uint8_t data[DATA_LEN];
@@ -171,6 +207,6 @@ bool UBloxGen8::saveSettings()
     // Save in battery-backed RAM and flash.
     data[12] = 0b11;
 
-    return sendCommand(UBX_CLASS_CFG, UBX_CFG_CFG, data, DATA_LEN, true, false, 1s);
+    return sendCommand(UBX_CLASS_CFG, UBX_CFG_CFG, data, DATA_LEN, waitForACK, false, 1s);
 }
 }
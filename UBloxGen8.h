@@ -17,16 +17,21 @@ namespace UBlox
 class UBloxGen8 : virtual public UBloxGPS
 {
 public:
-    /**
-     * @brief see UBloxGPS::configure
-     */
-    virtual bool configure() override;
-
     int getGPSGeneration() override
     {
         return 8;
     }
 
+    /**
+     * @brief see UBloxGPS::enableTimemarkOutput
+     */
+    bool enableTimemarkOutput(bool enabled) override;
+
+    /**
+     * @brief see UBloxGPS::setMessageRate.  Sends UBX-CFG-MSG and waits for the ACK.
+     */
+    bool setMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate) override;
+
     /**
      * Enables timepulse functionality for the sensor
      */
@@ -36,20 +41,47 @@ protected:
     /**
      * The MAX8U class should not (and can not) be directly instantiated, since it virtually
      * inherits from UBloxGPS. Instead, either MAX8USPI or MAX8UI2C should be instantiated.
+     *
+     * @param portID U-Blox ID of the port that the GPS is connected through (e.g. MSGOUT_OFFSET_I2C).
      */
-    UBloxGen8();
+    explicit UBloxGen8(uint8_t portID);
+
+    /** ID of the port that the GPS is connected through */
+    uint8_t portID_;
 
     /** Set serial protocol-specific bits in UBX-CFG-PRT payload */
     virtual void setCFG_PRTPayload(uint8_t *data) = 0;
 
+    /**
+     * @brief see UBloxGPS::sendBaudRateCommand
+     */
+    bool sendBaudRateCommand(uint32_t baudRate) override;
+
+    /**
+     * @brief see UBloxGPS::sendMeasurementPeriod
+     */
+    bool sendMeasurementPeriod(uint16_t periodMs) override;
+
+    /**
+     * @brief see UBloxGPS::getNumConfigurationSteps
+     */
+    size_t getNumConfigurationSteps() const override;
+
+    /**
+     * @brief see UBloxGPS::sendConfigurationStep.  Sets the port we are connected to to UBX only,
+     * enables NAV-PVT and, if isSavingConfiguration(), saves the settings.
+     */
+    bool sendConfigurationStep(size_t step) override;
+
 private:
+    /** Length of the UBX-CFG-PRT payload */
+    static constexpr uint16_t CFG_PRT_LEN = 20;
+
     /**
-     * Tells the GPS to enable the message indicated by messageClass and messageID
-     * This is done by sending a message to the GPS and then waiting for an ack message
-     *
-     * @return true if an ack message has been received from the gps
+     * @brief Fill in the UBX-CFG-PRT payload for the port we are connected to, with UBX
+     * input and output enabled.
      */
-    bool setMessageEnabled(uint8_t messageClass, uint8_t messageID, bool enabled);
+    void buildCFG_PRTPayload(uint8_t* data);
 
     /**
      * @brief Save all the current settings so that they will be loaded
@@ -57,9 +89,16 @@ private:
      * battery power is removed from the module.  Also, on modules with flash memory (does not include the MAX-8),
      * the settings are saved permanently in flash.
      *
+     * @param waitForACK whether to wait for the GPS to acknowledge the command
+     *
      * @return true if the operation was successful, false otherwise.
      */
-    bool saveSettings();
+    bool saveSettings(bool waitForACK = true);
+
+    /**
+     * @brief Implementation of setMessageRate(), which can optionally skip waiting for the ACK.
+     */
+    bool sendMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate, bool waitForACK);
 };
 
 }
@@ -7,7 +7,47 @@
 namespace UBlox
 {
 
-bool UBloxGen9::setValue(uint32_t key, uint64_t value, uint8_t layers)
+namespace
+{
+struct MessageOutputKey
+{
+    uint8_t messageClass;
+    uint8_t messageID;
+    uint32_t key;
+};
+
+// CFG-MSGOUT keys (for I2C) of the messages which setMessageRate() can set.  RTCM3 messages are
+// listed under the class and IDs which CFG-MSG uses for them.
+constexpr MessageOutputKey MESSAGE_OUTPUT_KEYS[] = {
+    { UBX_CLASS_NAV, UBX_NAV_PVT, CFG_MSGOUT_UBX_NAV_PVT },
+    { UBX_CLASS_NAV, UBX_NAV_POSLLH, CFG_MSGOUT_UBX_NAV_POSLLH },
+    { UBX_CLASS_NAV, UBX_NAV_SAT, CFG_MSGOUT_UBX_NAV_SAT },
+    { UBX_CLASS_NAV, UBX_NAV_VELNED, CFG_MSGOUT_UBX_NAV_VELNED },
+    { UBX_CLASS_NAV, UBX_NAV_TIMELS, CFG_MSGOUT_UBX_NAV_TIMELS },
+    { UBX_CLASS_NAV, UBX_NAV_HPPOSLLH, CFG_MSGOUT_UBX_NAV_HPPOSLLH },
+    { UBX_CLASS_NAV, UBX_NAV_HPPOSECEF, CFG_MSGOUT_UBX_NAV_HPPOSECEF },
+    { UBX_CLASS_NAV, UBX_NAV_RELPOSNED, CFG_MSGOUT_UBX_NAV_RELPOSNED },
+    { UBX_CLASS_NAV, UBX_NAV_COV, CFG_MSGOUT_UBX_NAV_COV },
+    { UBX_CLASS_NAV, UBX_NAV_DOP, CFG_MSGOUT_UBX_NAV_DOP },
+    { UBX_CLASS_NAV, UBX_NAV_EOE, CFG_MSGOUT_UBX_NAV_EOE },
+    { UBX_CLASS_NAV, UBX_NAV_STATUS, CFG_MSGOUT_UBX_NAV_STATUS },
+    { UBX_CLASS_MON, UBX_MON_RF, CFG_MSGOUT_UBX_MON_RF },
+    { UBX_CLASS_MON, UBX_MON_HW, CFG_MSGOUT_UBX_MON_HW },
+    { UBX_CLASS_SEC, UBX_SEC_SIG, CFG_MSGOUT_UBX_SEC_SIG },
+    { UBX_CLASS_RXM, UBX_RXM_RAWX, CFG_MSGOUT_UBX_RXM_RAWX },
+    { UBX_CLASS_TIM, UBX_TIM_TM2, CFG_MSGOUT_UBX_TIM_TM2 },
+    { UBX_CLASS_RTCM3, UBX_RTCM3_1005, CFG_MSGOUT_RTCM_3X_TYPE1005 },
+    { UBX_CLASS_RTCM3, UBX_RTCM3_1074, CFG_MSGOUT_RTCM_3X_TYPE1074 },
+    { UBX_CLASS_RTCM3, UBX_RTCM3_1077, CFG_MSGOUT_RTCM_3X_TYPE1077 },
+    { UBX_CLASS_RTCM3, UBX_RTCM3_1084, CFG_MSGOUT_RTCM_3X_TYPE1084 },
+    { UBX_CLASS_RTCM3, UBX_RTCM3_1094, CFG_MSGOUT_RTCM_3X_TYPE1094 },
+    { UBX_CLASS_RTCM3, UBX_RTCM3_1124, CFG_MSGOUT_RTCM_3X_TYPE1124 },
+    { UBX_CLASS_RTCM3, UBX_RTCM3_1230, CFG_MSGOUT_RTCM_3X_TYPE1230 },
+    { UBX_CLASS_RTCM3, UBX_RTCM3_4072_0, CFG_MSGOUT_RTCM_3X_TYPE4072_0 },
+};
+}
+
+bool UBloxGen9::setValue(uint32_t key, uint64_t value, uint8_t layers, bool waitForACK)
 {
     static constexpr int SETUP_BYTES = 4;
     static constexpr int KEY_SIZE = sizeof(key);
@@ -33,7 +73,7 @@ bool UBloxGen9::setValue(uint32_t key, uint64_t value, uint8_t layers)
     memcpy(data + SETUP_BYTES, &key, KEY_SIZE);
     memcpy(data + SETUP_BYTES + KEY_SIZE, &value, valueLen); // Assuming little endinaness
 
-    if (!sendCommand(UBX_CLASS_CFG, UBX_CFG_VALSET, data, totalLen, true, false, 1s))
+    if (!sendCommand(UBX_CLASS_CFG, UBX_CFG_VALSET, data, totalLen, waitForACK, false, 1s))
     {
         printf("Ublox GPS: Failed to set value!\r\n");
         return false;
@@ -47,22 +87,167 @@ bool UBloxGen9::setPlatformModel(UBloxGen9::PlatformModel model)
     return setValue(CFG_NAVSPG_DYNMODEL, static_cast<uint8_t>(model));
 }
 
-bool UBloxGen9::configure()
+UBloxGen9::PortProtocolKeys UBloxGen9::getPortProtocolKeys() const
+{
+    switch (msgOutOffset_)
+    {
+        case MSGOUT_OFFSET_I2C:
+            return { CFG_I2CINPROT_UBX, CFG_I2CINPROT_NMEA, CFG_I2CINPROT_RTCM3X,
+                CFG_I2COUTPROT_UBX, CFG_I2COUTPROT_NMEA, CFG_I2COUTPROT_RTCM3X };
+        case MSGOUT_OFFSET_UART1:
+            return { CFG_UART1INPROT_UBX, CFG_UART1INPROT_NMEA, CFG_UART1INPROT_RTCM3X,
+                CFG_UART1OUTPROT_UBX, CFG_UART1OUTPROT_NMEA, CFG_UART1OUTPROT_RTCM3X };
+        case MSGOUT_OFFSET_SPI:
+        default:
+            return { CFG_SPIINPROT_UBX, CFG_SPIINPROT_NMEA, CFG_SPIINPROT_RTCM3X,
+                CFG_SPIOUTPROT_UBX, CFG_SPIOUTPROT_NMEA, CFG_SPIOUTPROT_RTCM3X };
+    }
+}
+
+bool UBloxGen9::enableRTCMInput(bool enabled)
+{
+    return setValue(getPortProtocolKeys().inRTCM3, enabled ? 1 : 0);
+}
+
+bool UBloxGen9::setRTCMOutputRate(RTCMMessage message, uint8_t rate)
 {
-    // switch to UBX mode
+    // Go through setMessageRate() so that the rate is recorded for bandwidth budgeting
+    for (const MessageOutputKey& entry : MESSAGE_OUTPUT_KEYS)
+    {
+        if (entry.key == static_cast<uint32_t>(message))
+        {
+            return setMessageRate(entry.messageClass, entry.messageID, rate);
+        }
+    }
+    return false;
+}
+
+bool UBloxGen9::enableRTCMOutput(bool enabled)
+{
+    // Station position and GLONASS biases change rarely, so are sent every 5 epochs.  MSM4
+    // observations are sent every epoch.
+    bool ret = true;
+    ret &= setValue(getPortProtocolKeys().outRTCM3, enabled ? 1 : 0);
+    ret &= setRTCMOutputRate(RTCMMessage::STATION_ARP_1005, enabled ? 5 : 0);
+    ret &= setRTCMOutputRate(RTCMMessage::GPS_MSM4_1074, enabled ? 1 : 0);
+    ret &= setRTCMOutputRate(RTCMMessage::GLONASS_MSM4_1084, enabled ? 1 : 0);
+    ret &= setRTCMOutputRate(RTCMMessage::GALILEO_MSM4_1094, enabled ? 1 : 0);
+    ret &= setRTCMOutputRate(RTCMMessage::BEIDOU_MSM4_1124, enabled ? 1 : 0);
+    ret &= setRTCMOutputRate(RTCMMessage::GLONASS_BIASES_1230, enabled ? 5 : 0);
+    return ret;
+}
+
+bool UBloxGen9::enableMovingBaseOutput(bool enabled)
+{
+    // The rover needs every message every epoch to compute the heading
+    const uint8_t rate = enabled ? 1 : 0;
+
     bool ret = true;
-    ret &= setValue(CFG_SPIINPROT_NMEA, 0);
-    ret &= setValue(CFG_SPIINPROT_UBX, 1);
+    ret &= setValue(getPortProtocolKeys().outRTCM3, enabled ? 1 : 0);
+    ret &= setRTCMOutputRate(RTCMMessage::MOVING_BASE_4072_0, rate);
+    ret &= setRTCMOutputRate(RTCMMessage::GPS_MSM4_1074, rate);
+    ret &= setRTCMOutputRate(RTCMMessage::GLONASS_MSM4_1084, rate);
+    ret &= setRTCMOutputRate(RTCMMessage::GALILEO_MSM4_1094, rate);
+    ret &= setRTCMOutputRate(RTCMMessage::BEIDOU_MSM4_1124, rate);
+    ret &= setRTCMOutputRate(RTCMMessage::GLONASS_BIASES_1230, rate);
+    return ret;
+}
+
+bool UBloxGen9::sendBaudRateCommand(uint32_t baudRate)
+{
+    // The GPS switches rate as soon as it processes this, so its ACK can't be relied on.  RAM
+    // only, like UBX-CFG-PRT on Gen8, so that a rate which turns out not to work is undone by a
+    // power cycle.
+    return setValue(CFG_UART1_BAUDRATE, baudRate, 0x1, false);
+}
+
+bool UBloxGen9::enableTimemarkOutput(bool enabled)
+{
+    return setMessageRate(UBX_CLASS_TIM, UBX_TIM_TM2, enabled ? 1 : 0);
+}
+
+uint32_t UBloxGen9::getMessageOutputKey(uint8_t messageClass, uint8_t messageID)
+{
+    for (const MessageOutputKey& entry : MESSAGE_OUTPUT_KEYS)
+    {
+        if (entry.messageClass == messageClass && entry.messageID == messageID)
+        {
+            return entry.key;
+        }
+    }
+    return 0;
+}
+
+bool UBloxGen9::setMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate)
+{
+    // Rates scaled by setNavigationRate() go to RAM only, so that they don't wear the flash
+    const uint8_t layers = isScalingMessageRates() ? 0x1 : 0x7;
+    return sendMessageRate(messageClass, messageID, rate, true, layers);
+}
 
-    ret &= setValue(CFG_SPIOUTPROT_NMEA, 0);
-    ret &= setValue(CFG_SPIOUTPROT_UBX, 1);
-    ret &= setValue(CFG_MSGOUT_UBX_NAV_PVT + msgOutOffset_, 1);
+bool UBloxGen9::sendMessageRate(
+    uint8_t messageClass, uint8_t messageID, uint8_t rate, bool waitForACK, uint8_t layers)
+{
+    const uint32_t key = getMessageOutputKey(messageClass, messageID);
+    if (key == 0)
+    {
+        printf("%s: no output rate key for message 0x%" PRIx8 " , 0x%" PRIx8 "\r\n", getName(),
+            messageClass, messageID);
+        return false;
+    }
 
-    // Explicitly disable raw gps logging
-    ret &= setValue(CFG_MSGOUT_UBX_RXM_RAWX + msgOutOffset_, 0);
+    if (!setValue(key + msgOutOffset_, rate, layers, waitForACK))
+    {
+        return false;
+    }
 
-    ret &= setValue(CFG_HW_ANT_CFG_VOLTCTRL, 1);
+    // Without the ACK, the rate is recorded once it is sent.  A NACK fails configuration anyway.
+    recordMessageRate(messageClass, messageID, rate);
+    return true;
+}
+
+bool UBloxGen9::sendMeasurementPeriod(uint16_t periodMs)
+{
+    // RAM only, like the UBX-CFG-RATE sent to the MAX-8, since this can change at runtime
+    bool ret = true;
+    ret &= setValue(CFG_RATE_MEAS, periodMs, 0x1);
+    ret &= setValue(CFG_RATE_NAV, 1, 0x1);
     return ret;
 }
 
+size_t UBloxGen9::getNumConfigurationSteps() const
+{
+    return 7;
+}
+
+bool UBloxGen9::sendConfigurationStep(size_t step)
+{
+    // switch the port we are connected to into UBX mode
+    const PortProtocolKeys keys = getPortProtocolKeys();
+
+    // RAM only, or RAM, BBR and flash
+    const uint8_t layers = isSavingConfiguration() ? 0x7 : 0x1;
+
+    switch (step)
+    {
+        case 0:
+            return setValue(keys.inNMEA, 0, layers, false);
+        case 1:
+            return setValue(keys.inUBX, 1, layers, false);
+        case 2:
+            return setValue(keys.outNMEA, 0, layers, false);
+        case 3:
+            return setValue(keys.outUBX, 1, layers, false);
+        case 4:
+            return sendMessageRate(UBX_CLASS_NAV, UBX_NAV_PVT, 1, false, layers);
+        case 5:
+            // Explicitly disable raw gps logging
+            return sendMessageRate(UBX_CLASS_RXM, UBX_RXM_RAWX, 0, false, layers);
+        case 6:
+            return setValue(CFG_HW_ANT_CFG_VOLTCTRL, 1, layers, false);
+        default:
+            return false;
+    }
+}
+
 }
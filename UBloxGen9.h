@@ -45,16 +45,81 @@ public:
      */
     bool setPlatformModel(PlatformModel model);
 
-    /**
-     * @brief see UBloxGPS::configure
-     */
-    bool configure() override;
-
     int getGPSGeneration() override
     {
         return 9;
     }
 
+    /**
+     * @brief see UBloxGPS::enableTimemarkOutput
+     */
+    bool enableTimemarkOutput(bool enabled) override;
+
+    /**
+     * @brief see UBloxGPS::setMessageRate.  Only the messages which this driver knows the
+     * CFG-MSGOUT key of (see getMessageOutputKey()) can be set.  Rates scaled by
+     * UBloxGPS::setNavigationRate() are written to RAM only.
+     */
+    bool setMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate) override;
+
+    /**
+     * @brief Enable or disable RTCM3 correction input on the port we are connected to, which is
+     * needed for UBloxGPS::injectRTCMFrame().  It is enabled by default on new units.
+     *
+     * @return true if the setting was acknowledged by the GPS
+     */
+    bool enableRTCMInput(bool enabled);
+
+    /**
+     * RTCM3 messages which the ZED-F9P can output, e.g. when acting as a base station.
+     */
+    enum class RTCMMessage : uint32_t
+    {
+        STATION_ARP_1005 = CFG_MSGOUT_RTCM_3X_TYPE1005,
+        GPS_MSM4_1074 = CFG_MSGOUT_RTCM_3X_TYPE1074,
+        GPS_MSM7_1077 = CFG_MSGOUT_RTCM_3X_TYPE1077,
+        GLONASS_MSM4_1084 = CFG_MSGOUT_RTCM_3X_TYPE1084,
+        GALILEO_MSM4_1094 = CFG_MSGOUT_RTCM_3X_TYPE1094,
+        BEIDOU_MSM4_1124 = CFG_MSGOUT_RTCM_3X_TYPE1124,
+        GLONASS_BIASES_1230 = CFG_MSGOUT_RTCM_3X_TYPE1230,
+        MOVING_BASE_4072_0 = CFG_MSGOUT_RTCM_3X_TYPE4072_0
+    };
+
+    /**
+     * @brief Set how often an RTCM3 message is output on the port we are connected to.  Like
+     * setMessageRate(), the rate is recorded for setNavigationRate()'s bandwidth budget.
+     *
+     * @note MSM7 messages can be longer than UBLOX_GNSS_RX_BUFFER_SIZE, in which case they are
+     * dropped and counted in DriverStatistics::rtcmFramesTooLong.
+     *
+     * @param message Message to configure
+     * @param rate Output once every this many navigation epochs, or 0 to disable it
+     * @return true if the setting was acknowledged by the GPS
+     */
+    bool setRTCMOutputRate(RTCMMessage message, uint8_t rate);
+
+    /**
+     * @brief Enable or disable the RTCM3 messages needed by an RTK rover (1005, 1074, 1084, 1094,
+     * 1124 and 1230) on the port we are connected to.
+     *
+     * @note The GPS only outputs observations once it is in survey-in or fixed (base station)
+     * mode.  Received frames are passed to the callback set with UBloxGPS::attachRTCMOutput().
+     *
+     * @return true if all settings were acknowledged by the GPS
+     */
+    bool enableRTCMOutput(bool enabled);
+
+    /**
+     * @brief Enable or disable the RTCM3 messages needed by a moving base rover (4072.0, 1074,
+     * 1084, 1094, 1124 and 1230, every epoch) on the port we are connected to.
+     *
+     * @note Unlike enableRTCMOutput(), this works without survey-in, since the base's position is
+     * sent in 4072.0 every epoch.  See MovingBaseLink for connecting two receivers.
+     *
+     * @return true if all settings were acknowledged by the GPS
+     */
+    bool enableMovingBaseOutput(bool enabled);
+
 protected:
 
     uint8_t msgOutOffset_;
@@ -78,12 +143,70 @@ protected:
      * @param value The value associated with the key. It takes care of the size of the int
      * @param layers bitmask which indicates the layer to save the config on the GPS. Flash, BBR,
      *               and RAM
+     * @param waitForACK whether to wait for the GPS to acknowledge the setting
      * @return true if setting was successful and ACK is received.
      */
-    bool setValue(uint32_t key, uint64_t value, uint8_t layers = 0x7);
+    bool setValue(uint32_t key, uint64_t value, uint8_t layers = 0x7, bool waitForACK = true);
+
+    /**
+     * @brief see UBloxGPS::sendBaudRateCommand
+     */
+    bool sendBaudRateCommand(uint32_t baudRate) override;
+
+    /**
+     * @brief see UBloxGPS::sendMeasurementPeriod
+     */
+    bool sendMeasurementPeriod(uint16_t periodMs) override;
+
+    /**
+     * @brief see UBloxGPS::getNumConfigurationSteps
+     */
+    size_t getNumConfigurationSteps() const override;
+
+    /**
+     * @brief see UBloxGPS::sendConfigurationStep.  Sets the port we are connected to to UBX only,
+     * enables NAV-PVT, disables RXM-RAWX and enables antenna voltage control.  The settings go
+     * to the RAM layer only unless isSavingConfiguration().
+     */
+    bool sendConfigurationStep(size_t step) override;
 
 private:
     const char* getName() override { return "ZED-F9P"; };
+
+    /**
+     * @brief Configuration keys for the protocols enabled on a port
+     */
+    struct PortProtocolKeys
+    {
+        uint32_t inUBX;
+        uint32_t inNMEA;
+        uint32_t inRTCM3;
+        uint32_t outUBX;
+        uint32_t outNMEA;
+        uint32_t outRTCM3;
+    };
+
+    /**
+     * @brief Get the protocol configuration keys of the port we are connected to
+     */
+    PortProtocolKeys getPortProtocolKeys() const;
+
+    /**
+     * @brief Get the CFG-MSGOUT key which sets the I2C output rate of a UBX message, or of an
+     * RTCM3 message under UBX_CLASS_RTCM3.  Add
+     * msgOutOffset_ to get the key for our port.
+     *
+     * @return the key, or 0 if the message is not known
+     */
+    static uint32_t getMessageOutputKey(uint8_t messageClass, uint8_t messageID);
+
+    /**
+     * @brief Implementation of setMessageRate(), which can optionally skip waiting for the ACK.
+     *
+     * @param layers see setValue()
+     */
+    bool sendMessageRate(
+        uint8_t messageClass, uint8_t messageID, uint8_t rate, bool waitForACK, uint8_t layers = 0x7);
 };
 
 };
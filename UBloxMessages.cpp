@@ -1,5 +1,6 @@
 #include "UBloxMessages.h"
 #include "UBloxGPSConstants.h"
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <cstdio>
@@ -78,6 +79,7 @@ VelocityNED parseNAV_VELNED(const uint8_t* msgBuffer)
     velocity.eastVel = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 8);
     velocity.downVel = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 12);
     velocity.speed3D = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 16);
+    velocity.speedAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 28);
 
 #if UBLOX_GNSS_DEBUG
     printf("Got NAV_VELNED message.  North Vel=%" PRIi32 ", East Vel=%" PRIi32
@@ -101,6 +103,7 @@ UtcTime parseNAV_TIMEUTC(const uint8_t* msgBuffer)
     time.hour = msgBuffer[UBX_DATA_OFFSET + 16];
     time.minute = msgBuffer[UBX_DATA_OFFSET + 17];
     time.second = msgBuffer[UBX_DATA_OFFSET + 18];
+    time.nanosecond = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 8);
 
 #if UBLOX_GNSS_DEBUG
     printf("Got NAV_TIMEUTC message.  year=%" PRIu16 ", month =%" PRIu8 ", day=%" PRIu8
@@ -143,6 +146,71 @@ Timepulse parseTIM_TP(const uint8_t* msgBuffer)
     return pulse;
 }
 
+TimemarkEvent parseTIM_TM2(const uint8_t* msgBuffer)
+{
+    TimemarkEvent event;
+
+    // Convert sub-millisecond times from ns to GPSTow units (2^-32 ms), rounding up
+    auto subMsToTow = [](uint32_t subMsNs) -> uint32_t
+    { return static_cast<uint32_t>(((static_cast<uint64_t>(subMsNs) << 32) + 999999) / 1000000); };
+
+    uint8_t flags = msgBuffer[UBX_DATA_OFFSET + 1];
+
+    event.channel = msgBuffer[UBX_DATA_OFFSET + 0];
+    event.count = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 2);
+    event.risingEdge.weekNumber = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 4);
+    event.fallingEdge.weekNumber = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 6);
+    event.risingEdge.timeOfWeek = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 8);
+    event.risingEdge.subTimeOfWeek
+        = subMsToTow(readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 12));
+    event.fallingEdge.timeOfWeek = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 16);
+    event.fallingEdge.subTimeOfWeek
+        = subMsToTow(readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 20));
+    event.accuracyEstimate = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 24);
+
+    event.newFallingEdge = flags & (1 << 2);
+    event.timeBase = static_cast<TimemarkTimeBase>((flags >> 3) & 0x3);
+    event.utcAvailable = flags & (1 << 5);
+    event.timeValid = flags & (1 << 6);
+    event.newRisingEdge = flags & (1 << 7);
+
+#if UBLOX_GNSS_DEBUG
+    printf("Got TIM-TM2 message.  channel=%" PRIu8 ", count=%" PRIu16 ", rising edge tow=%" PRIu32
+           " ms, falling edge tow=%" PRIu32 " ms, flags=0x%" PRIx8 "\r\n",
+        event.channel,
+        event.count,
+        event.risingEdge.timeOfWeek,
+        event.fallingEdge.timeOfWeek,
+        flags);
+#endif
+
+    return event;
+}
+
+LeapSecondInfo parseNAV_TIMELS(const uint8_t* msgBuffer)
+{
+    LeapSecondInfo info;
+
+    uint8_t valid = msgBuffer[UBX_DATA_OFFSET + 23];
+    info.currentLeapSeconds = static_cast<int8_t>(msgBuffer[UBX_DATA_OFFSET + 9]);
+    info.currentValid = valid & 0x1;
+    info.upcomingChange = static_cast<int8_t>(msgBuffer[UBX_DATA_OFFSET + 11]);
+    info.timeToChange = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 12);
+    info.changeValid = valid & 0x2;
+
+#if UBLOX_GNSS_DEBUG
+    printf("Got NAV_TIMELS message.  Leap seconds=%" PRIi8 " (valid=%d), upcoming change=%" PRIi8
+           " in %" PRIi32 " s (valid=%d)\r\n",
+        info.currentLeapSeconds,
+        info.currentValid,
+        info.upcomingChange,
+        info.timeToChange,
+        info.changeValid);
+#endif
+
+    return info;
+}
+
 void parseNAV_PVT(const uint8_t* msgBuffer, GeodeticPosition& pos, VelocityNED& velocity,
     FixQuality& fix, UtcTime& time)
 {
@@ -151,11 +219,13 @@ void parseNAV_PVT(const uint8_t* msgBuffer, GeodeticPosition& pos, VelocityNED&
     pos.latitude = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 28) * 1e-7;
     pos.height = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 32);
 
+    // NAV-PVT reports velocity in mm/s, unlike NAV-VELNED (cm/s).  Keep the full resolution.
     velocity.northVel = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 48);
     velocity.eastVel = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 52);
     velocity.downVel = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 56);
     velocity.speed3D
         = sqrt(pow(velocity.northVel, 2) + pow(velocity.eastVel, 2) + pow(velocity.downVel, 2));
+    velocity.speedAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 68);
 
     fix.fixQuality = static_cast<GPSFix>(msgBuffer[UBX_DATA_OFFSET + 20]);
     fix.numSatellites = static_cast<uint8_t>(msgBuffer[UBX_DATA_OFFSET + 23]);
@@ -169,6 +239,7 @@ void parseNAV_PVT(const uint8_t* msgBuffer, GeodeticPosition& pos, VelocityNED&
     time.hour = static_cast<uint8_t>(msgBuffer[UBX_DATA_OFFSET + 8]);
     time.minute = static_cast<uint8_t>(msgBuffer[UBX_DATA_OFFSET + 9]);
     time.second = static_cast<uint8_t>(msgBuffer[UBX_DATA_OFFSET + 10]);
+    time.nanosecond = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 16);
 
 #if UBLOX_GNSS_DEBUG
     printf("Got NAV PVT: Longitude=%.06f deg, Latitude=%.06f deg, Height=%" PRIi32" mm\r\n",
@@ -178,4 +249,301 @@ void parseNAV_PVT(const uint8_t* msgBuffer, GeodeticPosition& pos, VelocityNED&
 #endif
 }
 
+HighPrecisionGeodeticPosition parseNAV_HPPOSLLH(const uint8_t* msgBuffer)
+{
+    HighPrecisionGeodeticPosition position;
+
+    // Combine the coarse (1e-7 deg, mm) and fine (1e-9 deg, 0.1 mm) parts
+    position.iTOW = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 4);
+    position.longitude = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 8)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 24);
+    position.latitude = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 12)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 25);
+    position.height = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 16)) * 10
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 26);
+    position.heightMSL = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 20)) * 10
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 27);
+    position.horizontalAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 28);
+    position.verticalAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 32);
+
+    // Bit 0 of the flags byte is invalidLlh
+    position.valid = !(msgBuffer[UBX_DATA_OFFSET + 3] & 0x01);
+
+    return position;
+}
+
+HighPrecisionECEFPosition parseNAV_HPPOSECEF(const uint8_t* msgBuffer)
+{
+    HighPrecisionECEFPosition position;
+
+    // Combine the coarse (cm) and fine (0.1 mm) parts
+    position.iTOW = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 4);
+    position.x = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 8)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 20);
+    position.y = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 12)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 21);
+    position.z = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 16)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 22);
+    position.accuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 24);
+
+    // Bit 0 of the flags byte is invalidEcef
+    position.valid = !(msgBuffer[UBX_DATA_OFFSET + 23] & 0x01);
+
+    return position;
+}
+
+RelativePositionNED parseNAV_RELPOSNED(const uint8_t* msgBuffer)
+{
+    RelativePositionNED relPos{};
+
+    if (msgBuffer[UBX_DATA_OFFSET] != 0x01)
+    {
+        // Version 0 (M8P) has a different layout
+        return relPos;
+    }
+
+    relPos.referenceStationID = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 2);
+    relPos.iTOW = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 4);
+
+    // Combine the coarse (cm) and fine (0.1 mm) parts
+    relPos.north = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 8)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 32);
+    relPos.east = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 12)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 33);
+    relPos.down = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 16)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 34);
+    relPos.length = static_cast<int64_t>(readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 20)) * 100
+        + readUnalignedValue<int8_t>(msgBuffer, UBX_DATA_OFFSET + 35);
+    relPos.heading = readUnalignedValue<int32_t>(msgBuffer, UBX_DATA_OFFSET + 24);
+
+    relPos.northAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 36);
+    relPos.eastAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 40);
+    relPos.downAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 44);
+    relPos.lengthAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 48);
+    relPos.headingAccuracy = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 52);
+    relPos.flags = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET + 60);
+
+    return relPos;
+}
+
+void parseNAV_COV(const uint8_t* msgBuffer, NavigationCovariance& covariance)
+{
+    covariance.iTOW = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET);
+    covariance.positionValid = msgBuffer[UBX_DATA_OFFSET + 5] != 0;
+    covariance.velocityValid = msgBuffer[UBX_DATA_OFFSET + 6] != 0;
+
+    // The message holds the upper triangle (NN, NE, ND, EE, ED, DD) of each matrix
+    static constexpr size_t TRIANGLE_INDICES[6][2] = { { 0, 0 }, { 0, 1 }, { 0, 2 }, { 1, 1 },
+        { 1, 2 }, { 2, 2 } };
+    for (size_t i = 0; i < 6; i++)
+    {
+        const size_t row = TRIANGLE_INDICES[i][0];
+        const size_t col = TRIANGLE_INDICES[i][1];
+
+        const float position = readUnalignedValue<float>(msgBuffer, UBX_DATA_OFFSET + 16 + 4 * i);
+        covariance.positionCovariance[row * 3 + col] = position;
+        covariance.positionCovariance[col * 3 + row] = position;
+
+        const float velocity = readUnalignedValue<float>(msgBuffer, UBX_DATA_OFFSET + 40 + 4 * i);
+        covariance.velocityCovariance[row * 3 + col] = velocity;
+        covariance.velocityCovariance[col * 3 + row] = velocity;
+    }
+}
+
+DilutionOfPrecision parseNAV_DOP(const uint8_t* msgBuffer)
+{
+    DilutionOfPrecision dop;
+
+    dop.iTOW = readUnalignedValue<uint32_t>(msgBuffer, UBX_DATA_OFFSET);
+    dop.geometric = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 4);
+    dop.position = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 6);
+    dop.time = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 8);
+    dop.vertical = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 10);
+    dop.horizontal = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 12);
+    dop.northing = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 14);
+    dop.easting = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 16);
+
+    return dop;
+}
+
+void parseMON_RF(const uint8_t* msgBuffer, ReceiverHealth& health)
+{
+    static constexpr size_t BLOCK_OFFSET = 4;
+    static constexpr size_t BLOCK_LEN = 24;
+
+    const uint8_t numBlocks = msgBuffer[UBX_DATA_OFFSET + 1];
+    health.numBands = std::min<uint8_t>(numBlocks, ReceiverHealth::MAX_RF_BANDS);
+
+    for (size_t i = 0; i < health.numBands; i++)
+    {
+        const uint8_t* block = msgBuffer + UBX_DATA_OFFSET + BLOCK_OFFSET + i * BLOCK_LEN;
+        RFBandHealth& band = health.bands[i];
+
+        band.jammingState = static_cast<JammingState>(block[1] & 0x3);
+        band.noisePerMS = readUnalignedValue<uint16_t>(block, 12);
+        band.agcCount = readUnalignedValue<uint16_t>(block, 14);
+        band.jammingIndicator = block[16];
+
+        // Both bands share the antenna in single antenna designs, so the first block is used
+        if (i == 0)
+        {
+            health.antennaStatus = static_cast<AntennaStatus>(block[2]);
+            health.antennaPower = static_cast<AntennaPowerStatus>(block[3]);
+        }
+    }
+}
+
+void parseMON_HW(const uint8_t* msgBuffer, ReceiverHealth& health)
+{
+    RFBandHealth& band = health.bands[0];
+    band.noisePerMS = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 16);
+    band.agcCount = readUnalignedValue<uint16_t>(msgBuffer, UBX_DATA_OFFSET + 18);
+    band.jammingState = static_cast<JammingState>((msgBuffer[UBX_DATA_OFFSET + 22] >> 2) & 0x3);
+    band.jammingIndicator = msgBuffer[UBX_DATA_OFFSET + 45];
+    health.numBands = std::max<uint8_t>(health.numBands, 1);
+
+    health.antennaStatus = static_cast<AntennaStatus>(msgBuffer[UBX_DATA_OFFSET + 20]);
+    health.antennaPower = static_cast<AntennaPowerStatus>(msgBuffer[UBX_DATA_OFFSET + 21]);
+}
+
+void parseNAV_STATUS(const uint8_t* msgBuffer, ReceiverHealth& health)
+{
+    health.fixOK = msgBuffer[UBX_DATA_OFFSET + 5] & 0x01;
+
+    // SEC-SIG has a more detailed spoofing state, so use it once it has been received
+    if (health.securityTime.lastByte == std::chrono::microseconds(0))
+    {
+        health.spoofingState = static_cast<SpoofingState>((msgBuffer[UBX_DATA_OFFSET + 7] >> 3) & 0x3);
+    }
+}
+
+void parseSEC_SIG(const uint8_t* msgBuffer, ReceiverHealth& health)
+{
+    const uint8_t version = msgBuffer[UBX_DATA_OFFSET];
+
+    uint8_t jammingState;
+    uint8_t spoofingState;
+    if (version == 1)
+    {
+        jammingState = (msgBuffer[UBX_DATA_OFFSET + 4] >> 1) & 0x3;
+        spoofingState = (msgBuffer[UBX_DATA_OFFSET + 8] >> 1) & 0x7;
+    }
+    else
+    {
+        // Version 2 packs both into the sigSecFlags byte, before the variable length list of
+        // jammed center frequencies
+        const uint8_t sigSecFlags = msgBuffer[UBX_DATA_OFFSET + 1];
+        jammingState = (sigSecFlags >> 1) & 0x3;
+        spoofingState = (sigSecFlags >> 4) & 0x7;
+    }
+
+    // SEC-SIG's jamming state only distinguishes unknown/none/warning/critical like MON-RF does,
+    // so it is used for any band without its own monitor result.
+    for (size_t i = 0; i < health.numBands; i++)
+    {
+        if (health.bands[i].jammingState == JammingState::UNKNOWN)
+        {
+            health.bands[i].jammingState = static_cast<JammingState>(jammingState);
+        }
+    }
+
+    // SEC-SIG reports 3 for "spoofing affirmed", which is treated like multiple indications
+    health.spoofingState = static_cast<SpoofingState>(std::min<uint8_t>(spoofingState, 3));
+}
+
+void HighPrecisionAverage::add(const HighPrecisionGeodeticPosition& position)
+{
+    if (!position.valid)
+    {
+        return;
+    }
+
+    longitudeSum_ += position.longitude;
+    latitudeSum_ += position.latitude;
+    heightSum_ += position.height;
+    heightMSLSum_ += position.heightMSL;
+    horizontalAccuracySum_ += position.horizontalAccuracy;
+    verticalAccuracySum_ += position.verticalAccuracy;
+    count_++;
+    last_ = position;
+}
+
+HighPrecisionGeodeticPosition HighPrecisionAverage::getMean() const
+{
+    HighPrecisionGeodeticPosition mean = last_;
+    if (count_ == 0)
+    {
+        return mean;
+    }
+
+    // Divide, rounding half away from zero
+    const int64_t count = count_;
+    auto divide = [count](int64_t sum) {
+        return (sum >= 0 ? sum + count / 2 : sum - count / 2) / count;
+    };
+
+    mean.longitude = divide(longitudeSum_);
+    mean.latitude = divide(latitudeSum_);
+    mean.height = divide(heightSum_);
+    mean.heightMSL = divide(heightMSLSum_);
+    mean.horizontalAccuracy = static_cast<uint32_t>(divide(horizontalAccuracySum_));
+    mean.verticalAccuracy = static_cast<uint32_t>(divide(verticalAccuracySum_));
+    return mean;
+}
+
+uint16_t getTypicalPayloadLength(uint8_t messageClass, uint8_t messageID)
+{
+    // Signals assumed to be tracked when estimating variable length messages
+    static constexpr uint16_t NUM_SIGNALS = 32;
+
+    struct PayloadLength
+    {
+        uint8_t messageClass;
+        uint8_t messageID;
+        uint16_t length;
+    };
+    static constexpr PayloadLength lengths[] = {
+        { UBX_CLASS_NAV, UBX_NAV_PVT, 92 },
+        { UBX_CLASS_NAV, UBX_NAV_POSLLH, 28 },
+        { UBX_CLASS_NAV, UBX_NAV_SOL, 52 },
+        { UBX_CLASS_NAV, UBX_NAV_VELNED, 36 },
+        { UBX_CLASS_NAV, UBX_NAV_TIMEUTC, 20 },
+        { UBX_CLASS_NAV, UBX_NAV_TIMELS, 24 },
+        { UBX_CLASS_NAV, UBX_NAV_SAT, 8 + 12 * NUM_SIGNALS },
+        { UBX_CLASS_NAV, UBX_NAV_HPPOSLLH, 36 },
+        { UBX_CLASS_NAV, UBX_NAV_HPPOSECEF, 28 },
+        { UBX_CLASS_NAV, UBX_NAV_RELPOSNED, 64 },
+        { UBX_CLASS_NAV, UBX_NAV_COV, 64 },
+        { UBX_CLASS_NAV, UBX_NAV_DOP, 18 },
+        { UBX_CLASS_NAV, UBX_NAV_EOE, 4 },
+        { UBX_CLASS_NAV, UBX_NAV_STATUS, 16 },
+        { UBX_CLASS_MON, UBX_MON_RF, 4 + 24 * 2 },
+        { UBX_CLASS_SEC, UBX_SEC_SIG, 12 },
+        { UBX_CLASS_TIM, UBX_TIM_TP, 16 },
+        { UBX_CLASS_TIM, UBX_TIM_TM2, 28 },
+        { UBX_CLASS_RXM, UBX_RXM_RAWX, 16 + 32 * NUM_SIGNALS },
+        { UBX_CLASS_MON, UBX_MON_HW, 60 },
+
+        // RTCM3 payloads.  MSM messages are for one constellation, assumed to have half of the
+        // signals on 8 satellites.  MSM4 has 6 bytes per signal and MSM7 has 10.
+        { UBX_CLASS_RTCM3, UBX_RTCM3_1005, 19 },
+        { UBX_CLASS_RTCM3, UBX_RTCM3_1074, 24 + 8 * 3 + 6 * NUM_SIGNALS / 2 },
+        { UBX_CLASS_RTCM3, UBX_RTCM3_1077, 24 + 8 * 5 + 10 * NUM_SIGNALS / 2 },
+        { UBX_CLASS_RTCM3, UBX_RTCM3_1084, 24 + 8 * 3 + 6 * NUM_SIGNALS / 2 },
+        { UBX_CLASS_RTCM3, UBX_RTCM3_1094, 24 + 8 * 3 + 6 * NUM_SIGNALS / 2 },
+        { UBX_CLASS_RTCM3, UBX_RTCM3_1124, 24 + 8 * 3 + 6 * NUM_SIGNALS / 2 },
+        { UBX_CLASS_RTCM3, UBX_RTCM3_1230, 14 },
+        { UBX_CLASS_RTCM3, UBX_RTCM3_4072_0, 60 },
+    };
+
+    for (const PayloadLength& entry : lengths)
+    {
+        if (entry.messageClass == messageClass && entry.messageID == messageID)
+        {
+            return entry.length;
+        }
+    }
+    return 100;
+}
+
 }
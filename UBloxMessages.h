@@ -1,5 +1,6 @@
 #include <inttypes.h>
 #include <stdlib.h>
+#include <chrono>
 
 #ifndef UBLOX_MESSAGES
 #define UBLOX_MESSAGES
@@ -58,6 +59,27 @@ struct SatelliteInfo
     bool svUsed;
 };
 
+/**
+ * @brief Local (host) time at which a message was received from the GNSS.
+ *
+ * Times are in microseconds on the host's monotonic clock (mbed::HighResClock), so they can be
+ * compared with timestamps taken from other sensors.  Both are zero if no message has been
+ * received yet.
+ */
+struct RxTimestamp
+{
+    /**
+     * @brief Time at which the first byte of the message was received.  This is approximate for
+     * transports which read the message in chunks.
+     */
+    std::chrono::microseconds firstByte{0};
+
+    /**
+     * @brief Time at which the last byte of the message was received.
+     */
+    std::chrono::microseconds lastByte{0};
+};
+
 /**
  * @brief Indicates the quality of the GPS Fix
  */
@@ -82,6 +104,132 @@ enum class AntennaPowerStatus : uint8_t
     NO_MESSAGE_RCVD = 3
 };
 
+/**
+ * @brief Antenna supervisor status, used in the UBX_MON_RF and UBX_MON_HW messages
+ */
+enum class AntennaStatus : uint8_t
+{
+    INIT = 0,
+    DONT_KNOW = 1,
+    OK = 2,
+    SHORT = 3,
+    OPEN = 4
+};
+
+/**
+ * @brief Output of the receiver's jamming/interference monitor
+ */
+enum class JammingState : uint8_t
+{
+    UNKNOWN = 0,
+    OK = 1,
+    WARNING = 2,
+    CRITICAL = 3
+};
+
+/**
+ * @brief Output of the receiver's spoofing detector
+ */
+enum class SpoofingState : uint8_t
+{
+    UNKNOWN = 0,
+    NONE = 1,
+    INDICATED = 2,
+    MULTIPLE_INDICATED = 3
+};
+
+/**
+ * @brief RF front end status for one band, from UBX-MON-RF (or UBX-MON-HW on older receivers)
+ */
+struct RFBandHealth
+{
+    /**
+     * @brief Jamming state reported by the interference monitor
+     */
+    JammingState jammingState;
+
+    /**
+     * @brief Continuous wave jamming indicator, 0 (none) to 255 (strong)
+     */
+    uint8_t jammingIndicator;
+
+    /**
+     * @brief Automatic gain control count, 0 to 8191.  Drops sharply when broadband interference
+     * is present.
+     */
+    uint16_t agcCount;
+
+    /**
+     * @brief Noise level measured by the GNSS core
+     */
+    uint16_t noisePerMS;
+};
+
+/**
+ * @brief Snapshot of the receiver's health, built from the periodic MON-RF, MON-HW, NAV-STATUS
+ * and SEC-SIG messages.  See UBloxGPS::enableHealthMonitoring().
+ */
+struct ReceiverHealth
+{
+    static constexpr size_t MAX_RF_BANDS = 2;
+
+    AntennaStatus antennaStatus;
+    AntennaPowerStatus antennaPower;
+
+    /**
+     * @brief RF status of each band (L1, L2/L5).  MON-HW only reports the first.
+     */
+    RFBandHealth bands[MAX_RF_BANDS];
+
+    /**
+     * @brief Number of valid entries in bands
+     */
+    uint8_t numBands;
+
+    /**
+     * @brief Spoofing state from NAV-STATUS, or from SEC-SIG if the receiver outputs it
+     */
+    SpoofingState spoofingState;
+
+    /**
+     * @brief Whether the receiver considers its fix valid (gpsFixOk in NAV-STATUS)
+     */
+    bool fixOK;
+
+    /**
+     * @brief Host time at which each source of information was last received.  Zero if it has not
+     * been received yet.
+     */
+    RxTimestamp rfTime;
+    RxTimestamp statusTime;
+    RxTimestamp securityTime;
+
+    /**
+     * @brief Get the most severe jamming state of any band
+     */
+    JammingState getJammingState() const
+    {
+        JammingState worst = JammingState::UNKNOWN;
+        for (size_t i = 0; i < numBands; i++)
+        {
+            worst = bands[i].jammingState > worst ? bands[i].jammingState : worst;
+        }
+        return worst;
+    }
+
+    /**
+     * @brief Whether nothing is known to be wrong: the antenna is not shorted or open, there is no
+     * critical jamming, and no spoofing is indicated.
+     */
+    bool isHealthy() const
+    {
+        return antennaStatus != AntennaStatus::SHORT && antennaStatus != AntennaStatus::OPEN
+            && getJammingState() != JammingState::CRITICAL
+            && spoofingState != SpoofingState::INDICATED
+            && spoofingState != SpoofingState::MULTIPLE_INDICATED;
+    }
+};
+
 /**
  * @brief Structure to hold a geodetic position. (https://en.wikipedia.org/wiki/Geodetic_datum)
  *
@@ -102,6 +250,362 @@ struct GeodeticPosition
      * @brief Height above ellipsoid (mm)
      */
     int32_t height;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
+};
+
+/**
+ * @brief High precision geodetic position from UBX-NAV-HPPOSLLH, stored in fixed point so that
+ * none of the receiver's precision is lost.
+ *
+ * The message gives each coordinate as a coarse part (1e-7 deg or mm) plus a fine part (1e-9 deg
+ * or 0.1 mm), which are combined into a single integer.  Convert to floating point only when
+ * needed, with the accessors below.
+ */
+struct HighPrecisionGeodeticPosition
+{
+    static constexpr int64_t NANODEGREES_PER_DEGREE = 1000000000;
+    static constexpr int64_t TENTH_MM_PER_METER = 10000;
+
+    /**
+     * @brief GPS time of week of the navigation epoch (ms)
+     */
+    uint32_t iTOW;
+
+    /**
+     * @brief longitude (1e-9 degrees)
+     */
+    int64_t longitude;
+
+    /**
+     * @brief latitude (1e-9 degrees)
+     */
+    int64_t latitude;
+
+    /**
+     * @brief Height above ellipsoid (0.1 mm)
+     */
+    int64_t height;
+
+    /**
+     * @brief Height above mean sea level (0.1 mm)
+     */
+    int64_t heightMSL;
+
+    /**
+     * @brief Horizontal accuracy estimate (0.1 mm)
+     */
+    uint32_t horizontalAccuracy;
+
+    /**
+     * @brief Vertical accuracy estimate (0.1 mm)
+     */
+    uint32_t verticalAccuracy;
+
+    /**
+     * @brief Whether the position is valid.  It is invalid until the receiver has a fix.
+     */
+    bool valid;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
+
+    double longitudeDegrees() const
+    {
+        return static_cast<double>(longitude) / NANODEGREES_PER_DEGREE;
+    }
+
+    double latitudeDegrees() const
+    {
+        return static_cast<double>(latitude) / NANODEGREES_PER_DEGREE;
+    }
+
+    double heightMeters() const
+    {
+        return static_cast<double>(height) / TENTH_MM_PER_METER;
+    }
+
+    double heightMSLMeters() const
+    {
+        return static_cast<double>(heightMSL) / TENTH_MM_PER_METER;
+    }
+};
+
+/**
+ * @brief High precision ECEF position from UBX-NAV-HPPOSECEF, stored in fixed point.  The
+ * message's cm and 0.1 mm parts are combined into one integer per coordinate.
+ */
+struct HighPrecisionECEFPosition
+{
+    static constexpr int64_t TENTH_MM_PER_METER = 10000;
+
+    /**
+     * @brief GPS time of week of the navigation epoch (ms)
+     */
+    uint32_t iTOW;
+
+    /**
+     * @brief ECEF coordinates (0.1 mm)
+     */
+    int64_t x;
+    int64_t y;
+    int64_t z;
+
+    /**
+     * @brief Position accuracy estimate (0.1 mm)
+     */
+    uint32_t accuracy;
+
+    /**
+     * @brief Whether the position is valid.  It is invalid until the receiver has a fix.
+     */
+    bool valid;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
+
+    double xMeters() const
+    {
+        return static_cast<double>(x) / TENTH_MM_PER_METER;
+    }
+
+    double yMeters() const
+    {
+        return static_cast<double>(y) / TENTH_MM_PER_METER;
+    }
+
+    double zMeters() const
+    {
+        return static_cast<double>(z) / TENTH_MM_PER_METER;
+    }
+};
+
+/**
+ * @brief Type of carrier phase range solution, i.e. the RTK status
+ */
+enum class CarrierSolution : uint8_t
+{
+    NONE = 0,
+    FLOAT = 1,
+    FIXED = 2
+};
+
+/**
+ * @brief Position of the receiver relative to its RTK reference station (or moving base), from
+ * UBX-NAV-RELPOSNED.
+ *
+ * Distances combine the message's cm and 0.1 mm parts into one fixed point integer, as in
+ * HighPrecisionGeodeticPosition.
+ */
+struct RelativePositionNED
+{
+    /**
+     * @brief GPS time of week of the navigation epoch (ms)
+     */
+    uint32_t iTOW;
+
+    /**
+     * @brief Reference station ID
+     */
+    uint16_t referenceStationID;
+
+    /**
+     * @brief Vector from the reference station to the receiver (0.1 mm)
+     */
+    int64_t north;
+    int64_t east;
+    int64_t down;
+
+    /**
+     * @brief Length of the vector (0.1 mm)
+     */
+    int64_t length;
+
+    /**
+     * @brief Heading of the vector (1e-5 degrees).  Only valid if isHeadingValid().
+     */
+    int32_t heading;
+
+    /**
+     * @brief Accuracy estimates of the vector components and length (0.1 mm)
+     */
+    uint32_t northAccuracy;
+    uint32_t eastAccuracy;
+    uint32_t downAccuracy;
+    uint32_t lengthAccuracy;
+
+    /**
+     * @brief Accuracy estimate of the heading (1e-5 degrees)
+     */
+    uint32_t headingAccuracy;
+
+    /**
+     * @brief Flags field of the message.  Use the accessors below to read it.
+     */
+    uint32_t flags;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
+
+    /**
+     * @brief Whether the relative position components are valid
+     */
+    bool isValid() const
+    {
+        return flags & (1 << 2);
+    }
+
+    /**
+     * @brief Whether the heading is valid (only set in moving base mode)
+     */
+    bool isHeadingValid() const
+    {
+        return flags & (1 << 8);
+    }
+
+    /**
+     * @brief Whether the receiver is operating in moving base mode
+     */
+    bool isMovingBase() const
+    {
+        return flags & (1 << 5);
+    }
+
+    CarrierSolution getCarrierSolution() const
+    {
+        return static_cast<CarrierSolution>((flags >> 3) & 0x3);
+    }
+
+    double headingDegrees() const
+    {
+        return heading / 1e5;
+    }
+
+    double lengthMeters() const
+    {
+        return static_cast<double>(length) / 10000.0;
+    }
+};
+
+/**
+ * @brief Position and velocity covariance from UBX-NAV-COV
+ *
+ * Each matrix is stored as a full 3x3 float array in north-east-down order.  Covariance matrices
+ * are symmetric, so the layout is the same in row-major and column-major order, and can be mapped
+ * directly by matrix libraries (e.g. Eigen::Map<Eigen::Matrix3f>).
+ */
+struct NavigationCovariance
+{
+    /**
+     * @brief GPS time of week of the navigation epoch (ms)
+     */
+    uint32_t iTOW;
+
+    /**
+     * @brief Whether positionCovariance is valid
+     */
+    bool positionValid;
+
+    /**
+     * @brief Whether velocityCovariance is valid
+     */
+    bool velocityValid;
+
+    /**
+     * @brief NED position covariance (m^2)
+     */
+    float positionCovariance[9];
+
+    /**
+     * @brief NED velocity covariance (m^2/s^2)
+     */
+    float velocityCovariance[9];
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
+};
+
+/**
+ * @brief Dilution of precision from UBX-NAV-DOP.  All values are scaled by 0.01.
+ */
+struct DilutionOfPrecision
+{
+    /**
+     * @brief GPS time of week of the navigation epoch (ms)
+     */
+    uint32_t iTOW;
+
+    uint16_t geometric;
+    uint16_t position;
+    uint16_t time;
+    uint16_t vertical;
+    uint16_t horizontal;
+    uint16_t northing;
+    uint16_t easting;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
+};
+
+/**
+ * @brief Averages high precision positions (e.g. to survey in a point) without any rounding
+ * until the mean is taken.
+ *
+ * Sums are kept in 64 bit integers, which is enough for over 10^8 positions.
+ */
+class HighPrecisionAverage
+{
+public:
+    /**
+     * @brief Add a position to the average.  Invalid positions are ignored.
+     */
+    void add(const HighPrecisionGeodeticPosition& position);
+
+    /**
+     * @brief Get the mean of the positions added so far, rounded to the nearest fixed point unit.
+     * The accuracy fields hold the mean accuracy, and the time fields are from the last position
+     * added.
+     */
+    HighPrecisionGeodeticPosition getMean() const;
+
+    /**
+     * @brief Number of positions added
+     */
+    uint32_t getCount() const
+    {
+        return count_;
+    }
+
+    /**
+     * @brief Clear the average
+     */
+    void reset()
+    {
+        *this = HighPrecisionAverage();
+    }
+
+private:
+    int64_t longitudeSum_ = 0;
+    int64_t latitudeSum_ = 0;
+    int64_t heightSum_ = 0;
+    int64_t heightMSLSum_ = 0;
+    uint64_t horizontalAccuracySum_ = 0;
+    uint64_t verticalAccuracySum_ = 0;
+    uint32_t count_ = 0;
+    HighPrecisionGeodeticPosition last_{};
 };
 
 /**
@@ -137,6 +641,11 @@ struct FixQuality
      * @brief Number of SVs used in Nav Solution
      */
     uint8_t numSatellites;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
 };
 
 /**
@@ -147,24 +656,34 @@ struct VelocityNED
 {
 
     /**
-     * @brief North velocity component (cm/s)
+     * @brief North velocity component (mm/s from NAV-PVT, cm/s from NAV-VELNED)
      */
     int32_t northVel;
 
     /**
-     * @brief East velocity component (cm/s)
+     * @brief East velocity component (mm/s from NAV-PVT, cm/s from NAV-VELNED)
      */
     int32_t eastVel;
 
     /**
-     * @brief Down velocity component (cm/s)
+     * @brief Down velocity component (mm/s from NAV-PVT, cm/s from NAV-VELNED)
      */
     int32_t downVel;
 
     /**
-     * @brief Speed (3-D) (cm/s)
+     * @brief Speed (3-D) (mm/s from NAV-PVT, cm/s from NAV-VELNED)
      */
     uint32_t speed3D;
+
+    /**
+     * @brief Speed accuracy estimate (mm/s from NAV-PVT, cm/s from NAV-VELNED)
+     */
+    uint32_t speedAccuracy;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
 };
 
 /**
@@ -180,6 +699,17 @@ struct UtcTime
     uint8_t hour;
     uint8_t minute;
     uint8_t second;
+
+    /**
+     * @brief Fraction of second (ns).  Note that this may be negative, in which case it should be
+     * subtracted from the other fields.
+     */
+    int32_t nanosecond;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
 };
 
 // Struct to represent the GPS Time-Of-Week.
@@ -189,10 +719,20 @@ struct GPSTow
     uint32_t timeOfWeek; // number of milliseconds since midnight Sunday in the current week
     uint32_t subTimeOfWeek; // Fractional part of time of week (1 LSB = 2^(-32) ms)
 
-    bool operator==(GPSTow const & other) const
+    constexpr bool operator==(GPSTow const & other) const
     {
         return (weekNumber == other.weekNumber) && (timeOfWeek == other.timeOfWeek) && (subTimeOfWeek == other.subTimeOfWeek);
     }
+
+    /**
+     * @brief Convert to nanoseconds since the GPS epoch (truncating the sub-ms part to whole ns)
+     */
+    constexpr int64_t toNanoseconds() const
+    {
+        return static_cast<int64_t>(weekNumber) * 604800LL * 1000000000LL
+            + static_cast<int64_t>(timeOfWeek) * 1000000LL
+            + static_cast<int64_t>((static_cast<uint64_t>(subTimeOfWeek) * 1000000ULL) >> 32);
+    }
 };
 
 /**
@@ -208,6 +748,119 @@ struct Timepulse
      * @brief Quantization error of time pulse (ps)
      */
     int32_t timeQuantizationError;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
+};
+
+/**
+ * @brief Time base used for time mark events
+ */
+enum class TimemarkTimeBase : uint8_t
+{
+    RECEIVER = 0,
+    GNSS = 1,
+    UTC = 2
+};
+
+/**
+ * @brief Structure to hold a time mark event from the EXTINT pin (UBX-TIM-TM2)
+ */
+struct TimemarkEvent
+{
+    /**
+     * @brief Channel (EXTINT pin) the event occurred on
+     */
+    uint8_t channel;
+
+    /**
+     * @brief Rising edge counter.  Increments by one for each rising edge, so gaps indicate
+     * events that the receiver did not report.
+     */
+    uint16_t count;
+
+    /**
+     * @brief Time of the last rising edge
+     */
+    GPSTow risingEdge;
+
+    /**
+     * @brief Time of the last falling edge
+     */
+    GPSTow fallingEdge;
+
+    /**
+     * @brief True if a new rising edge was detected since the last message
+     */
+    bool newRisingEdge;
+
+    /**
+     * @brief True if a new falling edge was detected since the last message
+     */
+    bool newFallingEdge;
+
+    /**
+     * @brief Time base of risingEdge and fallingEdge
+     */
+    TimemarkTimeBase timeBase;
+
+    /**
+     * @brief True if UTC time is available
+     */
+    bool utcAvailable;
+
+    /**
+     * @brief True if the edge times are valid
+     */
+    bool timeValid;
+
+    /**
+     * @brief Accuracy estimate of the edge times (ns)
+     */
+    uint32_t accuracyEstimate;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
+};
+
+/**
+ * @brief Structure to hold leap second information
+ */
+struct LeapSecondInfo
+{
+    /**
+     * @brief Current number of leap seconds (GPS - UTC, s)
+     */
+    int8_t currentLeapSeconds;
+
+    /**
+     * @brief Whether currentLeapSeconds came from the GNSS.  If false, it is a default value.
+     */
+    bool currentValid;
+
+    /**
+     * @brief Change in the number of leap seconds at the next leap second event (-1, 0, or 1)
+     */
+    int8_t upcomingChange;
+
+    /**
+     * @brief Time until the next leap second event (s), or 0 if none is scheduled.
+     */
+    int32_t timeToChange;
+
+    /**
+     * @brief Whether upcomingChange and timeToChange are valid
+     */
+    bool changeValid;
+
+    /**
+     * @brief Host time at which the message containing this data was received.
+     */
+    RxTimestamp rxTime;
 };
 
 /**
@@ -267,6 +920,24 @@ UtcTime parseNAV_TIMEUTC(const uint8_t* msgBuffer);
  */
 Timepulse parseTIM_TP(const uint8_t* msgBuffer);
 
+/**
+ * @brief parse message of type UBX-NAV-TIMELS. This function assumes that the provided
+ *        buffer has the correct message type.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @return LeapSecondInfo parsed from message
+ */
+LeapSecondInfo parseNAV_TIMELS(const uint8_t* msgBuffer);
+
+/**
+ * @brief parse message of type UBX-TIM-TM2. This function assumes that the provided
+ *        buffer has the correct message type.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @return TimemarkEvent parsed from message
+ */
+TimemarkEvent parseTIM_TM2(const uint8_t* msgBuffer);
+
 /**
  * @brief parse message of type UBX-NAV-PVY. This function assumes that the provided
  *        buffer has the correct message type.
@@ -283,6 +954,107 @@ Timepulse parseTIM_TP(const uint8_t* msgBuffer);
 void parseNAV_PVT(const uint8_t* msgBuffer, GeodeticPosition& pos, VelocityNED& velocity,
     FixQuality& fix, UtcTime& time);
 
+/**
+ * @brief parse message of type UBX-NAV-HPPOSLLH. This function assumes that the provided
+ *        buffer has the correct message type.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @return HighPrecisionGeodeticPosition parsed from message
+ */
+HighPrecisionGeodeticPosition parseNAV_HPPOSLLH(const uint8_t* msgBuffer);
+
+/**
+ * @brief parse message of type UBX-NAV-HPPOSECEF. This function assumes that the provided
+ *        buffer has the correct message type.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @return HighPrecisionECEFPosition parsed from message
+ */
+HighPrecisionECEFPosition parseNAV_HPPOSECEF(const uint8_t* msgBuffer);
+
+/**
+ * @brief parse message of type UBX-NAV-RELPOSNED. This function assumes that the provided
+ *        buffer has the correct message type.
+ *
+ * @note Only version 1 of the message (ZED-F9P and later) is supported.  For other versions,
+ *       the flags are cleared so that the position is marked invalid.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @return RelativePositionNED parsed from message
+ */
+RelativePositionNED parseNAV_RELPOSNED(const uint8_t* msgBuffer);
+
+/**
+ * @brief parse message of type UBX-NAV-COV. This function assumes that the provided
+ *        buffer has the correct message type.
+ *
+ * @note The matrices are written straight into \c covariance rather than returned, so that they
+ *       can be decoded into their final location.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @param[out] covariance covariance to fill in
+ */
+void parseNAV_COV(const uint8_t* msgBuffer, NavigationCovariance& covariance);
+
+/**
+ * @brief parse message of type UBX-NAV-DOP. This function assumes that the provided
+ *        buffer has the correct message type.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @return DilutionOfPrecision parsed from message
+ */
+DilutionOfPrecision parseNAV_DOP(const uint8_t* msgBuffer);
+
+/**
+ * @brief parse message of type UBX-MON-RF into a health snapshot. This function assumes that the
+ *        provided buffer has the correct message type.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @param[in,out] health snapshot to update the antenna and RF band fields of
+ */
+void parseMON_RF(const uint8_t* msgBuffer, ReceiverHealth& health);
+
+/**
+ * @brief parse message of type UBX-MON-HW into a health snapshot. This function assumes that the
+ *        provided buffer has the correct message type.
+ *
+ * @note MON-HW only reports one RF band.  On receivers which output MON-RF, prefer that.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @param[in,out] health snapshot to update the antenna and first RF band fields of
+ */
+void parseMON_HW(const uint8_t* msgBuffer, ReceiverHealth& health);
+
+/**
+ * @brief parse message of type UBX-NAV-STATUS into a health snapshot. This function assumes that
+ *        the provided buffer has the correct message type.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @param[in,out] health snapshot to update the fix and spoofing fields of
+ */
+void parseNAV_STATUS(const uint8_t* msgBuffer, ReceiverHealth& health);
+
+/**
+ * @brief parse message of type UBX-SEC-SIG into a health snapshot. This function assumes that
+ *        the provided buffer has the correct message type.
+ *
+ * @param[in] msgBuffer buffer of message bytes.
+ * @param[in,out] health snapshot to update the spoofing and jamming fields of
+ */
+void parseSEC_SIG(const uint8_t* msgBuffer, ReceiverHealth& health);
+
+/**
+ * @brief Get the typical payload length of a periodic UBX message, for estimating how much bus
+ *        bandwidth it uses.
+ *
+ * @note Messages whose length depends on the number of satellites (e.g. NAV-SAT, RXM-RAWX) are
+ *       estimated for 32 tracked signals.  RTCM3 output messages are looked up under
+ *       UBX_CLASS_RTCM3 and the ID which UBX-CFG-MSG uses for them.
+ *
+ * @return Payload length in bytes, or a conservative guess (100 bytes) for unknown messages
+ */
+uint16_t getTypicalPayloadLength(uint8_t messageClass, uint8_t messageID);
+
 }
 
 #endif
@@ -0,0 +1,82 @@
+#include "UBloxMovingBase.h"
+
+namespace UBlox
+{
+
+#if UBLOX_GNSS_RTCM_QUEUE_SIZE > 0
+namespace
+{
+/**
+ * @brief Update a receiver until it has no more messages waiting.  A 0us update() reads only
+ * one message, and each RTCM3 frame counts as one.
+ *
+ * @return Number of messages processed
+ */
+int drain(UBloxGPS& gps)
+{
+    int messages = 0;
+    int read;
+    while ((read = gps.update(0us)) > 0)
+    {
+        messages += read;
+    }
+    return messages;
+}
+}
+
+MovingBaseLink::MovingBaseLink(UBloxGen9& base, UBloxGen9& rover)
+    : base_(base)
+    , rover_(rover)
+{
+}
+
+MovingBaseLink::~MovingBaseLink()
+{
+    stop();
+}
+
+bool MovingBaseLink::configure()
+{
+    bool ret = true;
+    ret &= base_.enableMovingBaseOutput(true);
+    ret &= rover_.enableRTCMInput(true);
+    ret &= rover_.setMessageRate(UBX_CLASS_NAV, UBX_NAV_RELPOSNED, 1);
+    return ret;
+}
+
+void MovingBaseLink::start()
+{
+    base_.attachRTCMOutput(callback(this, &MovingBaseLink::forwardFrame));
+}
+
+void MovingBaseLink::stop()
+{
+    base_.attachRTCMOutput(nullptr);
+}
+
+int MovingBaseLink::update(us_time timeout)
+{
+    // Base first, so that all of its corrections go out at the start of the rover's update
+    int messages = base_.update(timeout);
+    if (messages > 0)
+    {
+        messages += drain(base_);
+    }
+    messages += drain(rover_);
+    return messages;
+}
+
+void MovingBaseLink::forwardFrame(const uint8_t* frame, size_t len)
+{
+    if (rover_.injectRTCMFrame(frame, len))
+    {
+        forwardedFrames_++;
+    }
+    else
+    {
+        droppedFrames_++;
+    }
+}
+#endif
+
+}
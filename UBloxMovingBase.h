@@ -0,0 +1,107 @@
+#ifndef UBLOX_MOVING_BASE_H
+#define UBLOX_MOVING_BASE_H
+
+#include "UBloxGen9.h"
+
+namespace UBlox
+{
+
+#if UBLOX_GNSS_RTCM_QUEUE_SIZE > 0
+/**
+ * @brief Connects two ZED-F9Ps on the same MCU as a moving base and rover, e.g. to measure a
+ * vehicle's heading with two antennas.
+ *
+ * The base's RTCM3 output frames are passed straight from its RX buffer into the rover's
+ * correction queue as soon as they are received, then sent to the rover at the start of its next
+ * update().  Calling update() on this object reads every message waiting from the base, then
+ * sends the queued corrections to the rover and reads every message waiting from it, so each
+ * epoch's corrections reach the rover within one call once the base has output them.
+ *
+ * The rover reports the vector from the base antenna to its own antenna, and the heading of that
+ * vector, in UBloxGPS::relativePosition.
+ *
+ * @note The frames forwarded every epoch are typically 500-1000 bytes, so the RX buffer
+ * (UBLOX_GNSS_RX_BUFFER_SIZE) must be at least 1029 bytes to receive every frame.
+ */
+class MovingBaseLink
+{
+public:
+    /**
+     * @brief Construct a MovingBaseLink.  Neither receiver is touched until configure() and
+     * start() are called.
+     *
+     * @param base Receiver acting as the moving base
+     * @param rover Receiver acting as the rover
+     */
+    MovingBaseLink(UBloxGen9& base, UBloxGen9& rover);
+
+    /**
+     * @brief Stops forwarding
+     */
+    ~MovingBaseLink();
+
+    MovingBaseLink(MovingBaseLink const &) = delete;
+    MovingBaseLink& operator=(MovingBaseLink const &) = delete;
+
+    /**
+     * @brief Configure the base to output moving base corrections, and the rover to accept
+     * them and output NAV-RELPOSNED every epoch.
+     *
+     * @return true if all settings were acknowledged
+     */
+    bool configure();
+
+    /**
+     * @brief Start forwarding the base's RTCM3 output to the rover.
+     */
+    void start();
+
+    /**
+     * @brief Stop forwarding.
+     */
+    void stop();
+
+    /**
+     * @brief Poll the base and then the rover (see UBloxGPS::update()).  Unlike
+     * UBloxGPS::update(), a 0us timeout still reads every message waiting from each receiver.
+     *
+     * @param timeout How long to wait for the first message from the base.  The rover is not
+     * waited for.
+     *
+     * @return Total number of messages processed from both receivers
+     */
+    int update(us_time timeout = 0us);
+
+    /**
+     * @brief Number of frames passed to the rover
+     */
+    uint32_t getForwardedFrames() const
+    {
+        return forwardedFrames_;
+    }
+
+    /**
+     * @brief Number of frames which did not fit in the rover's correction queue
+     */
+    uint32_t getDroppedFrames() const
+    {
+        return droppedFrames_;
+    }
+
+private:
+    /**
+     * @brief RTCM3 output callback attached to the base
+     */
+    void forwardFrame(const uint8_t* frame, size_t len);
+
+    UBloxGen9& base_;
+    UBloxGen9& rover_;
+
+    uint32_t forwardedFrames_ = 0;
+    uint32_t droppedFrames_ = 0;
+};
+#endif
+
+}
+
+#endif // UBLOX_MOVING_BASE_H
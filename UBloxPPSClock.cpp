@@ -0,0 +1,223 @@
+#include "UBloxPPSClock.h"
+
+namespace UBlox
+{
+
+namespace
+{
+constexpr int64_t NS_PER_SECOND = 1000000000LL;
+
+/// Max drift magnitude accepted by the filter (ppb).  Crystal oscillators are well within this.
+constexpr int64_t MAX_DRIFT_PPB = 200000;
+
+/// Filter gains, expressed as right shifts
+constexpr int OFFSET_GAIN_SHIFT = 1;
+constexpr int DRIFT_GAIN_SHIFT = 3;
+}
+
+PPSClock::PPSClock(PinName ppsPin, bool risingEdge)
+    : ppsPin_(ppsPin)
+{
+    if (risingEdge)
+    {
+        ppsPin_.rise(callback(this, &PPSClock::onEdge));
+    }
+    else
+    {
+        ppsPin_.fall(callback(this, &PPSClock::onEdge));
+    }
+}
+
+PPSClock::~PPSClock()
+{
+    ppsPin_.rise(nullptr);
+    ppsPin_.fall(nullptr);
+}
+
+void PPSClock::onEdge()
+{
+    edgeLocalNs_ = static_cast<int64_t>(HighResClock::now().time_since_epoch().count()) * 1000;
+    edgeCount_.fetch_add(1, std::memory_order_release);
+}
+
+void PPSClock::readEdge(uint32_t& count, int64_t& localNs) const
+{
+    // If the ISR fires while we are reading, the count changes and we try again.
+    uint32_t countAfter;
+    do
+    {
+        count = edgeCount_.load(std::memory_order_acquire);
+        localNs = edgeLocalNs_;
+        countAfter = edgeCount_.load(std::memory_order_acquire);
+    } while (count != countAfter);
+}
+
+void PPSClock::onTimepulseMessage(const Timepulse& timepulse)
+{
+    uint32_t edgeCount;
+    int64_t edgeLocalNs;
+    readEdge(edgeCount, edgeLocalNs);
+
+    // If exactly one edge arrived since the last TIM-TP, it is the pulse that message described.
+    // Otherwise a pulse was missed (or the message was late), and the measurement is skipped.
+    if (havePendingPulse_ && edgeCount == pendingEdgeCount_ + 1)
+    {
+        pairedPulses_++;
+        addMeasurement(pendingPulseGPSNs_, edgeLocalNs);
+    }
+
+    // Quantization error is the difference between the actual and the ideal pulse time
+    pendingPulseGPSNs_ = timepulse.tow.toNanoseconds() + timepulse.timeQuantizationError / 1000;
+    pendingEdgeCount_ = edgeCount;
+    havePendingPulse_ = true;
+}
+
+void PPSClock::addMeasurement(int64_t gpsNs, int64_t localNs)
+{
+    // This is the only writer, so state_ can be read directly here
+    State newState = state_;
+
+    int64_t gpsDelta = gpsNs - newState.refGPSNs;
+    bool restart = consecutivePulses_ == 0 || gpsDelta <= 0 || gpsDelta > MAX_HOLDOVER_NS;
+
+    if (!restart)
+    {
+        int64_t predictedLocalNs = newState.refLocalNs + scaleByDrift(gpsDelta, newState.drift);
+        int64_t residual = localNs - predictedLocalNs;
+        lastResidualNs_ = static_cast<int32_t>(residual);
+
+        if (residual > MAX_RESIDUAL_NS || residual < -MAX_RESIDUAL_NS)
+        {
+            rejectedPulses_++;
+            restart = true;
+        }
+        else
+        {
+            // Drift correction, in 2^-DRIFT_FRAC_BITS ppb.  Can't overflow since the residual and
+            // the GPS delta are both bounded.
+            int64_t driftError = (residual * NS_PER_SECOND * (1 << DRIFT_FRAC_BITS)) / gpsDelta;
+
+            if (consecutivePulses_ == 1)
+            {
+                // First interval: take the measured drift and offset directly
+                newState.drift += driftError;
+                newState.refLocalNs = localNs;
+            }
+            else
+            {
+                newState.drift += driftError >> DRIFT_GAIN_SHIFT;
+                newState.refLocalNs = predictedLocalNs + (residual >> OFFSET_GAIN_SHIFT);
+            }
+
+            constexpr int64_t maxDrift = MAX_DRIFT_PPB << DRIFT_FRAC_BITS;
+            newState.drift = std::max(-maxDrift, std::min(maxDrift, newState.drift));
+            newState.refGPSNs = gpsNs;
+            consecutivePulses_++;
+        }
+    }
+
+    if (restart)
+    {
+        // Keep the drift estimate (if any) since it is likely still close
+        newState.refLocalNs = localNs;
+        newState.refGPSNs = gpsNs;
+        consecutivePulses_ = 1;
+    }
+
+    newState.locked = consecutivePulses_ >= PULSES_TO_LOCK;
+
+    // Publish via seqlock
+    sequence_.fetch_add(1, std::memory_order_acq_rel);
+    std::atomic_thread_fence(std::memory_order_release);
+    state_ = newState;
+    std::atomic_thread_fence(std::memory_order_release);
+    sequence_.fetch_add(1, std::memory_order_release);
+}
+
+bool PPSClock::readState(State& state) const
+{
+    // Bounded number of tries, so that a reader in an ISR which interrupted the writer gives up
+    // instead of spinning forever.
+    for (int attempt = 0; attempt < 4; attempt++)
+    {
+        uint32_t seqBefore = sequence_.load(std::memory_order_acquire);
+        if (seqBefore & 1)
+        {
+            continue;
+        }
+        state = state_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == seqBefore)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t PPSClock::scaleByDrift(int64_t gpsDeltaNs, int64_t drift)
+{
+    // |gpsDeltaNs| <= MAX_HOLDOVER_NS and |drift| <= MAX_DRIFT_PPB << DRIFT_FRAC_BITS, so the
+    // product fits in 63 bits.
+    return gpsDeltaNs + (gpsDeltaNs * drift) / (NS_PER_SECOND << DRIFT_FRAC_BITS);
+}
+
+bool PPSClock::isLocked() const
+{
+    State state;
+    if (!readState(state) || !state.locked)
+    {
+        return false;
+    }
+    int64_t nowNs = static_cast<int64_t>(HighResClock::now().time_since_epoch().count()) * 1000;
+    return nowNs - state.refLocalNs <= MAX_HOLDOVER_NS;
+}
+
+bool PPSClock::localToGPS(std::chrono::microseconds localTime, int64_t& gpsNanoseconds) const
+{
+    State state;
+    if (!readState(state) || !state.locked)
+    {
+        return false;
+    }
+
+    int64_t localDelta = static_cast<int64_t>(localTime.count()) * 1000 - state.refLocalNs;
+    if (localDelta > MAX_HOLDOVER_NS || localDelta < -MAX_HOLDOVER_NS)
+    {
+        return false;
+    }
+
+    // Inverse of scaleByDrift(), to first order (the error is drift^2, which is negligible)
+    gpsNanoseconds = state.refGPSNs + scaleByDrift(localDelta, -state.drift);
+    return true;
+}
+
+bool PPSClock::gpsToLocal(int64_t gpsNanoseconds, int64_t& localNanoseconds) const
+{
+    State state;
+    if (!readState(state) || !state.locked)
+    {
+        return false;
+    }
+
+    int64_t gpsDelta = gpsNanoseconds - state.refGPSNs;
+    if (gpsDelta > MAX_HOLDOVER_NS || gpsDelta < -MAX_HOLDOVER_NS)
+    {
+        return false;
+    }
+
+    localNanoseconds = state.refLocalNs + scaleByDrift(gpsDelta, state.drift);
+    return true;
+}
+
+int32_t PPSClock::getDriftPPB() const
+{
+    State state;
+    if (!readState(state))
+    {
+        return 0;
+    }
+    return static_cast<int32_t>(state.drift >> DRIFT_FRAC_BITS);
+}
+
+}
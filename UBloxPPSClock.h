@@ -0,0 +1,214 @@
+#ifndef UBLOX_PPS_CLOCK_H
+#define UBLOX_PPS_CLOCK_H
+
+#include "UBloxMessages.h"
+#include "mbed.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace UBlox
+{
+
+/**
+ * @brief Disciplines a mapping between GPS time and the host's monotonic clock using the GNSS's
+ * timepulse (PPS) output.
+ *
+ * The timepulse pin is captured by an interrupt, which records the host time of each edge.  Each
+ * UBX-TIM-TP message gives the exact GPS time of the next pulse, so pairing the two gives a
+ * (GPS time, host time) measurement once per pulse.  These measurements are run through an
+ * integer offset/drift filter, and the result can then be used to convert between GPS time and
+ * host time without any bus traffic.  Conversions are lock-free and can be done from any thread
+ * or from an ISR.
+ *
+ * To use this class:
+ *  - Configure the timepulse for 1 Hz (e.g. UBloxGen8::configureTimepulse()).
+ *  - Make sure the GNSS sends a TIM-TP message after each pulse, either by enabling it as a
+ *    periodic message or by calling UBloxGPS::requestTimepulseUpdate() once per second.
+ *  - Attach this object with UBloxGPS::attachPPSClock(), and call UBloxGPS::update() regularly.
+ *
+ * @note Conversion resolution is limited by the resolution of the host clock, which is 1us on
+ * most Mbed targets.  Conversions in both directions are still computed in nanoseconds, so no
+ * additional rounding error is introduced.
+ */
+class PPSClock
+{
+public:
+    /**
+     * @brief Construct a PPSClock.
+     *
+     * @param ppsPin Input pin connected to the GNSS's timepulse output
+     * @param risingEdge True if the top of each second is marked by the rising edge of the pulse,
+     *                   false if it is marked by the falling edge.
+     */
+    PPSClock(PinName ppsPin, bool risingEdge = true);
+
+    /**
+     * @brief Stop capturing pulses.
+     */
+    ~PPSClock();
+
+    PPSClock(PPSClock const &) = delete;
+    PPSClock& operator=(PPSClock const &) = delete;
+
+    /**
+     * @brief Feed a received UBX-TIM-TP message into the clock.  This is called automatically by
+     * UBloxGPS when the clock is attached.
+     */
+    void onTimepulseMessage(const Timepulse& timepulse);
+
+    /**
+     * @brief Whether enough pulses have been paired for conversions to be valid.
+     */
+    bool isLocked() const;
+
+    /**
+     * @brief Convert a host time (e.g. from UBloxGPS::now()) to GPS time.
+     *
+     * @param localTime Host time to convert
+     * @param[out] gpsNanoseconds GPS time, in nanoseconds since the GPS epoch
+     *
+     * @return true if the conversion succeeded, false if the clock is not locked.
+     */
+    bool localToGPS(std::chrono::microseconds localTime, int64_t& gpsNanoseconds) const;
+
+    /**
+     * @brief Convert a GPS time to host time.
+     *
+     * @param gpsNanoseconds GPS time, in nanoseconds since the GPS epoch
+     * @param[out] localNanoseconds Host time, in nanoseconds since boot
+     *
+     * @return true if the conversion succeeded, false if the clock is not locked.
+     */
+    bool gpsToLocal(int64_t gpsNanoseconds, int64_t& localNanoseconds) const;
+
+    /**
+     * @brief Get the current estimated drift of the host clock relative to GPS time, in parts per
+     * billion.  Positive values mean the host clock runs fast.
+     */
+    int32_t getDriftPPB() const;
+
+    /**
+     * @brief Get the residual (measured - predicted host time) of the most recent pulse, in ns.
+     * This gives an idea of the jitter in the pulse capture.
+     */
+    int32_t getLastResidualNs() const
+    {
+        return lastResidualNs_;
+    }
+
+    /**
+     * @brief Number of pulses successfully paired with TIM-TP messages
+     */
+    uint32_t getPairedPulseCount() const
+    {
+        return pairedPulses_;
+    }
+
+    /**
+     * @brief Number of pulses rejected because they did not match the prediction (causing the
+     * filter to restart)
+     */
+    uint32_t getRejectedPulseCount() const
+    {
+        return rejectedPulses_;
+    }
+
+    /**
+     * @brief Number of pulses which must be paired after (re)starting before the clock is locked.
+     */
+    static constexpr uint32_t PULSES_TO_LOCK = 3;
+
+    /**
+     * @brief Max error (ns) between a pulse's predicted and measured host time before the filter
+     * is restarted.
+     */
+    static constexpr int64_t MAX_RESIDUAL_NS = 100000;
+
+    /**
+     * @brief Max time (ns) since the last pulse for which conversions are still provided.  Beyond
+     * this, the clock is considered unlocked until pulses resume.
+     */
+    static constexpr int64_t MAX_HOLDOVER_NS = 10LL * 1000000000LL;
+
+private:
+    /**
+     * @brief Filter state, protected by the seqlock in sequence_.
+     */
+    struct State
+    {
+        /// Host time (ns since boot) of the reference pulse, after filtering
+        int64_t refLocalNs = 0;
+
+        /// GPS time (ns since GPS epoch) of the reference pulse
+        int64_t refGPSNs = 0;
+
+        /// Drift of the host clock relative to GPS, in units of 2^-DRIFT_FRAC_BITS ppb
+        int64_t drift = 0;
+
+        /// Whether the state is usable for conversions
+        bool locked = false;
+    };
+
+    static constexpr int DRIFT_FRAC_BITS = 10;
+
+    /**
+     * @brief Pulse edge ISR
+     */
+    void onEdge();
+
+    /**
+     * @brief Read the latest edge time captured by the ISR, along with the edge count it belongs to.
+     */
+    void readEdge(uint32_t& count, int64_t& localNs) const;
+
+    /**
+     * @brief Read a consistent copy of the filter state.
+     * @return false if a consistent copy could not be obtained (e.g. if called from an ISR that
+     * interrupted an update)
+     */
+    bool readState(State& state) const;
+
+    /**
+     * @brief Run the filter with a new (GPS time, host time) pulse measurement.
+     */
+    void addMeasurement(int64_t gpsNs, int64_t localNs);
+
+    /**
+     * @brief Compute the host-time change corresponding to a GPS time change, accounting for drift.
+     */
+    static int64_t scaleByDrift(int64_t gpsDeltaNs, int64_t drift);
+
+    InterruptIn ppsPin_;
+
+    /// Host time (ns) of the latest edge.  Written by the ISR.
+    volatile int64_t edgeLocalNs_ = 0;
+
+    /// Number of edges captured.  Incremented by the ISR after writing edgeLocalNs_.
+    std::atomic<uint32_t> edgeCount_{0};
+
+    /// GPS time (ns) of the pulse following the last TIM-TP message
+    int64_t pendingPulseGPSNs_ = 0;
+
+    /// Value of edgeCount_ when the last TIM-TP message was received
+    uint32_t pendingEdgeCount_ = 0;
+
+    /// Whether pendingPulseGPSNs_ is valid
+    bool havePendingPulse_ = false;
+
+    /// Number of consecutive pulses accepted by the filter since it was (re)started
+    uint32_t consecutivePulses_ = 0;
+
+    /// Seqlock sequence number.  Odd while state_ is being written.
+    std::atomic<uint32_t> sequence_{0};
+
+    State state_;
+
+    int32_t lastResidualNs_ = 0;
+    uint32_t pairedPulses_ = 0;
+    uint32_t rejectedPulses_ = 0;
+};
+
+}
+
+#endif // UBLOX_PPS_CLOCK_H
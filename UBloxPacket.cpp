@@ -0,0 +1,35 @@
+#include "UBloxPacket.h"
+
+#include <cstring>
+
+namespace UBlox
+{
+
+size_t buildUBXPacket(uint8_t* buffer, size_t bufferLen, uint8_t messageClass, uint8_t messageID,
+    const uint8_t* data, uint16_t dataLen)
+{
+    size_t packetLen = dataLen + UBX_HEADER_FOOTER_LENGTH;
+    if (packetLen > bufferLen)
+    {
+        return 0;
+    }
+
+    buffer[0] = UBX_SYNC_CHAR_1;
+    buffer[1] = UBX_SYNC_CHAR_2;
+    buffer[2] = messageClass;
+    buffer[3] = messageID;
+    buffer[4] = dataLen & 0xFF;
+    buffer[5] = dataLen >> 8;
+    if (dataLen > 0)
+    {
+        memcpy(buffer + UBX_DATA_OFFSET, data, dataLen);
+    }
+
+    uint16_t checksum = calcUBXChecksum(buffer + UBX_BYTE_CLASS, dataLen + 4);
+    buffer[UBX_DATA_OFFSET + dataLen] = checksum & 0xFF;
+    buffer[UBX_DATA_OFFSET + dataLen + 1] = checksum >> 8;
+
+    return packetLen;
+}
+
+}
@@ -0,0 +1,106 @@
+#ifndef UBLOX_PACKET_H
+#define UBLOX_PACKET_H
+
+#include "UBloxGPSConstants.h"
+
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+
+namespace UBlox
+{
+
+/**
+ * @brief Compute the UBX (8-bit Fletcher) checksum of a range of bytes.
+ *
+ * @param data Bytes to checksum.  For a UBX packet, this starts at the class byte.
+ * @param len Number of bytes to checksum.  For a UBX packet, this is the payload length + 4.
+ *
+ * @return CK_A in the low byte and CK_B in the high byte
+ */
+constexpr uint16_t calcUBXChecksum(const uint8_t* data, size_t len)
+{
+    uint8_t chka = 0;
+    uint8_t chkb = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        chka += data[i];
+        chkb += chka;
+    }
+    return static_cast<uint16_t>(chka | (chkb << 8));
+}
+
+/**
+ * @brief Assemble a complete UBX packet (sync chars, header, payload and checksum) at compile time.
+ *
+ * Use this for commands whose contents never change, so that they can be stored in flash and sent
+ * without any processing, e.g.
+ * @code
+ * static constexpr auto packet = makeUBXPacket<2>(UBX_CLASS_CFG, UBX_CFG_RATE, {0xE8, 0x03});
+ * @endcode
+ */
+template <size_t PayloadLen>
+constexpr std::array<uint8_t, PayloadLen + UBX_HEADER_FOOTER_LENGTH> makeUBXPacket(
+    uint8_t messageClass, uint8_t messageID, const std::array<uint8_t, PayloadLen>& payload)
+{
+    std::array<uint8_t, PayloadLen + UBX_HEADER_FOOTER_LENGTH> packet{};
+    packet[0] = UBX_SYNC_CHAR_1;
+    packet[1] = UBX_SYNC_CHAR_2;
+    packet[2] = messageClass;
+    packet[3] = messageID;
+    packet[4] = PayloadLen & 0xFF;
+    packet[5] = (PayloadLen >> 8) & 0xFF;
+    for (size_t i = 0; i < PayloadLen; i++)
+    {
+        packet[UBX_DATA_OFFSET + i] = payload[i];
+    }
+
+    uint16_t checksum = calcUBXChecksum(packet.data() + UBX_BYTE_CLASS, PayloadLen + 4);
+    packet[UBX_DATA_OFFSET + PayloadLen] = checksum & 0xFF;
+    packet[UBX_DATA_OFFSET + PayloadLen + 1] = checksum >> 8;
+    return packet;
+}
+
+/**
+ * @brief Assemble a poll request (a UBX packet with no payload) at compile time.
+ */
+constexpr std::array<uint8_t, UBX_HEADER_FOOTER_LENGTH> makeUBXPollPacket(
+    uint8_t messageClass, uint8_t messageID)
+{
+    return makeUBXPacket<0>(messageClass, messageID, {});
+}
+
+/**
+ * @brief Assemble a UBX packet at runtime.
+ *
+ * @param[out] buffer Buffer to assemble the packet in
+ * @param bufferLen Size of the buffer
+ * @param messageClass class of message being sent
+ * @param messageID id of the message being sent
+ * @param data buffer containing data payload for the packet
+ * @param dataLen length of the data buffer
+ *
+ * @return Length of the packet, or 0 if it did not fit in the buffer.
+ */
+size_t buildUBXPacket(uint8_t* buffer, size_t bufferLen, uint8_t messageClass, uint8_t messageID,
+    const uint8_t* data, uint16_t dataLen);
+
+/**
+ * @brief Precomputed packets for constant commands
+ */
+namespace Packets
+{
+constexpr auto POLL_MON_VER = makeUBXPollPacket(UBX_CLASS_MON, UBX_MON_VER);
+constexpr auto POLL_MON_HW = makeUBXPollPacket(UBX_CLASS_MON, UBX_MON_HW);
+constexpr auto POLL_NAV_SAT = makeUBXPollPacket(UBX_CLASS_NAV, UBX_NAV_SAT);
+constexpr auto POLL_NAV_TIMELS = makeUBXPollPacket(UBX_CLASS_NAV, UBX_NAV_TIMELS);
+constexpr auto POLL_CFG_GNSS = makeUBXPollPacket(UBX_CLASS_CFG, UBX_CFG_GNSS);
+constexpr auto POLL_TIM_TP = makeUBXPollPacket(UBX_CLASS_TIM, UBX_TIM_TP);
+
+// Known-good value from the U-Blox interface description
+static_assert(POLL_MON_VER[6] == 0x0E && POLL_MON_VER[7] == 0x34, "UBX checksum");
+}
+
+}
+
+#endif // UBLOX_PACKET_H
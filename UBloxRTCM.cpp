@@ -0,0 +1,78 @@
+#include "UBloxRTCM.h"
+
+#include <array>
+
+namespace UBlox
+{
+
+namespace
+{
+constexpr uint32_t CRC24Q_POLY = 0x1864CFB;
+
+constexpr std::array<uint32_t, 256> makeCRC24QTable()
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i << 16;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc <<= 1;
+            if (crc & 0x1000000)
+            {
+                crc ^= CRC24Q_POLY;
+            }
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+// Generated at compile time, so it is stored in flash
+constexpr std::array<uint32_t, 256> CRC24Q_TABLE = makeCRC24QTable();
+
+constexpr uint32_t crc24q(const uint8_t* data, size_t len)
+{
+    uint32_t crc = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = ((crc << 8) & 0xFFFFFF) ^ CRC24Q_TABLE[((crc >> 16) ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+// Standard check value for CRC-24/LTE-A (same polynomial and init as CRC-24Q)
+constexpr uint8_t CRC_CHECK_INPUT[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+static_assert(crc24q(CRC_CHECK_INPUT, sizeof(CRC_CHECK_INPUT)) == 0xCDE703, "CRC-24Q");
+}
+
+uint32_t calcCRC24Q(const uint8_t* data, size_t len)
+{
+    return crc24q(data, len);
+}
+
+size_t getRTCMFrameLength(const uint8_t* header)
+{
+    // 6 reserved bits (which must be 0) followed by a 10 bit payload length
+    if (header[0] != RTCM3_PREAMBLE || (header[1] & 0xFC) != 0)
+    {
+        return 0;
+    }
+    const size_t payloadLen = (static_cast<size_t>(header[1] & 0x03) << 8) | header[2];
+    return RTCM3_HEADER_LENGTH + payloadLen + RTCM3_CRC_LENGTH;
+}
+
+bool isValidRTCMFrame(const uint8_t* frame, size_t len)
+{
+    if (len < RTCM3_HEADER_LENGTH + RTCM3_CRC_LENGTH || getRTCMFrameLength(frame) != len)
+    {
+        return false;
+    }
+
+    const size_t crcOffset = len - RTCM3_CRC_LENGTH;
+    const uint32_t frameCRC = (static_cast<uint32_t>(frame[crcOffset]) << 16)
+        | (static_cast<uint32_t>(frame[crcOffset + 1]) << 8) | frame[crcOffset + 2];
+    return calcCRC24Q(frame, crcOffset) == frameCRC;
+}
+
+}
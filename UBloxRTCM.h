@@ -0,0 +1,43 @@
+#ifndef UBLOX_RTCM_H
+#define UBLOX_RTCM_H
+
+#include "UBloxGPSConstants.h"
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace UBlox
+{
+
+/**
+ * @brief Compute the CRC-24Q used by RTCM3 frames.
+ *
+ * @param data Bytes to check.  For an RTCM3 frame, this is everything before the CRC.
+ * @param len Number of bytes
+ */
+uint32_t calcCRC24Q(const uint8_t* data, size_t len);
+
+/**
+ * @brief Get the total length (header, payload and CRC) of an RTCM3 frame from its header.
+ *
+ * @param header First RTCM3_HEADER_LENGTH bytes of the frame
+ * @return Frame length, or 0 if the header is not valid.
+ */
+size_t getRTCMFrameLength(const uint8_t* header);
+
+/**
+ * @brief Check that a buffer holds exactly one complete, valid RTCM3 frame.
+ */
+bool isValidRTCMFrame(const uint8_t* frame, size_t len);
+
+/**
+ * @brief Get the message number (e.g. 1005) of a valid RTCM3 frame.
+ */
+inline uint16_t getRTCMMessageNumber(const uint8_t* frame)
+{
+    return (static_cast<uint16_t>(frame[RTCM3_HEADER_LENGTH]) << 4) | (frame[RTCM3_HEADER_LENGTH + 1] >> 4);
+}
+
+}
+
+#endif // UBLOX_RTCM_H
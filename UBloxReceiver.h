@@ -0,0 +1,56 @@
+#ifndef UBLOX_RECEIVER_H
+#define UBLOX_RECEIVER_H
+
+#include "UBloxGPS.h"
+
+#include <utility>
+
+namespace UBlox
+{
+/**
+ * @brief Combines a transport (e.g. UBloxGPSI2C) with a GNSS generation (e.g. UBloxGen9).
+ *
+ * The concrete GNSS classes (ZEDF9PI2C, MAX8I2C, etc.) are built from this template.  Since it
+ * knows its transport at compile time, its update() calls the transport's readMessage()
+ * directly instead of through the vtable, saving a vtable load and an indirect branch per read.
+ * Only that call is devirtualized: UBloxGPS is still a virtual base of both the transport
+ * and the generation, and everything else (sendMessage(), getName(), the configuration steps,
+ * and update() called through a UBloxGPS reference) still goes through the vtable.  Build the
+ * ublox-gnss-size target to compare the code generated for the two update() paths.
+ *
+ * @tparam Transport Transport class, which must define PORT_ID and final overrides of
+ *         readMessage() and sendMessage().
+ * @tparam Generation Generation class, which must be constructible from a port ID.
+ */
+template <typename Transport, typename Generation>
+class UBloxReceiver : public Transport, public Generation
+{
+public:
+    /**
+     * @brief Construct a receiver.
+     *
+     * This doesn't actually initialize the chip, you will need to call begin() for that.
+     *
+     * @param user_RSTpin Output pin connected to NRST
+     * @param transportArgs Arguments for the transport's constructor
+     */
+    template <typename... TransportArgs>
+    explicit UBloxReceiver(PinName user_RSTpin, TransportArgs&&... transportArgs)
+        : UBloxGPS(user_RSTpin)
+        , Transport(std::forward<TransportArgs>(transportArgs)...)
+        , Generation(Transport::PORT_ID)
+    {
+    }
+
+    /**
+     * @brief see UBloxGPS::update
+     */
+    int update(us_time timeout)
+    {
+        return this->updateLoop(timeout, [this]() { return this->Transport::readMessage(); });
+    }
+};
+
+}
+
+#endif // UBLOX_RECEIVER_H
@@ -0,0 +1,71 @@
+#include "UBloxTime.h"
+
+namespace UBlox
+{
+namespace Time
+{
+
+// The offset conversions below are kept free of branches and function calls so that the compiler
+// can unroll and vectorize them.
+
+void gpsToUnix(const int64_t* in, int64_t* out, size_t count, int8_t leapSeconds)
+{
+    const int64_t offset = (GPS_EPOCH_UNIX_SECONDS - leapSeconds) * NS_PER_SECOND;
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = in[i] + offset;
+    }
+}
+
+void gpsToUnix(const GPSTow* in, int64_t* out, size_t count, int8_t leapSeconds)
+{
+    const int64_t offset = (GPS_EPOCH_UNIX_SECONDS - leapSeconds) * NS_PER_SECOND;
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = in[i].toNanoseconds() + offset;
+    }
+}
+
+void gpsToTAI(const int64_t* in, int64_t* out, size_t count)
+{
+    const int64_t offset = (GPS_EPOCH_UNIX_SECONDS + TAI_GPS_OFFSET_SECONDS) * NS_PER_SECOND;
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = in[i] + offset;
+    }
+}
+
+void unixToUtc(const int64_t* in, UtcTime* out, size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Logged timestamps are usually close together, so only redo the calendar math when the day
+    // changes.
+    int64_t currentDay = floorDiv(in[0], SECONDS_PER_DAY * NS_PER_SECOND);
+    UtcTime dayStart = unixToUtc(currentDay * SECONDS_PER_DAY * NS_PER_SECOND);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const int64_t day = floorDiv(in[i], SECONDS_PER_DAY * NS_PER_SECOND);
+        if (day != currentDay)
+        {
+            currentDay = day;
+            dayStart = unixToUtc(day * SECONDS_PER_DAY * NS_PER_SECOND);
+        }
+
+        const int64_t nsOfDay = in[i] - day * SECONDS_PER_DAY * NS_PER_SECOND;
+        const int64_t secondOfDay = nsOfDay / NS_PER_SECOND;
+
+        out[i] = dayStart;
+        out[i].hour = static_cast<uint8_t>(secondOfDay / 3600);
+        out[i].minute = static_cast<uint8_t>((secondOfDay / 60) % 60);
+        out[i].second = static_cast<uint8_t>(secondOfDay % 60);
+        out[i].nanosecond = static_cast<int32_t>(nsOfDay - secondOfDay * NS_PER_SECOND);
+    }
+}
+
+}
+}
@@ -0,0 +1,217 @@
+#ifndef UBLOX_TIME_H
+#define UBLOX_TIME_H
+
+#include "UBloxMessages.h"
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace UBlox
+{
+
+/**
+ * @brief Conversions between the time scales used by GNSS receivers.
+ *
+ * All conversions use integer math only and are constexpr, so constant times are converted
+ * at compile time.  Times are represented as signed 64-bit nanosecond counts, which covers
+ * +-292 years around each epoch:
+ *  - GPS time: nanoseconds since the GPS epoch (1980-01-06 00:00:00 UTC), with no leap seconds.
+ *    This is the same representation as GPSTow::toNanoseconds().
+ *  - Unix time: nanoseconds since 1970-01-01 00:00:00 UTC, with leap seconds not counted.
+ *  - TAI: nanoseconds since 1970-01-01 00:00:00 TAI, the same representation as Linux's CLOCK_TAI.
+ *
+ * Converting between GPS and UTC based time scales needs the current number of leap seconds, which
+ * can be obtained from the GNSS via UBloxGPS::leapSeconds.
+ *
+ * @note Unix time cannot represent the leap second itself (23:59:60).  Times during a leap
+ * second are converted as if they were the following second.
+ */
+namespace Time
+{
+constexpr int64_t NS_PER_SECOND = 1000000000LL;
+constexpr int64_t SECONDS_PER_DAY = 86400;
+constexpr int64_t SECONDS_PER_WEEK = 7 * SECONDS_PER_DAY;
+
+/// Unix time (s) of the GPS epoch, 1980-01-06 00:00:00 UTC
+constexpr int64_t GPS_EPOCH_UNIX_SECONDS = 315964800;
+
+/// TAI - GPS (s).  This is constant since neither time scale has leap seconds.
+constexpr int64_t TAI_GPS_OFFSET_SECONDS = 19;
+
+/// Number of leap seconds (GPS - UTC) as of 2017, used when the GNSS has not reported it yet
+constexpr int8_t DEFAULT_LEAP_SECONDS = 18;
+
+/**
+ * @brief Get the number of days from 1970-01-01 to the given date in the proleptic Gregorian
+ * calendar.  (Algorithm from Howard Hinnant, "chrono-Compatible Low-Level Date Algorithms")
+ */
+constexpr int64_t daysFromCivil(int32_t year, uint32_t month, uint32_t day)
+{
+    year -= month <= 2;
+    const int32_t era = (year >= 0 ? year : year - 399) / 400;
+    const uint32_t yearOfEra = static_cast<uint32_t>(year - era * 400);
+    const uint32_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return static_cast<int64_t>(era) * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+/**
+ * @brief Inverse of daysFromCivil().  Fills in the year, month and day of the given UtcTime.
+ */
+constexpr void civilFromDays(int64_t days, UtcTime& date)
+{
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const uint32_t dayOfEra = static_cast<uint32_t>(days - era * 146097);
+    const uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const uint32_t monthPrime = (5 * dayOfYear + 2) / 153;
+    const uint32_t month = monthPrime < 10 ? monthPrime + 3 : monthPrime - 9;
+
+    date.year = static_cast<uint16_t>(static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2));
+    date.month = static_cast<uint8_t>(month);
+    date.day = static_cast<uint8_t>(dayOfYear - (153 * monthPrime + 2) / 5 + 1);
+}
+
+/**
+ * @brief Floor division, rounding towards negative infinity
+ */
+constexpr int64_t floorDiv(int64_t numerator, int64_t denominator)
+{
+    return numerator / denominator - ((numerator % denominator != 0) && ((numerator < 0) != (denominator < 0)));
+}
+
+/**
+ * @brief Convert a UTC calendar time to Unix time (ns).
+ */
+constexpr int64_t utcToUnix(const UtcTime& utc)
+{
+    const int64_t days = daysFromCivil(utc.year, utc.month, utc.day);
+    const int64_t seconds = days * SECONDS_PER_DAY + utc.hour * 3600 + utc.minute * 60 + utc.second;
+    return seconds * NS_PER_SECOND + utc.nanosecond;
+}
+
+/**
+ * @brief Convert Unix time (ns) to a UTC calendar time.  The nanosecond field of the result is
+ * always in [0, 1e9).
+ */
+constexpr UtcTime unixToUtc(int64_t unixNs)
+{
+    UtcTime utc{};
+    const int64_t seconds = floorDiv(unixNs, NS_PER_SECOND);
+    const int64_t days = floorDiv(seconds, SECONDS_PER_DAY);
+    const int64_t secondOfDay = seconds - days * SECONDS_PER_DAY;
+
+    civilFromDays(days, utc);
+    utc.hour = static_cast<uint8_t>(secondOfDay / 3600);
+    utc.minute = static_cast<uint8_t>((secondOfDay / 60) % 60);
+    utc.second = static_cast<uint8_t>(secondOfDay % 60);
+    utc.nanosecond = static_cast<int32_t>(unixNs - seconds * NS_PER_SECOND);
+    return utc;
+}
+
+/**
+ * @brief Convert GPS time (ns) to Unix time (ns).
+ *
+ * @param gpsNs GPS time
+ * @param leapSeconds GPS - UTC offset in seconds
+ */
+constexpr int64_t gpsToUnix(int64_t gpsNs, int8_t leapSeconds = DEFAULT_LEAP_SECONDS)
+{
+    return gpsNs + (GPS_EPOCH_UNIX_SECONDS - leapSeconds) * NS_PER_SECOND;
+}
+
+/**
+ * @brief Convert Unix time (ns) to GPS time (ns).
+ *
+ * @param unixNs Unix time
+ * @param leapSeconds GPS - UTC offset in seconds
+ */
+constexpr int64_t unixToGPS(int64_t unixNs, int8_t leapSeconds = DEFAULT_LEAP_SECONDS)
+{
+    return unixNs - (GPS_EPOCH_UNIX_SECONDS - leapSeconds) * NS_PER_SECOND;
+}
+
+/**
+ * @brief Convert GPS time (ns) to TAI (ns).
+ */
+constexpr int64_t gpsToTAI(int64_t gpsNs)
+{
+    return gpsNs + (GPS_EPOCH_UNIX_SECONDS + TAI_GPS_OFFSET_SECONDS) * NS_PER_SECOND;
+}
+
+/**
+ * @brief Convert TAI (ns) to GPS time (ns).
+ */
+constexpr int64_t taiToGPS(int64_t taiNs)
+{
+    return taiNs - (GPS_EPOCH_UNIX_SECONDS + TAI_GPS_OFFSET_SECONDS) * NS_PER_SECOND;
+}
+
+/**
+ * @brief Convert GPS time (ns) to week number and time of week.  Inverse of
+ * GPSTow::toNanoseconds(), for non-negative times.
+ */
+constexpr GPSTow gpsToTow(int64_t gpsNs)
+{
+    constexpr int64_t nsPerWeek = SECONDS_PER_WEEK * NS_PER_SECOND;
+    constexpr int64_t nsPerMs = 1000000;
+
+    GPSTow tow{};
+    tow.weekNumber = static_cast<uint16_t>(gpsNs / nsPerWeek);
+    const int64_t nsOfWeek = gpsNs % nsPerWeek;
+    tow.timeOfWeek = static_cast<uint32_t>(nsOfWeek / nsPerMs);
+
+    // Round up so that converting back with toNanoseconds() (which truncates) is lossless
+    const uint64_t subMsNs = static_cast<uint64_t>(nsOfWeek % nsPerMs);
+    tow.subTimeOfWeek = static_cast<uint32_t>(((subMsNs << 32) + nsPerMs - 1) / nsPerMs);
+    return tow;
+}
+
+/**
+ * @brief Convert a GPS week and time of week to a UTC calendar time.
+ */
+constexpr UtcTime gpsToUtc(const GPSTow& tow, int8_t leapSeconds = DEFAULT_LEAP_SECONDS)
+{
+    return unixToUtc(gpsToUnix(tow.toNanoseconds(), leapSeconds));
+}
+
+/**
+ * @brief Convert a UTC calendar time to GPS week and time of week.
+ */
+constexpr GPSTow utcToGPS(const UtcTime& utc, int8_t leapSeconds = DEFAULT_LEAP_SECONDS)
+{
+    return gpsToTow(unixToGPS(utcToUnix(utc), leapSeconds));
+}
+
+/**
+ * @brief Convert an array of GPS times (ns) to Unix times (ns).  \c in and \c out may be the same
+ * array.
+ */
+void gpsToUnix(const int64_t* in, int64_t* out, size_t count, int8_t leapSeconds);
+
+/**
+ * @brief Convert an array of GPS week/time-of-week values to Unix times (ns).
+ */
+void gpsToUnix(const GPSTow* in, int64_t* out, size_t count, int8_t leapSeconds);
+
+/**
+ * @brief Convert an array of GPS times (ns) to TAI (ns).  \c in and \c out may be the same array.
+ */
+void gpsToTAI(const int64_t* in, int64_t* out, size_t count);
+
+/**
+ * @brief Convert an array of Unix times (ns) to UTC calendar times.
+ */
+void unixToUtc(const int64_t* in, UtcTime* out, size_t count);
+
+// Compile-time checks of the conversions
+static_assert(daysFromCivil(1970, 1, 1) == 0, "Unix epoch");
+static_assert(daysFromCivil(1980, 1, 6) * SECONDS_PER_DAY == GPS_EPOCH_UNIX_SECONDS, "GPS epoch");
+static_assert(utcToUnix(unixToUtc(1483228817123456789LL)) == 1483228817123456789LL, "round trip");
+static_assert(gpsToTow(GPSTow{ 2200, 345600123, 0x80000000 }.toNanoseconds()) == GPSTow{ 2200, 345600123, 0x80000000 }, "tow round trip");
+}
+
+}
+
+#endif // UBLOX_TIME_H
@@ -4,11 +4,13 @@
 #include "UBloxGen9.h"
 #include "UBloxGPSSPI.h"
 #include "UBloxGPSI2C.h"
+#include "UBloxGPSSerial.h"
+#include "UBloxReceiver.h"
 
 namespace UBlox
 {
 
-class ZEDF9PI2C : public UBloxGPSI2C, public UBloxGen9
+class ZEDF9PI2C final : public UBloxReceiver<UBloxGPSI2C, UBloxGen9>
 {
 public:
     /**
@@ -20,15 +22,16 @@ public:
      *                     on \c i2c before using the GPS.
      * @param user_RSTpin  Output pin connected to NRST
      * @param i2cAddress   I2C address. The MAX8 defaults to 0x42
+     * @param i2cFrequency Frequency which \c i2c is set to, used to budget bus bandwidth
      */
-    ZEDF9PI2C(I2C & i2c, PinName user_RSTpin, uint8_t i2cAddress = UBloxGPS_I2C_DEF_ADDRESS):
+    ZEDF9PI2C(I2C & i2c, PinName user_RSTpin, uint8_t i2cAddress = UBloxGPS_I2C_DEF_ADDRESS,
+        int i2cFrequency = 100000):
     UBloxGPS(user_RSTpin),
-    UBloxGPSI2C(i2c, user_RSTpin, i2cAddress),
-    UBloxGen9(MSGOUT_OFFSET_SPI)
+    UBloxReceiver(user_RSTpin, i2c, user_RSTpin, i2cAddress, i2cFrequency)
     {}
 };
 
-class ZEDF9PSPI : public UBloxGPSSPI, public UBloxGen9
+class ZEDF9PSPI final : public UBloxReceiver<UBloxGPSSPI, UBloxGen9>
 {
 public:
     /**
@@ -45,8 +48,27 @@ public:
     ZEDF9PSPI(PinName user_MOSIpin, PinName user_MISOpin, PinName user_RSTPin, PinName user_SCLKPin,
         PinName user_CSPin, int spiClockRate = 1000000)
     : UBloxGPS(user_RSTPin)
-    , UBloxGPSSPI(user_MOSIpin, user_MISOpin, user_RSTPin, user_SCLKPin, user_CSPin, spiClockRate)
-    , UBloxGen9(MSGOUT_OFFSET_SPI)
+    , UBloxReceiver(user_RSTPin, user_MOSIpin, user_MISOpin, user_RSTPin, user_SCLKPin, user_CSPin, spiClockRate)
+    {
+    }
+};
+
+class ZEDF9PSerial final : public UBloxReceiver<UBloxGPSSerial, UBloxGen9>
+{
+public:
+    /**
+     * Construct a ZEDF9P connected to its UART1 port, providing pins and parameters.
+     *
+     * This doesn't actually initialize the chip, you will need to call begin() for that.
+     *
+     * @param user_TXpin   UART TX pin, connected to the ZED-F9P's RXD pin
+     * @param user_RXpin   UART RX pin, connected to the ZED-F9P's TXD pin
+     * @param user_RSTPin  Output pin connected to NRST
+     * @param baudRate     Baud rate the ZED-F9P is set to.  The ZED-F9P defaults to 38400.
+     */
+    ZEDF9PSerial(PinName user_TXpin, PinName user_RXpin, PinName user_RSTPin, int baudRate = 38400)
+    : UBloxGPS(user_RSTPin)
+    , UBloxReceiver(user_RSTPin, user_TXpin, user_RXpin, user_RSTPin, baudRate)
     {
     }
 };
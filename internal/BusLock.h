@@ -0,0 +1,46 @@
+#ifndef BUS_LOCK_H
+#define BUS_LOCK_H
+
+#include "../UBloxGPS.h"
+
+namespace UBlox
+{
+
+/**
+ * @brief Holds the lock of a shared Mbed bus (I2C or SPI) for its lifetime, and records how long
+ * the lock took to get and how long it was held in the driver statistics.
+ *
+ * Scope this tightly around each physical transfer, and parse what was read after it is released,
+ * so that other drivers on the bus are held up for as little time as possible.
+ */
+template <typename Bus> class BusLock
+{
+public:
+    BusLock(Bus& bus, DriverStatistics& stats)
+        : bus_(bus)
+        , stats_(stats)
+    {
+        const us_time waitStart = UBloxGPS::now();
+        bus_.lock();
+        lockTime_ = UBloxGPS::now();
+        stats_.busLockWait.record(static_cast<uint32_t>((lockTime_ - waitStart).count()));
+    }
+
+    ~BusLock()
+    {
+        bus_.unlock();
+        stats_.busLockHold.record(static_cast<uint32_t>((UBloxGPS::now() - lockTime_).count()));
+    }
+
+    BusLock(BusLock const &) = delete;
+    BusLock& operator=(BusLock const &) = delete;
+
+private:
+    Bus& bus_;
+    DriverStatistics& stats_;
+    us_time lockTime_;
+};
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Tests for the asynchronous command API.
+ */
+
+#include "FakeGPS.h"
+#include "TestHelpers.h"
+
+using namespace UBlox;
+
+namespace
+{
+using CommandResult = UBloxGPS::CommandResult;
+
+struct Completion
+{
+    int tag;
+    CommandResult result;
+    size_t length;
+};
+
+UBloxGPS::CommandCallback recordTo(std::vector<Completion>& completions, int tag)
+{
+    return [&completions, tag](CommandResult result, const uint8_t* message, size_t length) {
+        completions.push_back({ tag, result, message != nullptr ? length : 0 });
+    };
+}
+
+void testCompletion()
+{
+    FakeGPS gps;
+    std::vector<Completion> completions;
+    const uint8_t data[4] = { 1, 2, 3, 4 };
+
+    CHECK(gps.sendCommandAsync(UBX_CLASS_CFG, UBX_CFG_VALSET, data, 4, false, recordTo(completions, 1)));
+    CHECK(gps.sendCommandAsync(UBX_CLASS_CFG, UBX_CFG_VALSET, data, 4, false, recordTo(completions, 2)));
+    CHECK(gps.pollAsync(UBX_CLASS_MON, UBX_MON_VER, recordTo(completions, 3)));
+    CHECK(gps.pollAsync(UBX_CLASS_NAV, UBX_NAV_TIMELS, recordTo(completions, 4), 200ms));
+
+    // Table is full
+    CHECK(!gps.sendCommandAsync(UBX_CLASS_CFG, UBX_CFG_RST, data, 4, false, recordTo(completions, 5)));
+    CHECK(gps.getPendingCommandCount() == UBLOX_GNSS_MAX_PENDING_COMMANDS);
+
+    // Answers to commands for the same message go to the oldest first
+    gps.queueUBX(UBX_CLASS_MON, UBX_MON_VER, std::vector<uint8_t>(40, 'v'));
+    gps.queueUBX(UBX_CLASS_ACK, UBX_ACK_ACK, { UBX_CLASS_CFG, UBX_CFG_VALSET });
+    gps.queueUBX(UBX_CLASS_ACK, UBX_ACK_NACK, { UBX_CLASS_CFG, UBX_CFG_VALSET });
+    while (gps.update(0us) > 0)
+    {
+    }
+
+    CHECK(completions.size() == 3);
+    if (completions.size() == 3)
+    {
+        CHECK(completions[0].tag == 3 && completions[0].result == CommandResult::RESPONSE);
+        CHECK(completions[0].length == 40 + UBX_HEADER_FOOTER_LENGTH);
+        CHECK(completions[1].tag == 1 && completions[1].result == CommandResult::ACK);
+        CHECK(completions[2].tag == 2 && completions[2].result == CommandResult::NACK);
+    }
+    CHECK(gps.getPendingCommandCount() == 1);
+
+    mbed::g_fakeTimeUs += 300000;
+    gps.update(0us);
+    CHECK(completions.size() == 4 && completions.back().tag == 4
+        && completions.back().result == CommandResult::TIMEOUT);
+    CHECK(gps.getPendingCommandCount() == 0);
+    CHECK(gps.getStatistics().nacks == 1);
+    CHECK(gps.getStatistics().timeouts == 1);
+}
+
+void testSendFromCallback()
+{
+    // Answers are parsed while a longer command is being sent in blocks, like SPI
+    FakeGPS gps;
+    gps.duplexBlockSize = 32;
+
+    const uint8_t data[4] = { 1, 2, 3, 4 };
+    bool nestedSendResult = true;
+    int callbacks = 0;
+    CHECK(gps.sendCommandAsync(UBX_CLASS_CFG, UBX_CFG_VALSET, data, 4, false,
+        [&](CommandResult result, const uint8_t* message, size_t length) {
+            callbacks++;
+            nestedSendResult = gps.sendCommandAsync(UBX_CLASS_CFG, UBX_CFG_RST, data, 4, false, nullptr);
+        }));
+    gps.queueUBX(UBX_CLASS_ACK, UBX_ACK_ACK, { UBX_CLASS_CFG, UBX_CFG_VALSET });
+
+    // Two blocks long.  The ACK is received during the first one.
+    std::vector<uint8_t> payload(50);
+    for (size_t i = 0; i < payload.size(); i++)
+    {
+        payload[i] = static_cast<uint8_t>(i);
+    }
+    uint8_t expected[128];
+    const size_t expectedLen = buildUBXPacket(
+        expected, sizeof(expected), UBX_CLASS_CFG, UBX_CFG_TP5, payload.data(), payload.size());
+
+    gps.sent.clear();
+    CHECK(gps.sendCommand(UBX_CLASS_CFG, UBX_CFG_TP5, payload.data(), payload.size(), false, false, 0us));
+
+    CHECK(callbacks == 1);
+    CHECK(!nestedSendResult);
+    CHECK(gps.sent == std::vector<uint8_t>(expected, expected + expectedLen));
+    CHECK(gps.getPendingCommandCount() == 0);
+
+    // Sending works again once the callback has returned
+    CHECK(gps.sendCommandAsync(UBX_CLASS_CFG, UBX_CFG_RST, data, 4, false, nullptr));
+}
+}
+
+int main()
+{
+    testCompletion();
+    testSendFromCallback();
+    return testResult();
+}
@@ -0,0 +1,50 @@
+#ifndef UBLOX_BENCHMARK_HELPERS_H
+#define UBLOX_BENCHMARK_HELPERS_H
+
+#include <chrono>
+#include <cstdio>
+
+/**
+ * @brief Stop the compiler from optimizing away the computation of \c value.
+ */
+template <typename T> inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+/**
+ * @brief Call \c function repeatedly for about 200ms of host (not fake) time, and print the time
+ * per item and the items per second.
+ *
+ * @param name Name to print
+ * @param itemsPerCall Number of items (conversions, frames, etc.) processed by each call
+ * @param function Function to benchmark
+ */
+template <typename Function> void benchmark(const char* name, size_t itemsPerCall, Function function)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr std::chrono::milliseconds RUN_TIME(200);
+
+    // Warm up the caches and branch predictors
+    function();
+
+    size_t calls = 0;
+    const Clock::time_point start = Clock::now();
+    Clock::duration elapsed;
+    do
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            function();
+        }
+        calls += 16;
+        elapsed = Clock::now() - start;
+    } while (elapsed < RUN_TIME);
+
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    const double items = static_cast<double>(calls) * itemsPerCall;
+    printf("%-40s %10.2f ns/item %10.3f M items/s\n", name, seconds * 1e9 / items,
+        items / seconds / 1e6);
+}
+
+#endif // UBLOX_BENCHMARK_HELPERS_H
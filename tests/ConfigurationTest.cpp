@@ -0,0 +1,142 @@
+/*
+ * Tests for the configuration sent by begin() and beginAsync().
+ */
+
+#include "FakeGPS.h"
+#include "TestHelpers.h"
+
+using namespace UBlox;
+
+namespace
+{
+using BeginState = UBloxGPS::BeginState;
+
+/// Indices of the configuration steps sent, from the payloads of the CFG-VALSET commands
+std::vector<uint8_t> stepsSent(const FakeGPS& gps)
+{
+    std::vector<uint8_t> steps;
+    for (size_t i = 0; i + UBX_HEADER_FOOTER_LENGTH < gps.sent.size(); i++)
+    {
+        if (gps.sent[i] == UBX_SYNC_CHAR_1 && gps.sent[i + 1] == UBX_SYNC_CHAR_2
+            && gps.sent[i + 2] == UBX_CLASS_CFG && gps.sent[i + 3] == UBX_CFG_VALSET)
+        {
+            steps.push_back(gps.sent[i + UBX_DATA_OFFSET]);
+        }
+    }
+    return steps;
+}
+
+void testConfigureRunsEveryStep()
+{
+    FakeGPS gps;
+    gps.configAnswers = { true, false, true };
+
+    CHECK(!gps.configure());
+    CHECK((stepsSent(gps) == std::vector<uint8_t>{ 0, 1, 2 }));
+    CHECK(gps.getStatistics().nacks == 1);
+
+    FakeGPS goodGPS;
+    goodGPS.configAnswers = { true, true };
+    CHECK(goodGPS.configure());
+}
+
+void testBeginAsyncRunsEveryStep()
+{
+    FakeGPS gps;
+    gps.configAnswers = { false, true, true };
+
+    gps.beginAsync(true);
+    mbed::g_fakeTimeUs += std::chrono::microseconds(BOOT_TIME).count();
+    CHECK(gps.poll() == BeginState::CHECKING_VERSION);
+    gps.queueUBX(UBX_CLASS_MON, UBX_MON_VER, std::vector<uint8_t>(40, 'v'));
+
+    BeginState state = BeginState::CHECKING_VERSION;
+    for (int i = 0; i < 10 && state != BeginState::DONE && state != BeginState::FAILED; i++)
+    {
+        state = gps.poll();
+    }
+
+    CHECK(state == BeginState::FAILED);
+    CHECK((stepsSent(gps) == std::vector<uint8_t>{ 0, 1, 2 }));
+    CHECK(gps.getStatistics().nacks == 1);
+}
+
+void testLateAnswerNotTakenForNextStep()
+{
+    // Every step is a CFG-VALSET.  The NACK for step 0 arrives after it has timed out, but
+    // before step 1 would have been answered, and must not be taken as step 1's answer.
+    FakeGPS gps;
+    gps.configAnswers = { false, true, true };
+    gps.configAnswerUs = 100000;
+    gps.lateConfigStep = 0;
+    gps.lateConfigAnswerUs = 1050000;
+
+    CHECK(!gps.configure());
+    CHECK((stepsSent(gps) == std::vector<uint8_t>{ 0, 1, 2 }));
+    const DriverStatistics stats = gps.getStatistics();
+    CHECK(stats.timeouts == 1);
+    CHECK(stats.nacks == 0);
+    CHECK(gps.bytesReceived() == gps.incoming.size());
+    CHECK(gps.scheduled.empty());
+}
+
+void testLostAnswerDoesNotStall()
+{
+    // A step whose answer never arrives only holds the next one back for a second timeout
+    FakeGPS gps;
+    gps.configAnswers = { true, true };
+    gps.lateConfigStep = 0;
+    gps.lateConfigAnswerUs = 1000000000;
+
+    const int64_t start = mbed::g_fakeTimeUs;
+    CHECK(!gps.configure());
+    CHECK((stepsSent(gps) == std::vector<uint8_t>{ 0, 1 }));
+    CHECK(gps.getStatistics().timeouts == 1);
+    CHECK(mbed::g_fakeTimeUs - start < 2100000);
+}
+
+void testAsyncCommandSentFirst()
+{
+    // An async CFG-VALSET sent before a configuration step is answered first, and keeps its
+    // answer
+    FakeGPS gps;
+    gps.configAnswers = { false };
+    gps.configAnswerUs = 50000;
+
+    std::vector<UBloxGPS::CommandResult> asyncResults;
+    gps.beginAsync(true);
+    mbed::g_fakeTimeUs += std::chrono::microseconds(BOOT_TIME).count();
+    CHECK(gps.poll() == BeginState::CHECKING_VERSION);
+    const uint8_t data[4] = { 0, 1, 0, 0 };
+    CHECK(gps.sendCommandAsync(UBX_CLASS_CFG, UBX_CFG_VALSET, data, 4, false,
+        [&asyncResults](UBloxGPS::CommandResult result, const uint8_t*, size_t) {
+            asyncResults.push_back(result);
+        }));
+    gps.queueUBXAt(mbed::g_fakeTimeUs + 10000, UBX_CLASS_ACK, UBX_ACK_ACK,
+        { UBX_CLASS_CFG, UBX_CFG_VALSET });
+    gps.queueUBX(UBX_CLASS_MON, UBX_MON_VER, std::vector<uint8_t>(40, 'v'));
+    CHECK(gps.poll() == BeginState::CONFIGURING);
+
+    BeginState state = BeginState::CONFIGURING;
+    for (int i = 0; i < 1000 && state == BeginState::CONFIGURING; i++)
+    {
+        mbed::g_fakeTimeUs += 1000;
+        state = gps.poll();
+    }
+
+    CHECK(state == BeginState::FAILED);
+    CHECK((asyncResults == std::vector<UBloxGPS::CommandResult>{ UBloxGPS::CommandResult::ACK }));
+    CHECK(gps.getStatistics().nacks == 1);
+    CHECK(gps.getStatistics().timeouts == 0);
+}
+}
+
+int main()
+{
+    testConfigureRunsEveryStep();
+    testBeginAsyncRunsEveryStep();
+    testLateAnswerNotTakenForNextStep();
+    testLostAnswerDoesNotStall();
+    testAsyncCommandSentFirst();
+    return testResult();
+}
@@ -0,0 +1,79 @@
+/*
+ * Host benchmark of the coordinate conversions, in conversions per second, comparing the batch
+ * (structure-of-arrays) functions with converting one position at a time.
+ */
+
+#include "BenchmarkHelpers.h"
+#include "UBloxCoordinates.h"
+
+#include <vector>
+
+using namespace UBlox;
+
+int main()
+{
+    // A track a few kilometers long
+    constexpr size_t COUNT = 1024;
+    std::vector<double> latitude(COUNT), longitude(COUNT), height(COUNT);
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        latitude[i] = 34.0522 + i * 2e-5;
+        longitude[i] = -118.2437 - i * 1e-5;
+        height[i] = 100.0 + i * 0.01;
+    }
+    std::vector<double> x(COUNT), y(COUNT), z(COUNT);
+    std::vector<double> east(COUNT), north(COUNT), up(COUNT);
+    const LocalFrame frame(34.0522, -118.2437, 100.0);
+
+    benchmark("geodeticToECEF, one at a time", COUNT, [&]() {
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            const ECEFPosition ecef = geodeticToECEF(latitude[i], longitude[i], height[i]);
+            x[i] = ecef.x;
+            y[i] = ecef.y;
+            z[i] = ecef.z;
+        }
+        doNotOptimize(z[COUNT - 1]);
+    });
+    benchmark("geodeticToECEF, batch", COUNT, [&]() {
+        geodeticToECEF(latitude.data(), longitude.data(), height.data(), x.data(), y.data(),
+            z.data(), COUNT);
+        doNotOptimize(z[COUNT - 1]);
+    });
+
+    std::vector<double> latitudeOut(COUNT), longitudeOut(COUNT), heightOut(COUNT);
+    benchmark("ecefToGeodetic, one at a time", COUNT, [&]() {
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            ecefToGeodetic(ECEFPosition{ x[i], y[i], z[i] }, latitudeOut[i], longitudeOut[i],
+                heightOut[i]);
+        }
+        doNotOptimize(heightOut[COUNT - 1]);
+    });
+    benchmark("ecefToGeodetic, batch", COUNT, [&]() {
+        ecefToGeodetic(x.data(), y.data(), z.data(), latitudeOut.data(), longitudeOut.data(),
+            heightOut.data(), COUNT);
+        doNotOptimize(heightOut[COUNT - 1]);
+    });
+
+    benchmark("LocalFrame::ecefToENU, one at a time", COUNT, [&]() {
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            const ENUPosition enu = frame.ecefToENU(ECEFPosition{ x[i], y[i], z[i] });
+            east[i] = enu.east;
+            north[i] = enu.north;
+            up[i] = enu.up;
+        }
+        doNotOptimize(up[COUNT - 1]);
+    });
+    benchmark("LocalFrame::ecefToENU, batch", COUNT, [&]() {
+        frame.ecefToENU(x.data(), y.data(), z.data(), east.data(), north.data(), up.data(), COUNT);
+        doNotOptimize(up[COUNT - 1]);
+    });
+    benchmark("LocalFrame::geodeticToENU, batch", COUNT, [&]() {
+        frame.geodeticToENU(latitude.data(), longitude.data(), height.data(), east.data(),
+            north.data(), up.data(), COUNT);
+        doNotOptimize(up[COUNT - 1]);
+    });
+    return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * Tests for the WGS84 geodetic, ECEF and local frame conversions.
+ */
+
+#include "TestHelpers.h"
+#include "UBloxCoordinates.h"
+
+using namespace UBlox;
+
+namespace
+{
+struct ReferencePoint
+{
+    double latitude;
+    double longitude;
+    double height;
+    double x;
+    double y;
+    double z;
+};
+
+// ECEF coordinates computed separately in double precision
+const ReferencePoint referencePoints[] = {
+    { 0, 0, 0, 6378137.0, 0, 0 },
+    { 90, 0, 0, 0, 0, 6356752.314245 },
+    { 45, 90, 1000, 0, 4518297.985630, 4488055.515647 },
+    { 34.0522, -118.2437, 100, -2503396.519860, -4660276.422747, 3551301.354087 },
+    { -33.8688, 151.2093, -30, -4646029.441777, 2553194.345531, -3534355.669122 },
+};
+
+/// Degrees of latitude per meter, roughly
+constexpr double DEG_PER_METER = 1.0 / 111000.0;
+
+void testGeodeticToECEF()
+{
+    for (const ReferencePoint& point : referencePoints)
+    {
+        const ECEFPosition ecef = geodeticToECEF(point.latitude, point.longitude, point.height);
+        CHECK_NEAR(ecef.x, point.x, 1e-5);
+        CHECK_NEAR(ecef.y, point.y, 1e-5);
+        CHECK_NEAR(ecef.z, point.z, 1e-5);
+    }
+}
+
+void testECEFToGeodetic()
+{
+    for (const ReferencePoint& point : referencePoints)
+    {
+        double latitude, longitude, height;
+        ecefToGeodetic({ point.x, point.y, point.z }, latitude, longitude, height);
+        CHECK_NEAR(latitude, point.latitude, 1e-4 * DEG_PER_METER);
+        CHECK_NEAR(height, point.height, 1e-4);
+        if (point.latitude != 90)
+        {
+            CHECK_NEAR(longitude, point.longitude, 1e-9);
+        }
+    }
+
+    // Round trip near the pole, and at orbital height
+    const double testPoints[][3] = { { 89.9999, 10, 5000 }, { -12.5, -45, 400000 }, { 60, 179.9, -100 } };
+    for (const auto& point : testPoints)
+    {
+        double latitude, longitude, height;
+        ecefToGeodetic(geodeticToECEF(point[0], point[1], point[2]), latitude, longitude, height);
+        CHECK_NEAR(latitude, point[0], 1e-3 * DEG_PER_METER);
+        CHECK_NEAR(longitude, point[1], 1e-7);
+        CHECK_NEAR(height, point[2], 1e-3);
+    }
+}
+
+void testLocalFrame()
+{
+    const LocalFrame frame(34.0, -118.0, 0);
+
+    // The origin is at the origin
+    const ENUPosition origin = frame.geodeticToENU(34.0, -118.0, 0);
+    CHECK_NEAR(origin.east, 0, 1e-6);
+    CHECK_NEAR(origin.north, 0, 1e-6);
+    CHECK_NEAR(origin.up, 0, 1e-6);
+
+    // Straight up
+    const ENUPosition above = frame.geodeticToENU(34.0, -118.0, 25);
+    CHECK_NEAR(above.east, 0, 1e-6);
+    CHECK_NEAR(above.north, 0, 1e-6);
+    CHECK_NEAR(above.up, 25, 1e-6);
+
+    // 0.001 degrees north is about 110.9 m at this latitude, and the ground curves away slightly
+    const ENUPosition north = frame.geodeticToENU(34.001, -118.0, 0);
+    CHECK_NEAR(north.east, 0, 1e-6);
+    CHECK_NEAR(north.north, 110.9, 0.1);
+    CHECK(north.up < 0 && north.up > -0.01);
+
+    const NEDPosition ned = LocalFrame::toNED(north);
+    CHECK_NEAR(ned.north, north.north, 0);
+    CHECK_NEAR(ned.down, -north.up, 0);
+
+    // Back again
+    double latitude, longitude, height;
+    frame.enuToGeodetic(north, latitude, longitude, height);
+    CHECK_NEAR(latitude, 34.001, 1e-4 * DEG_PER_METER);
+    CHECK_NEAR(longitude, -118.0, 1e-9);
+    CHECK_NEAR(height, 0, 1e-4);
+}
+
+void testBatchConversions()
+{
+    constexpr size_t COUNT = 40;
+    double latitude[COUNT], longitude[COUNT], height[COUNT];
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        latitude[i] = -80.0 + 4.0 * i;
+        longitude[i] = -170.0 + 8.5 * i;
+        height[i] = 10.0 * i;
+    }
+
+    double x[COUNT], y[COUNT], z[COUNT];
+    geodeticToECEF(latitude, longitude, height, x, y, z, COUNT);
+
+    double latitudeOut[COUNT], longitudeOut[COUNT], heightOut[COUNT];
+    ecefToGeodetic(x, y, z, latitudeOut, longitudeOut, heightOut, COUNT);
+
+    // Longer than one block of the buffered conversion
+    const LocalFrame frame(latitude[3], longitude[3], height[3]);
+    double east[COUNT], north[COUNT], up[COUNT];
+    frame.geodeticToENU(latitude, longitude, height, east, north, up, COUNT);
+
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        const ECEFPosition ecef = geodeticToECEF(latitude[i], longitude[i], height[i]);
+        CHECK_NEAR(x[i], ecef.x, 0);
+        CHECK_NEAR(y[i], ecef.y, 0);
+        CHECK_NEAR(z[i], ecef.z, 0);
+
+        CHECK_NEAR(latitudeOut[i], latitude[i], 1e-4 * DEG_PER_METER);
+        CHECK_NEAR(longitudeOut[i], longitude[i], 1e-9);
+        CHECK_NEAR(heightOut[i], height[i], 1e-4);
+
+        const ENUPosition enu = frame.ecefToENU(ecef);
+        CHECK_NEAR(east[i], enu.east, 1e-6);
+        CHECK_NEAR(north[i], enu.north, 1e-6);
+        CHECK_NEAR(up[i], enu.up, 1e-6);
+    }
+}
+}
+
+int main()
+{
+    testGeodeticToECEF();
+    testECEFToGeodetic();
+    testLocalFrame();
+    testBatchConversions();
+    return testResult();
+}
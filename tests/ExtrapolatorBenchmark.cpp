@@ -0,0 +1,43 @@
+/*
+ * Host benchmark of PositionExtrapolator::predictPosition(), the cost of each position query
+ * between fixes.
+ */
+
+#include "BenchmarkHelpers.h"
+#include "UBloxExtrapolator.h"
+
+using namespace UBlox;
+using namespace std::chrono;
+
+int main()
+{
+    PositionExtrapolator extrapolator;
+
+    GeodeticPosition position{};
+    position.latitude = 34.0522;
+    position.longitude = -118.2437;
+    position.height = 100000;
+    VelocityNED velocity{};
+    velocity.northVel = 12000;
+    velocity.eastVel = -3000;
+    velocity.speedAccuracy = 300;
+    FixQuality fix{};
+    fix.fixQuality = GPSFix::FIX_3D;
+    extrapolator.onNavigationSolution(position, velocity, fix);
+
+    // Queries 1ms apart, as from a 1kHz control loop
+    constexpr size_t QUERIES = 1000;
+    benchmark("predictPosition", QUERIES, [&]() {
+        ExtrapolatedPosition prediction;
+        for (size_t i = 0; i < QUERIES; i++)
+        {
+            extrapolator.predictPosition(milliseconds(i), prediction);
+            doNotOptimize(prediction);
+        }
+    });
+
+    benchmark("onNavigationSolution", 1, [&]() {
+        extrapolator.onNavigationSolution(position, velocity, fix);
+    });
+    return 0;
+}
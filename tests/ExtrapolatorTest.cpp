@@ -0,0 +1,111 @@
+/*
+ * Tests for PositionExtrapolator.
+ */
+
+#include "TestHelpers.h"
+#include "UBloxCoordinates.h"
+#include "UBloxExtrapolator.h"
+
+#include <cmath>
+
+using namespace UBlox;
+using namespace std::chrono;
+
+namespace
+{
+constexpr microseconds FIX_TIME = seconds(100);
+
+/**
+ * @brief Feed a 3D fix at FIX_TIME into the extrapolator.  Velocities are in mm/s.
+ */
+void feedFix(PositionExtrapolator& extrapolator, double latitude, double longitude,
+    int32_t northVel, int32_t eastVel, int32_t downVel, GPSFix fixType = GPSFix::FIX_3D)
+{
+    GeodeticPosition position{};
+    position.latitude = latitude;
+    position.longitude = longitude;
+    position.height = 100000;
+    position.rxTime.firstByte = FIX_TIME;
+
+    VelocityNED velocity{};
+    velocity.northVel = northVel;
+    velocity.eastVel = eastVel;
+    velocity.downVel = downVel;
+    velocity.speedAccuracy = 200;
+
+    FixQuality fix{};
+    fix.fixQuality = fixType;
+    fix.posAccuracyHor = 1500;
+    fix.posAccuracyVer = 2500;
+
+    extrapolator.onNavigationSolution(position, velocity, fix);
+}
+
+void testKnownVelocity()
+{
+    PositionExtrapolator extrapolator(4.0f);
+    feedFix(extrapolator, 45.0, 10.0, 10000, 20000, -1000);
+
+    // Measure how far the prediction moved in the local frame at the fix
+    ExtrapolatedPosition prediction;
+    CHECK(extrapolator.predictPosition(FIX_TIME + milliseconds(500), prediction));
+    const LocalFrame frame(45.0, 10.0, 100.0);
+    const ENUPosition moved
+        = frame.geodeticToENU(prediction.latitude, prediction.longitude, prediction.height);
+    CHECK_NEAR(moved.north, 5.0, 0.01);
+    CHECK_NEAR(moved.east, 10.0, 0.01);
+    CHECK_NEAR(moved.up, 0.5, 0.01);
+    CHECK(prediction.extrapolationTime == milliseconds(500));
+
+    // Fix accuracy, plus 0.2 m/s * 0.5 s of velocity error and 0.5 * 4 m/s^2 * (0.5 s)^2
+    CHECK_NEAR(prediction.horizontalError, 1.5 + 0.1 + 0.5, 1e-4);
+    CHECK_NEAR(prediction.verticalError, 2.5 + 0.1 + 0.5, 1e-4);
+
+    // Backwards from the fix too
+    CHECK(extrapolator.predictPosition(FIX_TIME - milliseconds(500), prediction));
+    const ENUPosition before
+        = frame.geodeticToENU(prediction.latitude, prediction.longitude, prediction.height);
+    CHECK_NEAR(before.north, -5.0, 0.01);
+    CHECK_NEAR(before.east, -10.0, 0.01);
+}
+
+void testPole()
+{
+    // East velocity can't move the longitude at the pole, so it is held
+    PositionExtrapolator extrapolator;
+    feedFix(extrapolator, 90.0, 30.0, 0, 5000, 2000);
+
+    ExtrapolatedPosition prediction;
+    CHECK(extrapolator.predictPosition(FIX_TIME + milliseconds(500), prediction));
+    CHECK(std::isfinite(prediction.latitude) && std::isfinite(prediction.longitude));
+    CHECK_NEAR(prediction.latitude, 90.0, 1e-12);
+    CHECK_NEAR(prediction.longitude, 30.0, 1e-12);
+    CHECK_NEAR(prediction.height, 99.0, 1e-9);
+}
+
+void testMaxExtrapolation()
+{
+    PositionExtrapolator extrapolator(5.0f, milliseconds(250));
+    ExtrapolatedPosition prediction;
+    CHECK(!extrapolator.predictPosition(FIX_TIME, prediction));
+
+    feedFix(extrapolator, 45.0, 10.0, 1000, 0, 0);
+    CHECK(extrapolator.predictPosition(FIX_TIME + milliseconds(250), prediction));
+    CHECK(extrapolator.predictPosition(FIX_TIME - milliseconds(250), prediction));
+    CHECK(!extrapolator.predictPosition(FIX_TIME + microseconds(250001), prediction));
+    CHECK(!extrapolator.predictPosition(FIX_TIME - microseconds(250001), prediction));
+
+    // No predictions without a 3D fix
+    feedFix(extrapolator, 45.0, 10.0, 1000, 0, 0, GPSFix::FIX_2D);
+    CHECK(!extrapolator.predictPosition(FIX_TIME, prediction));
+    CHECK(extrapolator.getFixCount() == 2);
+}
+}
+
+int main()
+{
+    testKnownVelocity();
+    testPole();
+    testMaxExtrapolation();
+    return testResult();
+}
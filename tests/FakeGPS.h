@@ -0,0 +1,296 @@
+#ifndef UBLOX_FAKE_GPS_H
+#define UBLOX_FAKE_GPS_H
+
+#include "UBloxGen9.h"
+#include "UBloxGPS.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+/**
+ * @brief Transport for the host tests, which receives bytes queued by the test and records the
+ * bytes the driver sends.
+ */
+class FakeGPS : public UBlox::UBloxGPS
+{
+public:
+    explicit FakeGPS(int generation = 9)
+        : UBloxGPS(NC)
+        , generation_(generation)
+    {
+    }
+
+    /// Queue bytes for the driver to receive
+    void queueBytes(const uint8_t* data, size_t len)
+    {
+        incoming.insert(incoming.end(), data, data + len);
+    }
+
+    /// Queue a UBX message for the driver to receive
+    void queueUBX(uint8_t messageClass, uint8_t messageID, const std::vector<uint8_t>& payload)
+    {
+        uint8_t packet[UBLOX_GNSS_RX_BUFFER_SIZE];
+        const size_t len = UBlox::buildUBXPacket(
+            packet, sizeof(packet), messageClass, messageID, payload.data(), payload.size());
+        queueBytes(packet, len);
+    }
+
+    /// Queue a UBX message for the driver to receive once the fake clock reaches \c timeUs
+    void queueUBXAt(int64_t timeUs, uint8_t messageClass, uint8_t messageID,
+        const std::vector<uint8_t>& payload)
+    {
+        uint8_t packet[UBLOX_GNSS_RX_BUFFER_SIZE];
+        const size_t len = UBlox::buildUBXPacket(
+            packet, sizeof(packet), messageClass, messageID, payload.data(), payload.size());
+        auto position = std::upper_bound(scheduled.begin(), scheduled.end(), timeUs,
+            [](int64_t time, const ScheduledBytes& entry) { return time < entry.first; });
+        scheduled.insert(position, { timeUs, std::vector<uint8_t>(packet, packet + len) });
+    }
+
+    /// Bytes received by the driver so far
+    size_t bytesReceived() const
+    {
+        return readPosition;
+    }
+
+    /// Bytes queued for the driver to receive
+    std::vector<uint8_t> incoming;
+    size_t readPosition = 0;
+
+    /// Bytes to be moved into \c incoming at a fake time (us), in time order
+    using ScheduledBytes = std::pair<int64_t, std::vector<uint8_t>>;
+    std::vector<ScheduledBytes> scheduled;
+
+    /// Bytes sent by the driver, and the length of each write
+    std::vector<uint8_t> sent;
+    std::vector<size_t> writeLengths;
+
+    /// If nonzero, writes are made in blocks of this size, and incoming bytes are received
+    /// (and parsed) between the blocks, like SPI
+    size_t duplexBlockSize = 0;
+
+    /// Rates set with setMessageRate(), as { class, ID, rate }
+    std::vector<std::array<uint8_t, 3>> rateCommands;
+
+    /// Answer to each configuration step (true for ACK, false for NACK).  Each step sends a
+    /// CFG-VALSET holding its index, and queues its answer as it is sent.
+    std::vector<bool> configAnswers;
+
+    /// Time (us) from sending a configuration step to its answer, and a step whose answer takes
+    /// lateConfigAnswerUs instead
+    int64_t configAnswerUs = 0;
+    size_t lateConfigStep = SIZE_MAX;
+    int64_t lateConfigAnswerUs = 0;
+
+    using UBloxGPS::configure;
+
+    /// Value returned by getBusBandwidth() (bytes/s).  Reading advances the fake clock at this
+    /// rate.
+    uint32_t busBandwidth = 100000;
+
+    int getGPSGeneration() override
+    {
+        return generation_;
+    }
+
+    bool setMessageRate(uint8_t messageClass, uint8_t messageID, uint8_t rate) override
+    {
+        rateCommands.push_back({ messageClass, messageID, rate });
+        recordMessageRate(messageClass, messageID, rate);
+        return true;
+    }
+
+    uint32_t getBusBandwidth() const override
+    {
+        return busBandwidth;
+    }
+
+    bool enableTimemarkOutput(bool enabled) override
+    {
+        return true;
+    }
+
+    using UBloxGPS::sendCommand;
+
+protected:
+    const char* getName() override
+    {
+        return "FakeGPS";
+    }
+
+    bool sendMessage(const uint8_t* packet, uint16_t packetLen) override
+    {
+        writeLengths.push_back(packetLen);
+        if (duplexBlockSize == 0)
+        {
+            sent.insert(sent.end(), packet, packet + packetLen);
+            return true;
+        }
+
+        for (size_t offset = 0; offset < packetLen; offset += duplexBlockSize)
+        {
+            const size_t blockLen = std::min<size_t>(packetLen - offset, duplexBlockSize);
+            sent.insert(sent.end(), packet + offset, packet + offset + blockLen);
+
+            const size_t rxLen = std::min(blockLen, incoming.size() - readPosition);
+            const uint8_t* rxData = incoming.data() + readPosition;
+            readPosition += rxLen;
+            for (size_t rxOffset = 0; rxOffset < rxLen;)
+            {
+                size_t consumed;
+                receiveBytes(rxData + rxOffset, rxLen - rxOffset, consumed);
+                rxOffset += consumed;
+            }
+        }
+        return true;
+    }
+
+    ReadStatus readMessage() override
+    {
+        while (!scheduled.empty() && scheduled.front().first <= mbed::g_fakeTimeUs)
+        {
+            queueBytes(scheduled.front().second.data(), scheduled.front().second.size());
+            scheduled.erase(scheduled.begin());
+        }
+
+        while (true)
+        {
+            const size_t readLen = std::min(
+                { rxBytesWanted(), transferBudgetRemaining(), incoming.size() - readPosition });
+            if (readLen == 0)
+            {
+                return ReadStatus::NO_DATA;
+            }
+
+            uint8_t* const readPointer = rxWritePointer();
+            memcpy(readPointer, incoming.data() + readPosition, readLen);
+            readPosition += readLen;
+            mbed::g_fakeTimeUs += readLen * 1000000 / busBandwidth;
+            stats_.bytesRead += readLen;
+            spendTransferBudget(readLen);
+
+            size_t consumed;
+            const ReadStatus status = receiveBytes(readPointer, readLen, consumed);
+            if (status != ReadStatus::NO_DATA)
+            {
+                return status;
+            }
+        }
+    }
+
+    void waitForData(UBlox::us_time timeout) override
+    {
+        mbed::g_fakeTimeUs += timeout.count();
+    }
+
+    bool sendBaudRateCommand(uint32_t baudRate) override
+    {
+        return true;
+    }
+
+    bool sendMeasurementPeriod(uint16_t periodMs) override
+    {
+        return true;
+    }
+
+    size_t getNumConfigurationSteps() const override
+    {
+        return configAnswers.size();
+    }
+
+    bool sendConfigurationStep(size_t step) override
+    {
+        const uint8_t data[1] = { static_cast<uint8_t>(step) };
+        if (!sendCommand(UBX_CLASS_CFG, UBX_CFG_VALSET, data, 1, false, false, 0us))
+        {
+            return false;
+        }
+        const int64_t delay = step == lateConfigStep ? lateConfigAnswerUs : configAnswerUs;
+        queueUBXAt(mbed::g_fakeTimeUs + delay, UBX_CLASS_ACK,
+            configAnswers[step] ? UBX_ACK_ACK : UBX_ACK_NACK, { UBX_CLASS_CFG, UBX_CFG_VALSET });
+        return true;
+    }
+
+private:
+    const int generation_;
+};
+
+/**
+ * @brief ZED-F9P with the same fake transport as FakeGPS, for testing UBloxGen9 itself and
+ * MovingBaseLink.  Every CFG-VALSET sent is acknowledged.
+ */
+class FakeZEDF9P : public UBlox::UBloxGen9
+{
+public:
+    FakeZEDF9P()
+        : UBloxGPS(NC)
+        , UBloxGen9(0)
+    {
+    }
+
+    /// Bytes queued for the driver to receive
+    std::vector<uint8_t> incoming;
+    size_t readPosition = 0;
+
+    /// Bytes sent by the driver
+    std::vector<uint8_t> sent;
+
+    /// Value returned by getBusBandwidth() (bytes/s)
+    uint32_t busBandwidth = 100000;
+
+    uint32_t getBusBandwidth() const override
+    {
+        return busBandwidth;
+    }
+
+    using UBloxGen9::sendBaudRateCommand;
+
+protected:
+    bool sendMessage(const uint8_t* packet, uint16_t packetLen) override
+    {
+        sent.insert(sent.end(), packet, packet + packetLen);
+        if (packetLen > UBX_HEADER_FOOTER_LENGTH && packet[0] == UBX_SYNC_CHAR_1
+            && packet[2] == UBX_CLASS_CFG && packet[3] == UBX_CFG_VALSET)
+        {
+            const uint8_t ackData[2] = { UBX_CLASS_CFG, UBX_CFG_VALSET };
+            uint8_t ack[UBX_HEADER_FOOTER_LENGTH + sizeof(ackData)];
+            UBlox::buildUBXPacket(
+                ack, sizeof(ack), UBX_CLASS_ACK, UBX_ACK_ACK, ackData, sizeof(ackData));
+            incoming.insert(incoming.end(), ack, ack + sizeof(ack));
+        }
+        return true;
+    }
+
+    ReadStatus readMessage() override
+    {
+        while (true)
+        {
+            const size_t readLen = std::min(
+                { rxBytesWanted(), transferBudgetRemaining(), incoming.size() - readPosition });
+            if (readLen == 0)
+            {
+                return ReadStatus::NO_DATA;
+            }
+
+            uint8_t* const readPointer = rxWritePointer();
+            memcpy(readPointer, incoming.data() + readPosition, readLen);
+            readPosition += readLen;
+            spendTransferBudget(readLen);
+
+            size_t consumed;
+            const ReadStatus status = receiveBytes(readPointer, readLen, consumed);
+            if (status != ReadStatus::NO_DATA)
+            {
+                return status;
+            }
+        }
+    }
+
+    void waitForData(UBlox::us_time timeout) override
+    {
+        mbed::g_fakeTimeUs += timeout.count();
+    }
+};
+
+#endif // UBLOX_FAKE_GPS_H
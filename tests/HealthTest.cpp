@@ -0,0 +1,84 @@
+/*
+ * Tests for decoding the health monitoring messages.
+ */
+
+#include "FakeGPS.h"
+#include "TestHelpers.h"
+
+using namespace UBlox;
+
+namespace
+{
+/**
+ * @brief Make a health snapshot with one band whose jamming state is unknown.
+ */
+ReceiverHealth makeHealth()
+{
+    ReceiverHealth health = {};
+    health.numBands = 1;
+    health.bands[0].jammingState = JammingState::UNKNOWN;
+    return health;
+}
+
+void testSEC_SIGVersion1()
+{
+    std::vector<uint8_t> payload(12, 0);
+    payload[0] = 1;
+    payload[4] = 0x1 | (2 << 1); // jamDetEnabled, jammingState = warning
+    payload[8] = 0x1 | (3 << 1); // spfDetEnabled, spoofingState = affirmed
+
+    uint8_t message[64];
+    buildUBXPacket(message, sizeof(message), UBX_CLASS_SEC, UBX_SEC_SIG, payload.data(), payload.size());
+
+    ReceiverHealth health = makeHealth();
+    parseSEC_SIG(message, health);
+    CHECK(health.bands[0].jammingState == JammingState::WARNING);
+    CHECK(health.spoofingState == SpoofingState::MULTIPLE_INDICATED);
+}
+
+void testSEC_SIGVersion2()
+{
+    // No jammed center frequencies, so the payload ends after the fixed part.  The bytes after it
+    // are filled with garbage to make sure they aren't read.
+    std::vector<uint8_t> payload(4, 0);
+    payload[0] = 2;
+    payload[1] = 0x1 | (3 << 1) | 0x8 | (1 << 4); // jamming critical, no spoofing
+    payload[3] = 0; // jamNumCentFreqs
+
+    uint8_t message[64];
+    memset(message, 0xFF, sizeof(message));
+    buildUBXPacket(message, sizeof(message), UBX_CLASS_SEC, UBX_SEC_SIG, payload.data(), payload.size());
+
+    ReceiverHealth health = makeHealth();
+    parseSEC_SIG(message, health);
+    CHECK(health.bands[0].jammingState == JammingState::CRITICAL);
+    CHECK(health.spoofingState == SpoofingState::NONE);
+
+    payload[1] = 0x1 | (1 << 1) | 0x8 | (2 << 4); // jamming OK, spoofing indicated
+    buildUBXPacket(message, sizeof(message), UBX_CLASS_SEC, UBX_SEC_SIG, payload.data(), payload.size());
+    health = makeHealth();
+    parseSEC_SIG(message, health);
+    CHECK(health.bands[0].jammingState == JammingState::OK);
+    CHECK(health.spoofingState == SpoofingState::INDICATED);
+}
+
+void testHealthFromStream()
+{
+    FakeGPS gps;
+    std::vector<uint8_t> payload(4, 0);
+    payload[0] = 2;
+    payload[1] = 0x1 | (2 << 1);
+    gps.health.numBands = 1;
+    gps.queueUBX(UBX_CLASS_SEC, UBX_SEC_SIG, payload);
+    gps.update(0us);
+    CHECK(gps.health.bands[0].jammingState == JammingState::WARNING);
+}
+}
+
+int main()
+{
+    testSEC_SIGVersion1();
+    testSEC_SIGVersion2();
+    testHealthFromStream();
+    return testResult();
+}
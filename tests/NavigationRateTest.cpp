@@ -0,0 +1,109 @@
+/*
+ * Tests for setNavigationRate() and its bus bandwidth budget.
+ */
+
+#include "FakeGPS.h"
+#include "TestHelpers.h"
+
+using namespace UBlox;
+
+namespace
+{
+using RatePolicy = UBloxGPS::RatePolicy;
+
+/// Last rate sent for a message, or 0 if none was
+uint8_t lastRate(const FakeGPS& gps, uint8_t messageClass, uint8_t messageID)
+{
+    uint8_t rate = 0;
+    for (const auto& command : gps.rateCommands)
+    {
+        if (command[0] == messageClass && command[1] == messageID)
+        {
+            rate = command[2];
+        }
+    }
+    return rate;
+}
+
+/// Layers written by each CFG-VALSET sent, from the start of \c sent
+std::vector<uint8_t> valsetLayers(const FakeZEDF9P& gps, size_t start = 0)
+{
+    std::vector<uint8_t> layers;
+    for (size_t i = start; i + UBX_HEADER_FOOTER_LENGTH < gps.sent.size(); i++)
+    {
+        if (gps.sent[i] == UBX_SYNC_CHAR_1 && gps.sent[i + 1] == UBX_SYNC_CHAR_2
+            && gps.sent[i + 2] == UBX_CLASS_CFG && gps.sent[i + 3] == UBX_CFG_VALSET)
+        {
+            layers.push_back(gps.sent[i + UBX_DATA_OFFSET + 1]);
+        }
+    }
+    return layers;
+}
+
+void testScaleFromBaseRates()
+{
+    // NAV-PVT is 100 bytes and NAV-SAT 400 bytes per epoch, and half of the bus is budgeted
+    FakeGPS gps;
+    gps.busBandwidth = 4000;
+    CHECK(gps.setMessageRate(UBX_CLASS_NAV, UBX_NAV_PVT, 1));
+    CHECK(gps.setMessageRate(UBX_CLASS_NAV, UBX_NAV_SAT, 1));
+    CHECK(gps.getRequiredBandwidth() == 500);
+
+    CHECK(!gps.setNavigationRate(5, RatePolicy::REFUSE));
+    CHECK(gps.getNavigationRate() == 1);
+
+    CHECK(gps.setNavigationRate(5, RatePolicy::SCALE));
+    CHECK(lastRate(gps, UBX_CLASS_NAV, UBX_NAV_SAT) == 2);
+    CHECK(lastRate(gps, UBX_CLASS_NAV, UBX_NAV_PVT) == 1);
+    CHECK(gps.getRequiredBandwidth() == 1500);
+
+    // Scaled from the base rate of 1, not from the 2 set above
+    CHECK(gps.setNavigationRate(10, RatePolicy::SCALE));
+    CHECK(lastRate(gps, UBX_CLASS_NAV, UBX_NAV_SAT) == 4);
+    CHECK(gps.getRequiredBandwidth() == 2000);
+
+    // Back to the base rate once it fits again
+    CHECK(gps.setNavigationRate(1, RatePolicy::SCALE));
+    CHECK(lastRate(gps, UBX_CLASS_NAV, UBX_NAV_SAT) == 1);
+    CHECK(gps.getRequiredBandwidth() == 500);
+}
+
+void testSetRateWhileScaled()
+{
+    FakeGPS gps;
+    gps.busBandwidth = 4000;
+    CHECK(gps.setMessageRate(UBX_CLASS_NAV, UBX_NAV_PVT, 1));
+    CHECK(gps.setMessageRate(UBX_CLASS_NAV, UBX_NAV_SAT, 1));
+    CHECK(gps.setNavigationRate(5, RatePolicy::SCALE));
+
+    // A rate set by the application becomes the new base rate
+    CHECK(gps.setMessageRate(UBX_CLASS_NAV, UBX_NAV_SAT, 3));
+    CHECK(gps.setNavigationRate(10, RatePolicy::SCALE));
+    CHECK(lastRate(gps, UBX_CLASS_NAV, UBX_NAV_SAT) == 6);
+}
+}
+
+void testGen9WritesRAMOnly()
+{
+    // Rates set by the user are saved, but setNavigationRate() shouldn't write flash every call
+    FakeZEDF9P gps;
+    gps.busBandwidth = 4000;
+    CHECK(gps.setMessageRate(UBX_CLASS_NAV, UBX_NAV_PVT, 1));
+    CHECK(gps.setMessageRate(UBX_CLASS_NAV, UBX_NAV_SAT, 1));
+    CHECK((valsetLayers(gps) == std::vector<uint8_t>{ 0x7, 0x7 }));
+
+    const size_t start = gps.sent.size();
+    CHECK(gps.setNavigationRate(10, RatePolicy::SCALE));
+    CHECK(gps.setNavigationRate(1, RatePolicy::SCALE));
+
+    // Period and NAV-SAT for each rate
+    CHECK((valsetLayers(gps, start) == std::vector<uint8_t>(6, 0x1)));
+}
+
+int main()
+{
+    testScaleFromBaseRates();
+    testSetRateWhileScaled();
+    testGen9WritesRAMOnly();
+    return testResult();
+}
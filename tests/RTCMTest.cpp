@@ -0,0 +1,236 @@
+/*
+ * Tests for RTCM3 framing, correction injection, and forwarding of RTCM3 output.
+ */
+
+#include "FakeGPS.h"
+#include "TestHelpers.h"
+#include "UBloxMovingBase.h"
+#include "UBloxRTCM.h"
+
+using namespace UBlox;
+
+namespace
+{
+/**
+ * @brief Make a valid RTCM3 frame with the given payload length and message number.
+ */
+std::vector<uint8_t> makeRTCMFrame(size_t payloadLen, uint16_t messageNumber = 1005)
+{
+    std::vector<uint8_t> frame(RTCM3_HEADER_LENGTH + payloadLen + RTCM3_CRC_LENGTH);
+    frame[0] = RTCM3_PREAMBLE;
+    frame[1] = payloadLen >> 8;
+    frame[2] = payloadLen & 0xFF;
+    frame[3] = messageNumber >> 4;
+    frame[4] = (messageNumber & 0xF) << 4;
+    for (size_t i = 5; i < RTCM3_HEADER_LENGTH + payloadLen; i++)
+    {
+        frame[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    const uint32_t crc = calcCRC24Q(frame.data(), RTCM3_HEADER_LENGTH + payloadLen);
+    frame[RTCM3_HEADER_LENGTH + payloadLen] = crc >> 16;
+    frame[RTCM3_HEADER_LENGTH + payloadLen + 1] = crc >> 8;
+    frame[RTCM3_HEADER_LENGTH + payloadLen + 2] = crc;
+    return frame;
+}
+
+void testCRC()
+{
+    // Standard check value of CRC-24Q
+    const char* checkString = "123456789";
+    CHECK(calcCRC24Q(reinterpret_cast<const uint8_t*>(checkString), 9) == 0xCDE703);
+
+    std::vector<uint8_t> frame = makeRTCMFrame(19, 1077);
+    CHECK(getRTCMFrameLength(frame.data()) == frame.size());
+    CHECK(isValidRTCMFrame(frame.data(), frame.size()));
+    CHECK(getRTCMMessageNumber(frame.data()) == 1077);
+    CHECK(!isValidRTCMFrame(frame.data(), frame.size() - 1));
+
+    frame[8] ^= 1;
+    CHECK(!isValidRTCMFrame(frame.data(), frame.size()));
+}
+
+void testInjection()
+{
+    FakeGPS gps;
+    std::vector<uint8_t> expected;
+    for (size_t payloadLen : { 19, 1000, 130, 63 })
+    {
+        std::vector<uint8_t> frame = makeRTCMFrame(payloadLen);
+        CHECK(gps.injectRTCMFrame(frame.data(), frame.size()));
+        expected.insert(expected.end(), frame.begin(), frame.end());
+    }
+
+    std::vector<uint8_t> badFrame = makeRTCMFrame(10);
+    badFrame[8] ^= 1;
+    CHECK(!gps.injectRTCMFrame(badFrame.data(), badFrame.size()));
+
+    // Does not fit in what is left of the queue
+    std::vector<uint8_t> bigFrame = makeRTCMFrame(1000);
+    CHECK(!gps.injectRTCMFrame(bigFrame.data(), bigFrame.size()));
+    CHECK(gps.getRTCMQueueSize() == expected.size());
+
+    gps.update(0us);
+    CHECK(gps.getRTCMQueueSize() == 0);
+    CHECK(gps.sent == expected);
+    for (size_t writeLen : gps.writeLengths)
+    {
+        // A one-byte write would set the I2C register address instead
+        CHECK(writeLen > 1);
+    }
+
+    const DriverStatistics stats = gps.getStatistics();
+    CHECK(stats.rtcmBytesInjected == expected.size());
+    CHECK(stats.rtcmFramesInvalid == 1);
+    CHECK(stats.rtcmBytesDropped == badFrame.size() + bigFrame.size());
+
+    gps.resetStatistics();
+    CHECK(gps.getStatistics().rtcmFramesInvalid == 0);
+    CHECK(gps.getStatistics().rtcmBytesDropped == 0);
+}
+
+void testWholeFrames()
+{
+    // Frames are never split by a command sent between two flushes
+    FakeGPS gps;
+    const std::vector<uint8_t> frame1 = makeRTCMFrame(19);
+    const std::vector<uint8_t> frame2 = makeRTCMFrame(500);
+    const std::vector<uint8_t> frame3 = makeRTCMFrame(60);
+    CHECK(gps.injectRTCMFrame(frame1.data(), frame1.size()));
+    CHECK(gps.injectRTCMFrame(frame2.data(), frame2.size()));
+    CHECK(gps.injectRTCMFrame(frame3.data(), frame3.size()));
+
+    // Room for the first frame and part of the second
+    gps.updateWithBudget(frame1.size() + 100);
+    CHECK(gps.sent == frame1);
+    CHECK(gps.getRTCMQueueSize() == frame2.size() + frame3.size());
+
+    const uint8_t data[4] = { 1, 2, 3, 4 };
+    CHECK(gps.sendCommand(UBX_CLASS_CFG, UBX_CFG_VALSET, data, 4, false, false, 0us));
+    uint8_t command[16];
+    const size_t commandLen = buildUBXPacket(command, sizeof(command), UBX_CLASS_CFG, UBX_CFG_VALSET, data, 4);
+
+    gps.update(0us);
+    std::vector<uint8_t> expected = frame1;
+    expected.insert(expected.end(), command, command + commandLen);
+    expected.insert(expected.end(), frame2.begin(), frame2.end());
+    expected.insert(expected.end(), frame3.begin(), frame3.end());
+    CHECK(gps.sent == expected);
+    CHECK(gps.getRTCMQueueSize() == 0);
+    CHECK(gps.getStatistics().rtcmBytesInjected == frame1.size() + frame2.size() + frame3.size());
+}
+
+void testBudgetSmallerThanFrame()
+{
+    FakeGPS gps;
+    const std::vector<uint8_t> frame = makeRTCMFrame(300);
+    CHECK(gps.injectRTCMFrame(frame.data(), frame.size()));
+
+    // Never sent in part, even when the budget is smaller than the frame
+    for (int i = 0; i < 3; i++)
+    {
+        gps.updateWithBudget(frame.size() - 1);
+        CHECK(gps.sent.empty());
+        CHECK(gps.getRTCMQueueSize() == frame.size());
+    }
+
+    gps.updateWithBudget(frame.size());
+    CHECK(gps.sent == frame);
+    CHECK(gps.getRTCMQueueSize() == 0);
+}
+
+void testOutput()
+{
+    FakeGPS gps;
+    std::vector<std::vector<uint8_t>> received;
+    gps.attachRTCMOutput([&received](const uint8_t* frame, size_t len) {
+        received.emplace_back(frame, frame + len);
+    });
+
+    const std::vector<uint8_t> frame1 = makeRTCMFrame(40, 1230);
+    std::vector<uint8_t> badFrame = makeRTCMFrame(20);
+    badFrame[10] ^= 0x80;
+    const std::vector<uint8_t> frame2 = makeRTCMFrame(200, 4072);
+    const std::vector<uint8_t> longFrame = makeRTCMFrame(UBLOX_GNSS_RX_BUFFER_SIZE, 1077);
+
+    gps.queueBytes(frame1.data(), frame1.size());
+    gps.queueUBX(UBX_CLASS_MON, UBX_MON_VER, std::vector<uint8_t>(40, 'v'));
+    gps.queueBytes(badFrame.data(), badFrame.size());
+    gps.queueBytes(longFrame.data(), longFrame.size());
+    gps.queueBytes(frame2.data(), frame2.size());
+    while (gps.update(0us) > 0 || gps.bytesReceived() < gps.incoming.size())
+    {
+    }
+
+    CHECK(received.size() == 2);
+    if (received.size() == 2)
+    {
+        CHECK(received[0] == frame1);
+        CHECK(received[1] == frame2);
+    }
+
+    const DriverStatistics& stats = gps.getStatistics();
+    CHECK(stats.rtcmFramesReceived == 2);
+    CHECK(stats.checksumFailures == 1);
+    CHECK(stats.rtcmFramesTooLong == 1);
+    CHECK(stats.getFrameCount(UBX_CLASS_MON, UBX_MON_VER) == 1);
+}
+
+void testNoSendFromOutputCallback()
+{
+    // The callback may run part way through a transfer, so sends from it are refused
+    FakeGPS gps;
+    const uint8_t data[4] = { 1, 2, 3, 4 };
+    int calls = 0;
+    gps.attachRTCMOutput([&](const uint8_t*, size_t) {
+        calls++;
+        CHECK(!gps.sendCommand(UBX_CLASS_CFG, UBX_CFG_VALSET, data, 4, false, false, 0us));
+    });
+
+    const std::vector<uint8_t> frame = makeRTCMFrame(40, 1230);
+    gps.queueBytes(frame.data(), frame.size());
+    CHECK(gps.update(0us) == 1);
+    CHECK(calls == 1);
+    CHECK(gps.sent.empty());
+
+    // Fine again once update() has returned
+    CHECK(gps.sendCommand(UBX_CLASS_CFG, UBX_CFG_VALSET, data, 4, false, false, 0us));
+    CHECK(!gps.sent.empty());
+}
+
+void testMovingBaseEpoch()
+{
+    // One epoch of moving base output reaches the rover in a single update()
+    FakeZEDF9P base;
+    FakeZEDF9P rover;
+    MovingBaseLink link(base, rover);
+    link.start();
+
+    std::vector<uint8_t> expected;
+    for (uint16_t messageNumber : { 4072, 1074, 1084, 1094, 1124, 1230 })
+    {
+        const size_t payloadLen = messageNumber == 4072 ? 60 : 150;
+        const std::vector<uint8_t> frame = makeRTCMFrame(payloadLen, messageNumber);
+        base.incoming.insert(base.incoming.end(), frame.begin(), frame.end());
+        expected.insert(expected.end(), frame.begin(), frame.end());
+    }
+
+    CHECK(link.update() == 6);
+    CHECK(link.getForwardedFrames() == 6);
+    CHECK(link.getDroppedFrames() == 0);
+    CHECK(rover.sent == expected);
+    CHECK(rover.getRTCMQueueSize() == 0);
+}
+}
+
+int main()
+{
+    testCRC();
+    testInjection();
+    testWholeFrames();
+    testBudgetSmallerThanFrame();
+    testOutput();
+    testNoSendFromOutputCallback();
+    testMovingBaseEpoch();
+    return testResult();
+}
@@ -0,0 +1,68 @@
+/*
+ * Tests for the UART transport, reading from the stub BufferedSerial.
+ */
+
+#include "FakeGPS.h"
+#include "ZEDF9P.h"
+#include "TestHelpers.h"
+
+using namespace UBlox;
+
+namespace
+{
+void queueSerial(const char* text)
+{
+    mbed::g_serialRxData.insert(mbed::g_serialRxData.end(), text, text + strlen(text));
+}
+
+void queueSerialUBX(uint8_t messageClass, uint8_t messageID, size_t payloadLen)
+{
+    const std::vector<uint8_t> payload(payloadLen, 'v');
+    uint8_t packet[UBLOX_GNSS_RX_BUFFER_SIZE];
+    const size_t len
+        = buildUBXPacket(packet, sizeof(packet), messageClass, messageID, payload.data(), payload.size());
+    mbed::g_serialRxData.insert(mbed::g_serialRxData.end(), packet, packet + len);
+}
+
+void testNMEAInBlocks()
+{
+    ZEDF9PSerial gps(NC, NC, NC);
+
+    queueSerial("$GNGGA,002153.000,3342.6618,N,11751.3858,W,1,10,1.2,27.0,M,-34.2,M,,0000*5E\r\n");
+    queueSerialUBX(UBX_CLASS_MON, UBX_MON_VER, 40);
+    queueSerial("$GNRMC,002153.000,A,3342.6618,N,11751.3858,W,0.0,0.0,060817,,,A*6A\r\n");
+    queueSerial("$GNVTG,0.0,T,,M,0.0,N,0.0,K,A*23\r\n");
+    queueSerialUBX(UBX_CLASS_MON, UBX_MON_VER, 40);
+
+    while (gps.update(0us) > 0)
+    {
+    }
+
+    const DriverStatistics& stats = gps.getStatistics();
+    CHECK(mbed::g_serialRxPosition == mbed::g_serialRxData.size());
+    CHECK(stats.nmeaSentences == 3);
+    CHECK(stats.getFrameCount(UBX_CLASS_MON, UBX_MON_VER) == 2);
+    CHECK(stats.resyncs == 0);
+    CHECK(stats.checksumFailures == 0);
+
+    // Not one read per byte of the sentences
+    CHECK(mbed::g_serialReadCalls < 20);
+}
+
+void testGen9BaudRateInRAM()
+{
+    // A new baud rate is only set in RAM, so a power cycle undoes it and it doesn't wear the flash
+    FakeZEDF9P gps;
+    CHECK(gps.sendBaudRateCommand(115200));
+    CHECK(gps.sent.size() > UBX_DATA_OFFSET + 1);
+    CHECK(gps.sent[UBX_BYTE_CLASS] == UBX_CLASS_CFG && gps.sent[UBX_BYTE_ID] == UBX_CFG_VALSET);
+    CHECK(gps.sent[UBX_DATA_OFFSET + 1] == 0x1);
+}
+}
+
+int main()
+{
+    testNMEAInBlocks();
+    testGen9BaudRateInRAM();
+    return testResult();
+}
@@ -0,0 +1,47 @@
+#ifndef UBLOX_TEST_HELPERS_H
+#define UBLOX_TEST_HELPERS_H
+
+#include <cmath>
+#include <cstdio>
+
+/// Number of failed checks in this test program
+inline int testFailures = 0;
+
+#define CHECK(condition)                                                                    \
+    do                                                                                      \
+    {                                                                                       \
+        if (!(condition))                                                                   \
+        {                                                                                   \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);            \
+            testFailures++;                                                                 \
+        }                                                                                   \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                             \
+    do                                                                                      \
+    {                                                                                       \
+        const double checkActual = (actual);                                                \
+        const double checkExpected = (expected);                                            \
+        if (!(std::fabs(checkActual - checkExpected) <= (tolerance)))                       \
+        {                                                                                   \
+            printf("%s:%d: %s = %.12g, expected %.12g\n", __FILE__, __LINE__, #actual,      \
+                checkActual, checkExpected);                                                \
+            testFailures++;                                                                 \
+        }                                                                                   \
+    } while (0)
+
+/**
+ * @brief Print the result, and return the exit code for main().
+ */
+inline int testResult()
+{
+    if (testFailures > 0)
+    {
+        printf("%d check(s) failed\n", testFailures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
+
+#endif // UBLOX_TEST_HELPERS_H
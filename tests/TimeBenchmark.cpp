@@ -0,0 +1,50 @@
+/*
+ * Host benchmark of the batch time conversions, compared with converting one time at a time.
+ */
+
+#include "BenchmarkHelpers.h"
+#include "UBloxTime.h"
+
+#include <vector>
+
+using namespace UBlox;
+using namespace UBlox::Time;
+
+int main()
+{
+    // A log of 10Hz timestamps, which crosses one midnight
+    constexpr size_t COUNT = 4096;
+    std::vector<int64_t> gpsNs(COUNT);
+    const int64_t start = unixToGPS(utcToUnix(UtcTime{ 2024, 3, 1, 23, 55, 0, 0, {} }));
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        gpsNs[i] = start + static_cast<int64_t>(i) * 100000000LL;
+    }
+    std::vector<int64_t> unixNs(COUNT);
+    std::vector<UtcTime> utc(COUNT);
+
+    benchmark("gpsToUnix, one at a time", COUNT, [&]() {
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            unixNs[i] = gpsToUnix(gpsNs[i]);
+            doNotOptimize(unixNs[i]);
+        }
+    });
+    benchmark("gpsToUnix, batch", COUNT, [&]() {
+        gpsToUnix(gpsNs.data(), unixNs.data(), COUNT, DEFAULT_LEAP_SECONDS);
+        doNotOptimize(unixNs[COUNT - 1]);
+    });
+
+    benchmark("unixToUtc, one at a time", COUNT, [&]() {
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            utc[i] = unixToUtc(unixNs[i]);
+            doNotOptimize(utc[i]);
+        }
+    });
+    benchmark("unixToUtc, batch", COUNT, [&]() {
+        unixToUtc(unixNs.data(), utc.data(), COUNT);
+        doNotOptimize(utc[COUNT - 1]);
+    });
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Tests for the batch time conversions, against the constexpr conversions of single times.
+ */
+
+#include "TestHelpers.h"
+#include "UBloxTime.h"
+
+#include <vector>
+
+using namespace UBlox;
+using namespace UBlox::Time;
+
+namespace
+{
+bool sameUtc(const UtcTime& a, const UtcTime& b)
+{
+    return a.year == b.year && a.month == b.month && a.day == b.day && a.hour == b.hour
+        && a.minute == b.minute && a.second == b.second && a.nanosecond == b.nanosecond;
+}
+
+void testOffsetBatches()
+{
+    std::vector<int64_t> gpsNs;
+    for (int64_t i = 0; i < 37; i++)
+    {
+        gpsNs.push_back(1300000000LL * NS_PER_SECOND + i * 123456789LL - 5 * NS_PER_SECOND);
+    }
+
+    std::vector<int64_t> unixNs(gpsNs.size());
+    gpsToUnix(gpsNs.data(), unixNs.data(), gpsNs.size(), 18);
+    std::vector<int64_t> taiNs(gpsNs.size());
+    gpsToTAI(gpsNs.data(), taiNs.data(), gpsNs.size());
+    for (size_t i = 0; i < gpsNs.size(); i++)
+    {
+        CHECK(unixNs[i] == gpsToUnix(gpsNs[i], 18));
+        CHECK(taiNs[i] == gpsToTAI(gpsNs[i]));
+    }
+
+    // In place
+    std::vector<int64_t> inPlace = gpsNs;
+    gpsToUnix(inPlace.data(), inPlace.data(), inPlace.size(), 17);
+    for (size_t i = 0; i < gpsNs.size(); i++)
+    {
+        CHECK(inPlace[i] == gpsToUnix(gpsNs[i], 17));
+    }
+
+    std::vector<GPSTow> tows;
+    for (int64_t ns : gpsNs)
+    {
+        tows.push_back(gpsToTow(ns));
+    }
+    std::vector<int64_t> towUnixNs(tows.size());
+    gpsToUnix(tows.data(), towUnixNs.data(), tows.size(), 18);
+    for (size_t i = 0; i < tows.size(); i++)
+    {
+        CHECK(towUnixNs[i] == gpsToUnix(tows[i].toNanoseconds(), 18));
+    }
+}
+
+void testUtcBatchAcrossDays()
+{
+    // 10Hz timestamps across midnight at the end of a leap year, then jumps backwards to another
+    // day and to before 1970, which must each redo the calendar math
+    std::vector<int64_t> unixNs;
+    const int64_t newYear = utcToUnix(UtcTime{ 2017, 1, 1, 0, 0, 0, 0, {} });
+    for (int64_t i = -25; i < 25; i++)
+    {
+        unixNs.push_back(newYear + i * 100000000LL + 7);
+    }
+    unixNs.push_back(newYear - 40 * SECONDS_PER_DAY * NS_PER_SECOND);
+    unixNs.push_back(-1);
+    unixNs.push_back(-SECONDS_PER_DAY * NS_PER_SECOND);
+    unixNs.push_back(0);
+
+    std::vector<UtcTime> utc(unixNs.size());
+    unixToUtc(unixNs.data(), utc.data(), unixNs.size());
+    for (size_t i = 0; i < unixNs.size(); i++)
+    {
+        CHECK(sameUtc(utc[i], unixToUtc(unixNs[i])));
+    }
+
+    CHECK(utc[0].year == 2016 && utc[0].month == 12 && utc[0].day == 31);
+    CHECK(utc[0].hour == 23 && utc[0].minute == 59 && utc[0].second == 57);
+    CHECK(utc[25].year == 2017 && utc[25].day == 1 && utc[25].nanosecond == 7);
+    CHECK(utc[51].year == 1969 && utc[51].second == 59 && utc[51].nanosecond == 999999999);
+
+    // Nothing to convert
+    unixToUtc(unixNs.data(), utc.data(), 0);
+}
+}
+
+int main()
+{
+    testOffsetBatches();
+    testUtcBatchAcrossDays();
+    return testResult();
+}
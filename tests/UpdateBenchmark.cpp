@@ -0,0 +1,72 @@
+/*
+ * Host benchmark of the cost of reading and processing each frame in update(), called on a
+ * concrete receiver (a direct call to the transport's readMessage(), see UBloxReceiver) and
+ * through a UBloxGPS reference (a call through the vtable).
+ *
+ * The frames come from the stub BufferedSerial, so this measures the driver's own work per frame
+ * and not the bus.
+ */
+
+#include "BenchmarkHelpers.h"
+#include "ZEDF9P.h"
+
+#include <vector>
+
+using namespace UBlox;
+
+namespace
+{
+constexpr size_t FRAMES = 256;
+
+/**
+ * @brief Queue one epoch's worth of frames per NAV-PVT: a NAV-PVT followed by a NAV-TIMEUTC.
+ */
+void queueFrames()
+{
+    mbed::g_serialRxData.clear();
+    for (size_t i = 0; i < FRAMES / 2; i++)
+    {
+        for (const auto& [messageID, payloadLen] :
+            { std::pair<uint8_t, size_t>{ UBX_NAV_PVT, 92 }, { UBX_NAV_TIMEUTC, 20 } })
+        {
+            const std::vector<uint8_t> payload(payloadLen, static_cast<uint8_t>(i));
+            uint8_t packet[UBLOX_GNSS_RX_BUFFER_SIZE];
+            const size_t len = buildUBXPacket(
+                packet, sizeof(packet), UBX_CLASS_NAV, messageID, payload.data(), payload.size());
+            mbed::g_serialRxData.insert(mbed::g_serialRxData.end(), packet, packet + len);
+        }
+    }
+}
+
+/**
+ * @brief Read every queued frame with update() on \c gps.
+ */
+template <typename Receiver> void readAll(Receiver& gps)
+{
+    mbed::g_serialRxPosition = 0;
+    int frames = 0;
+    int read;
+    while ((read = gps.update(0us)) > 0)
+    {
+        frames += read;
+    }
+    doNotOptimize(frames);
+}
+}
+
+int main()
+{
+    queueFrames();
+    ZEDF9PSerial gps(NC, NC, NC);
+    UBloxGPS& base = gps;
+
+    benchmark("update() on ZEDF9PSerial (direct)", FRAMES, [&]() { readAll(gps); });
+    benchmark("update() through UBloxGPS& (virtual)", FRAMES, [&]() { readAll(base); });
+
+    if (gps.getStatistics().getFrameCount(UBX_CLASS_NAV, UBX_NAV_PVT) == 0)
+    {
+        printf("No frames were read!\n");
+        return 1;
+    }
+    return 0;
+}
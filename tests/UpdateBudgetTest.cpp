@@ -0,0 +1,67 @@
+/*
+ * Tests for updateWithBudget().
+ */
+
+#include "FakeGPS.h"
+#include "TestHelpers.h"
+
+using namespace UBlox;
+
+namespace
+{
+/// Each message is 48 bytes long
+void queueMessages(FakeGPS& gps, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        gps.queueUBX(UBX_CLASS_MON, UBX_MON_VER, std::vector<uint8_t>(40, 'v'));
+    }
+}
+
+void testByteBudget()
+{
+    FakeGPS gps;
+    queueMessages(gps, 3);
+
+    int messages = 0;
+    for (int call = 0; call < 10; call++)
+    {
+        const size_t before = gps.bytesReceived();
+        messages += gps.updateWithBudget(30);
+        CHECK(gps.bytesReceived() - before <= 30);
+    }
+    CHECK(messages == 3);
+    CHECK(gps.getStatistics().framesReceived == 3);
+
+    // A frame left part way through is finished by update()
+    queueMessages(gps, 1);
+    gps.updateWithBudget(20);
+    CHECK(gps.bytesReceived() < gps.incoming.size());
+    CHECK(gps.update(0us) == 1);
+    CHECK(gps.getStatistics().framesReceived == 4);
+}
+
+void testTimeBudget()
+{
+    // 10 bytes per ms
+    FakeGPS gps;
+    gps.busBandwidth = 10000;
+    queueMessages(gps, 2);
+
+    int messages = 0;
+    for (int call = 0; call < 10; call++)
+    {
+        const size_t before = gps.bytesReceived();
+        messages += gps.updateWithBudget(SIZE_MAX, 3ms);
+        CHECK(gps.bytesReceived() - before <= 30);
+    }
+    CHECK(messages == 2);
+}
+}
+
+int main()
+{
+    testByteBudget();
+    testTimeBudget();
+    return testResult();
+}
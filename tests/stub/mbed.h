@@ -0,0 +1,222 @@
+// Minimal stand-in for the parts of mbed.h used by the driver, so that the host tests can build
+// without Mbed OS.  Buses do nothing, and time comes from mbed::g_fakeTimeUs, which tests advance
+// by hand.
+#pragma once
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <sys/types.h>
+#include <utility>
+#include <new>
+#include <algorithm>
+#include <vector>
+#include <cerrno>
+#include <atomic>
+#include <cinttypes>
+
+using namespace std::chrono_literals;
+
+typedef int PinName;
+static constexpr PinName NC = -1;
+enum PinMode { PullNone, PullUp, PullDown };
+
+#define MBED_ALIGN(x) alignas(x)
+#define MBED_FORCEINLINE inline __attribute__((always_inline))
+#define CORE_UTIL_CRITICAL_SECTION
+
+namespace mbed {
+
+/// Current time of HighResClock and Timer (us)
+inline int64_t g_fakeTimeUs = 0;
+
+struct HighResClock
+{
+    using duration = std::chrono::microseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<HighResClock>;
+    static constexpr bool is_steady = true;
+    static time_point now() { return time_point(duration(g_fakeTimeUs)); }
+    static void lock() {}
+    static void unlock() {}
+};
+
+class DigitalOut
+{
+public:
+    DigitalOut(PinName, int = 0) {}
+    DigitalOut& operator=(int) { return *this; }
+    operator int() { return 0; }
+    void write(int) {}
+    int read() { return 0; }
+};
+
+class DigitalIn
+{
+public:
+    DigitalIn(PinName, PinMode = PullNone) {}
+    int read() { return 0; }
+    operator int() { return 0; }
+    int is_connected() { return 1; }
+};
+
+template <typename F> class Callback;
+template <typename R, typename... Args> class Callback<R(Args...)>
+{
+public:
+    Callback() = default;
+    Callback(std::nullptr_t) {}
+    Callback(R (*f)(Args...)) : f_(f) {}
+    template <typename T> Callback(T* obj, R (T::*method)(Args...)) : f_([obj, method](Args... a) { return (obj->*method)(a...); }) {}
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, Callback>::value>> Callback(F f) : f_(f) {}
+    R operator()(Args... a) const { return f_(a...); }
+    R call(Args... a) const { return f_(a...); }
+    explicit operator bool() const { return static_cast<bool>(f_); }
+private:
+    std::function<R(Args...)> f_;
+};
+template <typename T, typename R, typename... A> Callback<R(A...)> callback(T* obj, R (T::*m)(A...)) { return Callback<R(A...)>(obj, m); }
+
+class InterruptIn
+{
+public:
+    InterruptIn(PinName) {}
+    InterruptIn(PinName, PinMode) {}
+    void rise(Callback<void()>) {}
+    void fall(Callback<void()>) {}
+    void enable_irq() {}
+    void disable_irq() {}
+    int read() { return 0; }
+};
+
+class Timer
+{
+public:
+    void start() { running_ = true; startUs_ = g_fakeTimeUs; }
+    void stop() { if (running_) acc_ += g_fakeTimeUs - startUs_; running_ = false; }
+    void reset() { acc_ = 0; startUs_ = g_fakeTimeUs; }
+    std::chrono::microseconds elapsed_time() const { return std::chrono::microseconds(acc_ + (running_ ? g_fakeTimeUs - startUs_ : 0)); }
+    bool running_ = false; int64_t startUs_ = 0, acc_ = 0;
+};
+
+class I2C
+{
+public:
+    enum Result { ACK = 0, NACK, TIMEOUT, OTHER_ERROR };
+    I2C(PinName, PinName) {}
+    void frequency(int) {}
+    Result read(int address, char* data, int length, bool repeated = false) { return ACK; }
+    int read(int ack) { return 0; }
+    Result write(int address, const char* data, int length, bool repeated = false) { return ACK; }
+    int write(int data) { return 0; }
+    void start() {}
+    void stop() {}
+    void lock() {}
+    void unlock() {}
+};
+
+enum use_gpio_ssel_t { use_gpio_ssel };
+
+class SPI
+{
+public:
+    SPI(PinName, PinName, PinName, PinName, use_gpio_ssel_t) {}
+    void format(int, int = 0) {}
+    void frequency(int = 1000000) {}
+    int write(int value) { return 0; }
+    int write(const char* tx, int txLen, char* rx, int rxLen) { return 0; }
+    template <typename W> int write(const W* tx, int txLen, W* rx, int rxLen) { return 0; }
+    void lock() {}
+    void unlock() {}
+    void select() {}
+    void deselect() {}
+    void set_default_write_value(char) {}
+};
+
+class FileHandle
+{
+public:
+    virtual ~FileHandle() = default;
+    virtual ssize_t read(void* buffer, size_t size) = 0;
+    virtual ssize_t write(const void* buffer, size_t size) = 0;
+    virtual int set_blocking(bool) { return 0; }
+    virtual short poll(short events) const { return 0; }
+    virtual bool readable() const { return true; }
+    virtual bool writable() const { return true; }
+    virtual ssize_t sync() { return 0; }
+};
+
+/// Bytes which BufferedSerial::read() returns, and the number of read() calls made
+inline std::vector<uint8_t> g_serialRxData;
+inline size_t g_serialRxPosition = 0;
+inline size_t g_serialReadCalls = 0;
+
+class BufferedSerial : public FileHandle
+{
+public:
+    BufferedSerial(PinName, PinName, int = 9600) {}
+    ssize_t read(void* buffer, size_t size) override
+    {
+        g_serialReadCalls++;
+        const size_t len = std::min(size, g_serialRxData.size() - g_serialRxPosition);
+        memcpy(buffer, g_serialRxData.data() + g_serialRxPosition, len);
+        g_serialRxPosition += len;
+        return len > 0 ? static_cast<ssize_t>(len) : -EAGAIN;
+    }
+    ssize_t write(const void*, size_t) override { return 0; }
+    void set_baud(int) {}
+};
+
+struct pollfh
+{
+    FileHandle* fh;
+    short events;
+    short revents;
+};
+inline int poll(pollfh fhs[], unsigned nfhs, int timeout) { return 0; }
+
+template <typename T, uint32_t BufferSize, typename CounterType = uint32_t> class CircularBuffer
+{
+    T buf_[BufferSize]; CounterType head_ = 0, tail_ = 0, n_ = 0;
+public:
+    void push(const T& v) { buf_[head_] = v; head_ = (head_ + 1) % BufferSize; if (n_ == BufferSize) tail_ = (tail_ + 1) % BufferSize; else n_++; }
+    void push(const T* v, CounterType len) { for (CounterType i = 0; i < len; i++) push(v[i]); }
+    bool pop(T& v) { if (!n_) return false; v = buf_[tail_]; tail_ = (tail_ + 1) % BufferSize; n_--; return true; }
+    CounterType pop(T* v, CounterType len) { CounterType i = 0; while (i < len && pop(v[i])) i++; return i; }
+    bool peek(T& v) const { if (!n_) return false; v = buf_[tail_]; return true; }
+    bool empty() const { return n_ == 0; }
+    bool full() const { return n_ == BufferSize; }
+    CounterType size() const { return n_; }
+    void reset() { head_ = tail_ = n_ = 0; }
+};
+
+class Mutex
+{
+public:
+    void lock() {}
+    void unlock() {}
+    bool trylock() { return true; }
+};
+
+}
+
+namespace rtos {
+namespace ThisThread {
+inline void sleep_for(std::chrono::milliseconds) {}
+}
+class Mutex : public mbed::Mutex {};
+namespace Kernel { struct Clock { using time_point = std::chrono::time_point<Clock, std::chrono::milliseconds>; static time_point now() { return {}; } }; }
+}
+
+#define POLLIN 0x0001
+#define POLLOUT 0x0010
+
+using namespace mbed;
+using namespace rtos;
+
+inline uint32_t us_ticker_read() { return 0; }
+inline void core_util_critical_section_enter() {}
+inline void core_util_critical_section_exit() {}
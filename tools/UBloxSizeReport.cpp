@@ -0,0 +1,46 @@
+/*
+ * Compiled by the ublox-gnss-size target to report the RAM used by each driver instance with the
+ * current footprint options (see UBloxGPSConstants.h).
+ *
+ * Each symbol below is an array whose size is that of a driver class, so listing the symbol sizes
+ * of this object file (nm --print-size) gives the per-instance cost without running anything on
+ * the target.
+ *
+ * The update_* functions compare the code generated for UBloxReceiver::update(), which calls the
+ * transport's readMessage() directly, with that of UBloxGPS::update(), which calls it through
+ * the vtable.  update_*_virtual is just a call to UBloxGPS::update() in the library, which all
+ * receivers share, while update_*_direct is a copy of the polling loop for that receiver type.
+ */
+
+#include "MAX8.h"
+#include "ZEDF9P.h"
+#include "UBloxExtrapolator.h"
+#include "UBloxPPSClock.h"
+
+using namespace UBlox;
+
+extern const char sizeof_MAX8I2C[sizeof(MAX8I2C)];
+extern const char sizeof_ZEDF9PI2C[sizeof(ZEDF9PI2C)];
+extern const char sizeof_ZEDF9PSPI[sizeof(ZEDF9PSPI)];
+extern const char sizeof_ZEDF9PSerial[sizeof(ZEDF9PSerial)];
+extern const char sizeof_DriverStatistics[sizeof(DriverStatistics)];
+extern const char sizeof_PPSClock[sizeof(PPSClock)];
+extern const char sizeof_PositionExtrapolator[sizeof(PositionExtrapolator)];
+
+const char sizeof_MAX8I2C[sizeof(MAX8I2C)] = {};
+const char sizeof_ZEDF9PI2C[sizeof(ZEDF9PI2C)] = {};
+const char sizeof_ZEDF9PSPI[sizeof(ZEDF9PSPI)] = {};
+const char sizeof_ZEDF9PSerial[sizeof(ZEDF9PSerial)] = {};
+const char sizeof_DriverStatistics[sizeof(DriverStatistics)] = {};
+const char sizeof_PPSClock[sizeof(PPSClock)] = {};
+const char sizeof_PositionExtrapolator[sizeof(PositionExtrapolator)] = {};
+
+extern "C" int update_ZEDF9PI2C_direct(ZEDF9PI2C& gps)
+{
+    return gps.update(0us);
+}
+
+extern "C" int update_ZEDF9PI2C_virtual(UBloxGPS& gps)
+{
+    return gps.update(0us);
+}